@@ -0,0 +1,136 @@
+// Times the Black-Scholes batch kernels against a per-option loop over the
+// scalar erfc formulation with a call/put branch, which is what the batch
+// entry points ran before they were made branch-free. Build with
+// -DCRUCIBLE_BUILD_BENCHMARKS=ON and an optimizing build type.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "quant/black_scholes.hpp"
+
+namespace {
+
+constexpr std::size_t kOptions = 1U << 16;
+constexpr int kRounds = 50;
+
+double reference_cdf(double x) {
+  return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+void reference_price_batch(const quant::OptionColumns& options, double* prices) {
+  for (std::size_t i = 0; i < options.size; ++i) {
+    const double S = std::max(options.spot[i], 1e-9);
+    const double K = std::max(options.strike[i], 1e-9);
+    const double sigma = std::max(options.volatility[i], 1e-9);
+    const double T = std::max(options.time_to_maturity[i], 1e-9);
+    const double r = options.rate[i];
+    const double q = options.dividend_yield == nullptr ? 0.0 : options.dividend_yield[i];
+    const double sigmaSqT = sigma * std::sqrt(T);
+    const double discounted_spot = S * std::exp(-q * T);
+    const double discount = std::exp(-r * T);
+    const double d1 = (std::log(S / K) + (r - q + 0.5 * sigma * sigma) * T) / sigmaSqT;
+    const double d2 = d1 - sigmaSqT;
+    prices[i] = options.is_call[i] ? discounted_spot * reference_cdf(d1) - K * discount * reference_cdf(d2)
+                                   : K * discount * reference_cdf(-d2) - discounted_spot * reference_cdf(-d1);
+  }
+}
+
+// Best of kRounds, in nanoseconds per option.
+template <typename Kernel>
+double time_per_option(Kernel&& kernel) {
+  double best = 0.0;
+  for (int round = 0; round < kRounds; ++round) {
+    const auto start = std::chrono::steady_clock::now();
+    kernel();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    best = round == 0 ? elapsed.count() : std::min(best, elapsed.count());
+  }
+  return best / static_cast<double>(kOptions);
+}
+
+void report(const char* label, double nanoseconds, double baseline) {
+  std::cout << std::left << std::setw(28) << label << std::right << std::fixed << std::setprecision(2)
+            << std::setw(8) << nanoseconds << " ns/option" << std::setw(8) << baseline / nanoseconds << "x\n";
+}
+
+}  // namespace
+
+int main() {
+  std::vector<double> spot(kOptions);
+  std::vector<double> strike(kOptions);
+  std::vector<double> rate(kOptions);
+  std::vector<double> volatility(kOptions);
+  std::vector<double> maturity(kOptions);
+  const auto is_call = std::make_unique<bool[]>(kOptions);
+  for (std::size_t i = 0; i < kOptions; ++i) {
+    spot[i] = 60.0 + static_cast<double>(i % 81);
+    strike[i] = 100.0;
+    rate[i] = 0.01 + 0.001 * static_cast<double>(i % 7);
+    volatility[i] = 0.05 + 0.01 * static_cast<double>(i % 50);
+    maturity[i] = 0.05 + 0.05 * static_cast<double>(i % 40);
+    is_call[i] = i % 3 != 0;
+  }
+  const quant::OptionColumns options{
+    .spot = spot.data(),
+    .strike = strike.data(),
+    .rate = rate.data(),
+    .volatility = volatility.data(),
+    .time_to_maturity = maturity.data(),
+    .dividend_yield = nullptr,
+    .is_call = is_call.get(),
+    .size = kOptions,
+  };
+
+  std::vector<double> reference(kOptions);
+  std::vector<double> prices(kOptions);
+  std::vector<double> delta(kOptions);
+  std::vector<double> gamma(kOptions);
+  std::vector<double> vega(kOptions);
+  std::vector<double> theta(kOptions);
+  std::vector<double> rho(kOptions);
+  const quant::GreeksColumns greeks{
+    .price = prices.data(),
+    .delta = delta.data(),
+    .gamma = gamma.data(),
+    .vega = vega.data(),
+    .theta = theta.data(),
+    .rho = rho.data(),
+  };
+
+  const double baseline = time_per_option([&] { reference_price_batch(options, reference.data()); });
+  const double scalar = time_per_option([&] {
+    for (std::size_t i = 0; i < kOptions; ++i) {
+      prices[i] = quant::black_scholes(quant::OptionInput{
+        .spot = spot[i],
+        .strike = strike[i],
+        .rate = rate[i],
+        .volatility = volatility[i],
+        .time_to_maturity = maturity[i],
+        .dividend_yield = 0.0,
+        .is_call = is_call[i],
+      }).price;
+    }
+  });
+  const double greeks_batch = time_per_option([&] { quant::black_scholes_greeks_batch(options, greeks); });
+  const double price_batch = time_per_option([&] { quant::black_scholes_price_batch(options, prices.data()); });
+
+  double worst = 0.0;
+  for (std::size_t i = 0; i < kOptions; ++i) {
+    worst = std::max(worst, std::abs(prices[i] - reference[i]));
+  }
+
+  std::cout << kOptions << " options, best of " << kRounds << " rounds\n";
+  report("erfc loop (reference)", baseline, baseline);
+  report("black_scholes per option", scalar, baseline);
+  report("black_scholes_greeks_batch", greeks_batch, baseline);
+  report("black_scholes_price_batch", price_batch, baseline);
+  std::cout << "max |batch - reference| = " << std::scientific << std::setprecision(2) << worst << '\n';
+  return worst < 1e-10 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
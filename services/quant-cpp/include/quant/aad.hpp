@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace quant::aad {
+
+// Reverse-mode tape. Every node stores at most two (argument, partial) pairs,
+// which covers all operations below. Node storage is kept across rewind(), so
+// after the first path a per-path record/propagate/rewind cycle allocates
+// nothing.
+class Tape {
+ public:
+  static constexpr std::uint32_t kNone = 0xFFFFFFFFU;
+
+  std::uint32_t variable();
+  std::uint32_t record(std::uint32_t a, double da);
+  std::uint32_t record(std::uint32_t a, double da, std::uint32_t b, double db);
+
+  std::size_t size() const { return nodes_.size(); }
+
+  double& adjoint(std::uint32_t index) { return adjoints_[index]; }
+  double adjoint(std::uint32_t index) const { return adjoints_[index]; }
+
+  // Reverse sweep over nodes [mark, size()): pushes their adjoints onto their
+  // arguments, including arguments recorded before `mark`.
+  void propagate(std::size_t mark = 0);
+
+  // Drops nodes from `mark` on (and their adjoints), keeping capacity.
+  void rewind(std::size_t mark);
+
+  void clear();
+
+ private:
+  struct Node {
+    std::uint32_t arg[2];
+    double partial[2];
+  };
+
+  std::vector<Node> nodes_;
+  std::vector<double> adjoints_;
+};
+
+// Tape that Real operations on this thread record to; null disables taping.
+Tape* active_tape();
+
+class TapeScope {
+ public:
+  explicit TapeScope(Tape& tape);
+  ~TapeScope();
+  TapeScope(const TapeScope&) = delete;
+  TapeScope& operator=(const TapeScope&) = delete;
+
+ private:
+  Tape* previous_;
+};
+
+class Real {
+ public:
+  Real() = default;
+  Real(double value) : value_(value) {}  // NOLINT: constants convert implicitly
+
+  // Registers this value as an input on the active tape.
+  static Real input(double value) {
+    Real r(value);
+    if (Tape* tape = active_tape()) {
+      r.index_ = tape->variable();
+    }
+    return r;
+  }
+
+  double value() const { return value_; }
+  std::uint32_t index() const { return index_; }
+  bool active() const { return index_ != Tape::kNone; }
+
+  double adjoint() const { return active() ? active_tape()->adjoint(index_) : 0.0; }
+
+  static Real unary(double value, const Real& a, double da) {
+    Real r(value);
+    if (a.active()) {
+      r.index_ = active_tape()->record(a.index_, da);
+    }
+    return r;
+  }
+
+  static Real binary(double value, const Real& a, double da, const Real& b, double db) {
+    Real r(value);
+    if (a.active() && b.active()) {
+      r.index_ = active_tape()->record(a.index_, da, b.index_, db);
+    } else if (a.active()) {
+      r.index_ = active_tape()->record(a.index_, da);
+    } else if (b.active()) {
+      r.index_ = active_tape()->record(b.index_, db);
+    }
+    return r;
+  }
+
+  Real& operator+=(const Real& rhs) { return *this = binary(value_ + rhs.value_, *this, 1.0, rhs, 1.0); }
+  Real& operator-=(const Real& rhs) { return *this = binary(value_ - rhs.value_, *this, 1.0, rhs, -1.0); }
+  Real& operator*=(const Real& rhs) { return *this = binary(value_ * rhs.value_, *this, rhs.value_, rhs, value_); }
+  Real& operator/=(const Real& rhs) {
+    const double inv = 1.0 / rhs.value_;
+    return *this = binary(value_ * inv, *this, inv, rhs, -value_ * inv * inv);
+  }
+
+ private:
+  double value_ = 0.0;
+  std::uint32_t index_ = Tape::kNone;
+};
+
+inline Real operator-(const Real& a) { return Real::unary(-a.value(), a, -1.0); }
+inline Real operator+(Real a, const Real& b) { return a += b; }
+inline Real operator-(Real a, const Real& b) { return a -= b; }
+inline Real operator*(Real a, const Real& b) { return a *= b; }
+inline Real operator/(Real a, const Real& b) { return a /= b; }
+
+inline bool operator<(const Real& a, const Real& b) { return a.value() < b.value(); }
+inline bool operator>(const Real& a, const Real& b) { return a.value() > b.value(); }
+inline bool operator<=(const Real& a, const Real& b) { return a.value() <= b.value(); }
+inline bool operator>=(const Real& a, const Real& b) { return a.value() >= b.value(); }
+
+inline Real exp(const Real& a) {
+  const double e = std::exp(a.value());
+  return Real::unary(e, a, e);
+}
+
+inline Real log(const Real& a) { return Real::unary(std::log(a.value()), a, 1.0 / a.value()); }
+
+// Taken as flat at 0, where the derivative is unbounded, so a variance that
+// touches zero does not turn every adjoint behind it into NaN.
+inline Real sqrt(const Real& a) {
+  const double s = std::sqrt(a.value());
+  return Real::unary(s, a, s > 0.0 ? 0.5 / s : 0.0);
+}
+
+// Standard normal CDF.
+inline Real normal_cdf(const Real& a) {
+  constexpr double kInvSqrtTwo = 0.70710678118654752440;
+  constexpr double kInvSqrtTwoPi = 0.39894228040143267794;
+  const double x = a.value();
+  return Real::unary(0.5 * std::erfc(-x * kInvSqrtTwo), a, kInvSqrtTwoPi * std::exp(-0.5 * x * x));
+}
+
+// Piecewise selections differentiate along the branch taken.
+inline Real max(const Real& a, const Real& b) { return a.value() >= b.value() ? a : b; }
+inline Real min(const Real& a, const Real& b) { return a.value() <= b.value() ? a : b; }
+
+}  // namespace quant::aad
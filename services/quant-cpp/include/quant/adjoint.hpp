@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "quant/aad.hpp"
+#include "quant/black_scholes.hpp"
+#include "quant/heston.hpp"
+#include "quant/monte_carlo.hpp"
+#include "quant/multi_asset.hpp"
+#include "quant/parallel.hpp"
+#include "quant/path_engine.hpp"
+#include "quant/random.hpp"
+
+namespace quant {
+
+// First-order sensitivities of the price to every OptionInput field, from a
+// single reverse sweep. d_maturity is dV/dT, i.e. theta = -d_maturity.
+struct AdjointGreeks {
+  double price;
+  double standard_error;
+  double d_spot;
+  double d_strike;
+  double d_rate;
+  double d_volatility;
+  double d_maturity;
+  double d_dividend;
+  std::uint64_t paths;
+};
+
+struct MultiAssetAdjointGreeks {
+  double price;
+  double standard_error;
+  std::vector<double> d_spots;
+  std::vector<double> d_volatilities;
+  std::vector<double> d_dividends;
+  // Row-major n x n; entry (i, j) is the sensitivity to moving rho_ij and
+  // rho_ji together. Empty when the matrix is not positive definite.
+  std::vector<double> d_correlation;
+  double d_rate;
+  double d_maturity;
+  std::uint64_t paths;
+};
+
+// Sensitivities of a Heston path price to the option and model inputs.
+struct HestonAdjointGreeks {
+  double price;
+  double standard_error;
+  double d_spot;
+  double d_strike;
+  double d_rate;
+  double d_dividend;
+  double d_initial_variance;
+  double d_mean_reversion;
+  double d_long_run_variance;
+  double d_vol_of_vol;
+  double d_correlation;
+  std::uint64_t paths;
+};
+
+AdjointGreeks black_scholes_adjoint(const OptionInput& option);
+
+// European MC on the same normals as monte_carlo_price(option, paths, seed).
+AdjointGreeks monte_carlo_adjoint(const OptionInput& option, std::uint32_t paths, std::uint32_t seed);
+
+// Correlated multi-asset MC on the same paths as multi_asset_monte_carlo_price,
+// differentiating through the Cholesky factor for correlation sensitivities.
+// Empty on the inputs multi_asset_monte_carlo_price rejects.
+MultiAssetAdjointGreeks multi_asset_adjoint(
+  const MultiAssetInput& input,
+  const MultiAssetPayoff& payoff,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  std::size_t block_paths = kDefaultBlockPaths);
+
+// Path-dependent payoff under GBM. `payoff(path, strike)` receives the spots
+// at every grid date of one path and returns its undiscounted cash flow; it
+// is written once over aad::Real and taped per path. Each block pre-draws its
+// normals in the same order as path_monte_carlo_price, so prices agree for
+// the same seed and block size. d_maturity is not reported (the grid is fixed).
+template <class PayoffFn>
+AdjointGreeks path_monte_carlo_adjoint(
+  const OptionInput& option,
+  const TimeGrid& grid,
+  PayoffFn&& payoff,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  std::size_t block_paths = kDefaultBlockPaths) {
+  using aad::Real;
+  constexpr std::size_t kInputs = 5;  // spot, strike, rate, volatility, dividend
+  if (paths == 0U || grid.steps() == 0U) {
+    return AdjointGreeks{};
+  }
+
+  const std::size_t steps = grid.steps();
+  const std::uint64_t block = std::max<std::size_t>(block_paths, 1U);
+  const std::size_t blocks = static_cast<std::size_t>((paths + block - 1U) / block);
+  const double scale = 1.0 / static_cast<double>(paths);
+  std::vector<RunningStats> block_stats(blocks);
+  std::vector<double> block_adjoints(blocks * kInputs, 0.0);
+
+  parallel_for(blocks, [&](std::size_t b) {
+    const auto size = static_cast<std::size_t>(std::min(block, paths - b * block));
+    RandomStream rng(seed, b);
+    std::vector<double> normals(steps * size);
+    for (std::size_t k = 0; k < steps; ++k) {
+      rng.fill_normals(normals.data() + k * size, size);
+    }
+
+    aad::Tape tape;
+    aad::TapeScope scope(tape);
+    const Real spot = Real::input(option.spot);
+    const Real strike = Real::input(option.strike);
+    const Real rate = Real::input(option.rate);
+    const Real sigma = Real::input(option.volatility);
+    const Real dividend = Real::input(option.dividend_yield);
+    const Real discount = aad::exp(-rate * grid.maturity());
+
+    std::vector<Real> drift(steps);
+    std::vector<Real> diffusion(steps);
+    double previous_time = 0.0;
+    for (std::size_t k = 0; k < steps; ++k) {
+      const double dt = grid.times[k] - previous_time;
+      drift[k] = (rate - dividend - 0.5 * sigma * sigma) * dt;
+      diffusion[k] = sigma * std::sqrt(dt);
+      previous_time = grid.times[k];
+    }
+    const std::size_t mark = tape.size();
+
+    std::vector<Real> path(steps);
+    double payoff_sum = 0.0;
+    for (std::size_t i = 0; i < size; ++i) {
+      Real current = spot;
+      for (std::size_t k = 0; k < steps; ++k) {
+        current = current * aad::exp(drift[k] + diffusion[k] * normals[k * size + i]);
+        path[k] = current;
+      }
+      const Real value = payoff(path, strike);
+      block_stats[b].add(value.value());
+      payoff_sum += value.value();
+      if (value.active()) {
+        tape.adjoint(value.index()) += discount.value() * scale;
+        tape.propagate(mark);
+      }
+      tape.rewind(mark);
+    }
+
+    tape.adjoint(discount.index()) += payoff_sum * scale;
+    tape.propagate();
+    const Real* inputs[kInputs] = {&spot, &strike, &rate, &sigma, &dividend};
+    for (std::size_t j = 0; j < kInputs; ++j) {
+      block_adjoints[b * kInputs + j] = tape.adjoint(inputs[j]->index());
+    }
+  });
+
+  RunningStats stats;
+  double totals[kInputs] = {};
+  for (std::size_t b = 0; b < blocks; ++b) {
+    stats.merge(block_stats[b]);
+    for (std::size_t j = 0; j < kInputs; ++j) {
+      totals[j] += block_adjoints[b * kInputs + j];
+    }
+  }
+  const double discount = std::exp(-option.rate * grid.maturity());
+  return AdjointGreeks{
+    .price = discount * stats.mean,
+    .standard_error = discount * stats.standard_error(),
+    .d_spot = totals[0],
+    .d_strike = totals[1],
+    .d_rate = totals[2],
+    .d_volatility = totals[3],
+    .d_maturity = 0.0,
+    .d_dividend = totals[4],
+    .paths = stats.count,
+  };
+}
+
+// Path-dependent payoff under Heston, on the same QE paths as
+// path_monte_carlo_price with a HestonPathModel for the same seed and block
+// size. `payoff` is as for path_monte_carlo_adjoint. Each path is taped
+// through heston_qe_step and differentiated along the QE branch it takes, so
+// the jump in variance where a step crosses psi = 1.5 between branches is not
+// seen: the model sensitivities are reliable while psi stays mostly below the
+// switch and biased when vol of vol is high enough to cross it often. The
+// option's volatility is unused and d_maturity is not reported.
+template <class PayoffFn>
+HestonAdjointGreeks heston_path_monte_carlo_adjoint(
+  const OptionInput& option,
+  const HestonParameters& heston,
+  const TimeGrid& grid,
+  PayoffFn&& payoff,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  std::size_t block_paths = kDefaultBlockPaths) {
+  using aad::Real;
+  // spot, strike, rate, dividend, v0, kappa, theta, xi, rho
+  constexpr std::size_t kInputs = 9;
+  if (paths == 0U || grid.steps() == 0U) {
+    return HestonAdjointGreeks{};
+  }
+
+  const std::size_t steps = grid.steps();
+  const std::uint64_t block = std::max<std::size_t>(block_paths, 1U);
+  const std::size_t blocks = static_cast<std::size_t>((paths + block - 1U) / block);
+  const double scale = 1.0 / static_cast<double>(paths);
+  std::vector<RunningStats> block_stats(blocks);
+  std::vector<double> block_adjoints(blocks * kInputs, 0.0);
+
+  parallel_for(blocks, [&](std::size_t b) {
+    const auto size = static_cast<std::size_t>(std::min(block, paths - b * block));
+    // Two normals per path and step, variance then spot, as the engine draws.
+    RandomStream rng(seed, b);
+    std::vector<double> normals(steps * 2U * size);
+    for (std::size_t k = 0; k < steps; ++k) {
+      rng.fill_normals(normals.data() + k * 2U * size, 2U * size);
+    }
+
+    aad::Tape tape;
+    aad::TapeScope scope(tape);
+    const Real inputs[kInputs] = {
+      Real::input(option.spot),
+      Real::input(option.strike),
+      Real::input(option.rate),
+      Real::input(option.dividend_yield),
+      Real::input(heston.initial_variance),
+      Real::input(heston.mean_reversion),
+      Real::input(heston.long_run_variance),
+      Real::input(heston.vol_of_vol),
+      Real::input(heston.correlation),
+    };
+    const Real& spot = inputs[0];
+    const Real& strike = inputs[1];
+    const Real discount = aad::exp(-inputs[2] * grid.maturity());
+    // HestonPathModel keeps kappa and xi away from zero and v0 non-negative.
+    const Real initial_variance = aad::max(inputs[4], 0.0);
+    const Real kappa = aad::max(inputs[5], 1e-8);
+    const Real xi = aad::max(inputs[7], 1e-8);
+    const Real carry_rate = inputs[2] - inputs[3];
+
+    std::vector<HestonStep<Real>> constants;
+    constants.reserve(steps);
+    double previous_time = 0.0;
+    for (std::size_t k = 0; k < steps; ++k) {
+      constants.push_back(heston_step(kappa, inputs[6], xi, inputs[8], carry_rate, grid.times[k] - previous_time));
+      previous_time = grid.times[k];
+    }
+    const std::size_t mark = tape.size();
+
+    std::vector<Real> path(steps);
+    double payoff_sum = 0.0;
+    for (std::size_t i = 0; i < size; ++i) {
+      Real current = spot;
+      Real variance = initial_variance;
+      for (std::size_t k = 0; k < steps; ++k) {
+        const double* z = normals.data() + k * 2U * size;
+        current = current * aad::exp(heston_qe_step(constants[k], variance, z[i], z[size + i]));
+        path[k] = current;
+      }
+      const Real value = payoff(path, strike);
+      block_stats[b].add(value.value());
+      payoff_sum += value.value();
+      if (value.active()) {
+        tape.adjoint(value.index()) += discount.value() * scale;
+        tape.propagate(mark);
+      }
+      tape.rewind(mark);
+    }
+
+    tape.adjoint(discount.index()) += payoff_sum * scale;
+    tape.propagate();
+    for (std::size_t j = 0; j < kInputs; ++j) {
+      block_adjoints[b * kInputs + j] = tape.adjoint(inputs[j].index());
+    }
+  });
+
+  RunningStats stats;
+  double totals[kInputs] = {};
+  for (std::size_t b = 0; b < blocks; ++b) {
+    stats.merge(block_stats[b]);
+    for (std::size_t j = 0; j < kInputs; ++j) {
+      totals[j] += block_adjoints[b * kInputs + j];
+    }
+  }
+  const double discount = std::exp(-option.rate * grid.maturity());
+  return HestonAdjointGreeks{
+    .price = discount * stats.mean,
+    .standard_error = discount * stats.standard_error(),
+    .d_spot = totals[0],
+    .d_strike = totals[1],
+    .d_rate = totals[2],
+    .d_dividend = totals[3],
+    .d_initial_variance = totals[4],
+    .d_mean_reversion = totals[5],
+    .d_long_run_variance = totals[6],
+    .d_vol_of_vol = totals[7],
+    .d_correlation = totals[8],
+    .paths = stats.count,
+  };
+}
+
+}  // namespace quant
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "quant.grpc.pb.h"
+
+#include "quant/grpc_service.hpp"
+#include "quant/scheduler.hpp"
+
+namespace quant {
+
+struct ServerThreading {
+  std::size_t completion_queues = 2;
+  std::size_t handler_threads = 2;  // per completion queue
+  SchedulerConfig scheduler{};
+};
+
+// Serves QuantService on gRPC's async API with the QuantGrpcService methods
+// as handlers. Each completion queue is drained by its own handler threads,
+// which answer control-plane RPCs (jobs, stats, streams) inline. Analytic
+// RPCs (pricing, greeks, implied vols, batches) and Monte Carlo RPCs are
+// queued on a WorkloadScheduler under separate classes and run on the shared
+// TaskPool, alongside the parallel work they fork, so a burst of simulations
+// never stalls real-time pricing and the process never uses more compute
+// threads than the pool has.
+class QuantAsyncServer {
+ public:
+  QuantAsyncServer(QuantGrpcService& handlers, ServerThreading threading);
+  ~QuantAsyncServer();
+
+  QuantAsyncServer(const QuantAsyncServer&) = delete;
+  QuantAsyncServer& operator=(const QuantAsyncServer&) = delete;
+
+  // Returns false if the server could not be started on `address`.
+  bool start(const std::string& address);
+
+  void wait();
+
+  // Stops accepting calls, gives in-flight calls a grace period, drains the
+  // scheduler and joins the handler threads.
+  void shutdown();
+
+ private:
+  QuantGrpcService& handlers_;
+  ServerThreading threading_;
+  crucible::quant::QuantService::AsyncService service_;
+  std::unique_ptr<grpc::Server> server_;
+  std::unique_ptr<WorkloadScheduler> scheduler_;
+  std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> queues_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace quant
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+
+#include <google/protobuf/arena.h>
+
+#include "quant.pb.h"
+
+#include "quant/black_scholes.hpp"
+
+namespace quant {
+
+// Columnar batch RPCs, between their protobuf messages and the batch
+// kernels. Kernels read the request's packed columns in place and write into
+// the response's repeated fields once they are reserved, so a batch costs one
+// allocation per output column and no copies. With the request and response
+// on an arena those allocations come out of a few arena blocks.
+
+// Points the batch kernels at the request's packed columns without copying.
+// Returns an empty message on success.
+std::string option_columns_from_proto(
+  const crucible::quant::OptionColumns& proto, bool needs_volatility, OptionColumns& columns);
+
+// Each returns an empty message on success, or why the request is invalid.
+std::string price_batch(
+  const crucible::quant::PriceBatchRequest& request, crucible::quant::PriceBatchResponse* response);
+std::string greeks_batch(
+  const crucible::quant::PriceBatchRequest& request, crucible::quant::GreeksBatchResponse* response);
+std::string implied_vol_batch(
+  const crucible::quant::ImpliedVolBatchRequest& request, crucible::quant::ImpliedVolBatchResponse* response);
+
+// Block sizes for an arena holding one batch call's request and response:
+// large first blocks, since even small batches carry several columns.
+google::protobuf::ArenaOptions batch_arena_options();
+
+}  // namespace quant
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 namespace quant {
 
@@ -39,4 +40,42 @@ ImpliedVolatilityResult implied_volatility(
   double tolerance = 1e-6,
   std::size_t max_iterations = 100);
 
+// Structure-of-arrays view of a batch: element i of each column is one
+// option. `dividend_yield` may be null (no dividends); `volatility` is not
+// read by implied_volatility_batch. Spot, strike, volatility and maturity are
+// floored at `input_floor`, matching how single-option requests are
+// sanitized.
+struct OptionColumns {
+  const double* spot;
+  const double* strike;
+  const double* rate;
+  const double* volatility;
+  const double* time_to_maturity;
+  const double* dividend_yield;
+  const bool* is_call;
+  std::size_t size;
+  double input_floor = 1e-9;
+};
+
+// Output columns, each with room for `OptionColumns::size` values.
+struct GreeksColumns {
+  double* price;
+  double* delta;
+  double* gamma;
+  double* vega;
+  double* theta;
+  double* rho;
+};
+
+void black_scholes_price_batch(const OptionColumns& options, double* prices);
+
+void black_scholes_greeks_batch(const OptionColumns& options, const GreeksColumns& greeks);
+
+void implied_volatility_batch(
+  const OptionColumns& options,
+  const double* target_prices,
+  double* implied_volatilities,
+  bool* converged,
+  std::uint32_t* iterations);
+
 }  // namespace quant
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <complex>
+#include <functional>
+
+#include "quant/black_scholes.hpp"
+
+namespace quant {
+
+// phi(u) = E[exp(i u ln S_T)] under the risk-neutral measure. Must accept
+// complex arguments on the strip -1 <= Im(u) <= 0.
+using CharacteristicFunction = std::function<std::complex<double>(std::complex<double>)>;
+
+// European price by Gil-Pelaez inversion of the log-spot characteristic
+// function. Uses spot, strike, rate, dividend yield, maturity and call/put
+// from `option`; the volatility field is ignored. Puts come from parity.
+double characteristic_function_price(const CharacteristicFunction& phi, const OptionInput& option);
+
+}  // namespace quant
@@ -1,21 +1,94 @@
 #pragma once
 
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
 #include <grpcpp/grpcpp.h>
 
 #include "quant.grpc.pb.h"
 
 #include "quant/black_scholes.hpp"
+#include "quant/heston.hpp"
+#include "quant/job_manager.hpp"
+#include "quant/jump_diffusion.hpp"
+#include "quant/micro_batcher.hpp"
 #include "quant/monte_carlo.hpp"
+#include "quant/multi_asset.hpp"
+#include "quant/option_book.hpp"
+#include "quant/path_engine.hpp"
+#include "quant/request_coalescer.hpp"
+#include "quant/result_cache.hpp"
+#include "quant/shared_batch.hpp"
 
 namespace quant {
 
 OptionInput option_from_proto(const crucible::quant::OptionSpecification& proto);
 
+// option_from_proto with spot, strike, volatility and maturity floored at
+// 1e-6, as every pricing RPC applies.
+OptionInput sanitized_option_from_proto(const crucible::quant::OptionSpecification& proto);
+
+void greeks_to_proto(const OptionGreeks& greeks, crucible::quant::PriceResponse* response);
+void greeks_to_proto(const OptionGreeks& greeks, crucible::quant::GreeksResponse* response);
+
+HestonParameters heston_from_proto(const crucible::quant::HestonParameters& proto);
+
+MertonJumpParameters merton_from_proto(const crucible::quant::MertonJumpParameters& proto);
+
+KouJumpParameters kou_from_proto(const crucible::quant::KouJumpParameters& proto);
+
+// Returns null and fills `error` when a script payoff fails to compile.
+std::unique_ptr<PathPayoff> path_payoff_from_proto(
+  const OptionInput& option,
+  const crucible::quant::PathPayoffSpecification& proto,
+  std::string* error = nullptr);
+
+void job_progress_to_proto(const JobSnapshot& snapshot, crucible::quant::JobProgress* progress);
+
+// Books registered on one Reprice stream, shared by the synchronous handler
+// and the async server.
+class RepriceSession {
+ public:
+  // Applies one request and sets `respond` when `response` should be sent.
+  // A non-OK status ends the stream.
+  grpc::Status apply(
+    const crucible::quant::RepriceRequest& request, crucible::quant::RepriceResponse* response, bool* respond);
+
+ private:
+  std::map<std::uint64_t, OptionBook> books_;
+  std::uint64_t next_book_id_ = 1;
+};
+
+struct QuantServiceConfig {
+  ResultCacheConfig result_cache{};
+  MicroBatchConfig micro_batch{};
+  // Accept AttachSharedMemory from co-located clients.
+  bool shared_memory = false;
+  // SubmitMonteCarloJob fails RESOURCE_EXHAUSTED while this many jobs are running.
+  std::size_t max_running_jobs = 16;
+};
+
 class QuantGrpcService final : public crucible::quant::QuantService::Service {
  public:
-  QuantGrpcService() = default;
+  explicit QuantGrpcService(QuantServiceConfig config = {})
+    : jobs_(1024, config.max_running_jobs),
+      result_cache_(std::move(config.result_cache)),
+      micro_batcher_(
+        config.micro_batch.window.count() > 0 ? std::make_unique<MicroBatcher>(config.micro_batch) : nullptr),
+      shared_memory_(config.shared_memory) {}
   ~QuantGrpcService() override = default;
 
+  // For the async server's WatchJob, which polls instead of blocking.
+  JobManager& jobs() { return jobs_; }
+
+  // Price and Greeks go through this when micro-batching is enabled (null
+  // otherwise); the async server submits to it without blocking.
+  MicroBatcher* micro_batcher() { return micro_batcher_.get(); }
+
   grpc::Status Price(
     grpc::ServerContext* context,
     const crucible::quant::PriceRequest* request,
@@ -35,6 +108,110 @@ class QuantGrpcService final : public crucible::quant::QuantService::Service {
     grpc::ServerContext* context,
     const crucible::quant::MonteCarloRequest* request,
     crucible::quant::MonteCarloResponse* response) override;
+
+  grpc::Status PathMonteCarlo(
+    grpc::ServerContext* context,
+    const crucible::quant::PathMonteCarloRequest* request,
+    crucible::quant::MonteCarloResponse* response) override;
+
+  grpc::Status AmericanMonteCarlo(
+    grpc::ServerContext* context,
+    const crucible::quant::AmericanMonteCarloRequest* request,
+    crucible::quant::AmericanMonteCarloResponse* response) override;
+
+  grpc::Status MultiAssetMonteCarlo(
+    grpc::ServerContext* context,
+    const crucible::quant::MultiAssetMonteCarloRequest* request,
+    crucible::quant::MonteCarloResponse* response) override;
+
+  grpc::Status JumpDiffusionPrice(
+    grpc::ServerContext* context,
+    const crucible::quant::JumpDiffusionRequest* request,
+    crucible::quant::PriceResponse* response) override;
+
+  grpc::Status MultiPayoffMonteCarlo(
+    grpc::ServerContext* context,
+    const crucible::quant::MultiPayoffMonteCarloRequest* request,
+    crucible::quant::MultiPayoffMonteCarloResponse* response) override;
+
+  grpc::Status SubmitMonteCarloJob(
+    grpc::ServerContext* context,
+    const crucible::quant::MonteCarloJobRequest* request,
+    crucible::quant::JobHandle* response) override;
+
+  // Streams progress until the job finishes. If the client goes away first,
+  // the job is cancelled unless it was submitted detached.
+  grpc::Status WatchJob(
+    grpc::ServerContext* context,
+    const crucible::quant::JobHandle* request,
+    grpc::ServerWriter<crucible::quant::JobProgress>* writer) override;
+
+  grpc::Status CancelJob(
+    grpc::ServerContext* context,
+    const crucible::quant::JobHandle* request,
+    crucible::quant::JobProgress* response) override;
+
+  grpc::Status CacheStats(
+    grpc::ServerContext* context,
+    const crucible::quant::CacheStatsRequest* request,
+    crucible::quant::CacheStatsResponse* response) override;
+
+  grpc::Status PriceBatch(
+    grpc::ServerContext* context,
+    const crucible::quant::PriceBatchRequest* request,
+    crucible::quant::PriceBatchResponse* response) override;
+
+  grpc::Status GreeksBatch(
+    grpc::ServerContext* context,
+    const crucible::quant::PriceBatchRequest* request,
+    crucible::quant::GreeksBatchResponse* response) override;
+
+  grpc::Status ImpliedVolBatch(
+    grpc::ServerContext* context,
+    const crucible::quant::ImpliedVolBatchRequest* request,
+    crucible::quant::ImpliedVolBatchResponse* response) override;
+
+  // Books live as long as the stream that registered them.
+  grpc::Status Reprice(
+    grpc::ServerContext* context,
+    grpc::ServerReaderWriter<crucible::quant::RepriceResponse, crucible::quant::RepriceRequest>* stream) override;
+
+  grpc::Status MicroBatchStats(
+    grpc::ServerContext* context,
+    const crucible::quant::MicroBatchStatsRequest* request,
+    crucible::quant::MicroBatchStatsResponse* response) override;
+
+  grpc::Status AttachSharedMemory(
+    grpc::ServerContext* context,
+    const crucible::quant::AttachSharedMemoryRequest* request,
+    crucible::quant::AttachSharedMemoryResponse* response) override;
+
+  grpc::Status DetachSharedMemory(
+    grpc::ServerContext* context,
+    const crucible::quant::DetachSharedMemoryRequest* request,
+    crucible::quant::DetachSharedMemoryResponse* response) override;
+
+  // Runs a batch on an attached region's columns and writes the outputs
+  // there; the response itself is empty.
+  grpc::Status SharedBatch(
+    grpc::ServerContext* context,
+    const crucible::quant::SharedBatchRequest* request,
+    crucible::quant::SharedBatchResponse* response) override;
+
+ private:
+  OptionGreeks price_single(const OptionInput& option);
+
+  JobManager jobs_;
+  // Serialized MonteCarlo responses keyed by their canonical inputs.
+  ResultCache result_cache_;
+  RequestCoalescer in_flight_;
+  std::unique_ptr<MicroBatcher> micro_batcher_;
+
+  bool shared_memory_;
+  std::mutex regions_mutex_;
+  // Shared so a batch keeps its region mapped through a concurrent detach.
+  std::map<std::uint64_t, std::shared_ptr<SharedRegion>> regions_;
+  std::uint64_t next_region_id_ = 1;
 };
 
 }  // namespace quant
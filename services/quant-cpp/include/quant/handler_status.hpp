@@ -0,0 +1,25 @@
+#pragma once
+
+#include <exception>
+#include <utility>
+
+#include <grpcpp/support/status.h>
+
+namespace quant {
+
+// Runs a handler body and returns its status, or INTERNAL with the message of
+// an exception that escapes it. The async server runs handlers on
+// completion-queue threads and pool workers, where an escaping exception
+// would reach std::terminate instead of failing just the one call.
+template <typename Body>
+grpc::Status handler_status(Body&& body) {
+  try {
+    return std::forward<Body>(body)();
+  } catch (const std::exception& e) {
+    return grpc::Status(grpc::StatusCode::INTERNAL, e.what());
+  } catch (...) {
+    return grpc::Status(grpc::StatusCode::INTERNAL, "unknown error");
+  }
+}
+
+}  // namespace quant
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "quant/black_scholes.hpp"
+#include "quant/path_engine.hpp"
+
+namespace quant {
+
+struct HestonParameters {
+  double initial_variance;
+  double mean_reversion;      // kappa
+  double long_run_variance;   // theta
+  double vol_of_vol;          // xi
+  double correlation;         // rho between spot and variance shocks
+};
+
+// Log-spot characteristic function ("little trap" form, stable for long
+// maturities). The option's volatility field is ignored.
+std::complex<double> heston_characteristic_function(
+  const OptionInput& option,
+  const HestonParameters& heston,
+  std::complex<double> u);
+
+// Semi-analytic European price via the characteristic-function pricer.
+double heston_price(const OptionInput& option, const HestonParameters& heston);
+
+// Constants of one QE step of length dt. The step is written once over T =
+// double (HestonPathModel) or aad::Real (heston_path_monte_carlo_adjoint),
+// so the adjoint follows exactly the paths the model simulates.
+template <typename T>
+struct HestonStep {
+  T e;
+  T c1;
+  T c2;
+  T k1;
+  T k2;
+  T k3;
+  T k4;
+  T a_coeff;
+  T k0_plain;
+  T carry;
+  T theta;
+};
+
+// `carry_rate` is rate - dividend yield. kappa and xi must be positive.
+template <typename T>
+HestonStep<T> heston_step(
+  const T& kappa, const T& theta, const T& xi, const T& rho, const T& carry_rate, double dt) {
+  using std::exp;
+  // gamma_1 = gamma_2 = 1/2, central discretisation.
+  const T e = exp(-kappa * dt);
+  const T k3 = 0.5 * dt * (1.0 - rho * rho);
+  const T k2 = 0.5 * dt * (kappa * rho / xi - 0.5) + rho / xi;
+  const T k4 = k3;
+  return HestonStep<T>{
+    .e = e,
+    .c1 = xi * xi * e * (1.0 - e) / kappa,
+    .c2 = theta * xi * xi * 0.5 * (1.0 - e) * (1.0 - e) / kappa,
+    .k1 = 0.5 * dt * (kappa * rho / xi - 0.5) - rho / xi,
+    .k2 = k2,
+    .k3 = k3,
+    .k4 = k4,
+    .a_coeff = k2 + 0.5 * k4,
+    .k0_plain = -rho * kappa * theta * dt / xi,
+    .carry = carry_rate * dt,
+    .theta = theta,
+  };
+}
+
+// Moves the variance `v` one step with variance normal `zv` and spot normal
+// `zs`, and returns the log-spot increment.
+template <typename T>
+T heston_qe_step(const HestonStep<T>& step, T& v, double zv, double zs) {
+  using std::log;
+  using std::sqrt;
+  constexpr double kPsiCritical = 1.5;
+  constexpr double kInvSqrtTwo = 0.70710678118654752440;
+  const T m = step.theta + (v - step.theta) * step.e;
+  const T s2 = v * step.c1 + step.c2;
+  const T psi = s2 / (m * m);
+
+  T v_next = 0.0;
+  T k0 = step.k0_plain;
+  if (psi <= kPsiCritical) {
+    const T inv_psi = 2.0 / psi;
+    const T b2 = inv_psi - 1.0 + sqrt(inv_psi) * sqrt(inv_psi - 1.0);
+    const T a = m / (1.0 + b2);
+    const T root = sqrt(b2) + zv;
+    v_next = a * root * root;
+    if (step.a_coeff < 0.5 / a) {
+      k0 = -step.a_coeff * b2 * a / (1.0 - 2.0 * step.a_coeff * a) + 0.5 * log(1.0 - 2.0 * step.a_coeff * a)
+           - (step.k1 + 0.5 * step.k3) * v;
+    }
+  } else {
+    const T p = (psi - 1.0) / (psi + 1.0);
+    const T beta = (1.0 - p) / m;
+    const double u = 0.5 * std::erfc(-zv * kInvSqrtTwo);
+    if (u > p) {
+      v_next = log((1.0 - p) / (1.0 - u)) / beta;
+    }
+    if (step.a_coeff < beta) {
+      k0 = -log(p + beta * (1.0 - p) / (beta - step.a_coeff)) - (step.k1 + 0.5 * step.k3) * v;
+    }
+  }
+
+  const T integrated = step.k3 * v + step.k4 * v_next;
+  const T increment = step.carry + k0 + step.k1 * v + step.k2 * v_next + sqrt(integrated) * zs;
+  v = v_next;
+  return increment;
+}
+
+// Andersen (2008) Quadratic-Exponential discretisation of the variance with
+// the martingale-corrected log-spot step, so discounted spot is an exact
+// martingale on the grid. Uses two normals per step: one drives the variance
+// (mapped to a uniform for the exponential branch) and one the spot.
+class HestonPathModel final : public PathModel {
+ public:
+  HestonPathModel(const OptionInput& option, const HestonParameters& heston);
+
+  std::unique_ptr<PathModel> clone() const override;
+  double initial_spot() const override { return spot_; }
+  double discount_rate() const override { return rate_; }
+  std::size_t normals_per_step() const override { return 2; }
+
+  void begin(std::size_t size) override;
+  void advance(
+    const PathStep& step,
+    const double* previous,
+    double* next,
+    double* step_variance) override;
+
+ private:
+  double spot_;
+  double rate_;
+  double dividend_yield_;
+  HestonParameters heston_;
+  std::vector<double> variance_;
+};
+
+}  // namespace quant
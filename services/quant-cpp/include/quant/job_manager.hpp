@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+#include "quant/monte_carlo.hpp"
+
+namespace quant {
+
+enum class JobState { running, completed, cancelled, deadline_exceeded, failed };
+
+struct JobSnapshot {
+  std::uint64_t id;
+  JobState state;
+  MonteCarloResult progress;     // latest checkpoint, final result when done
+  std::uint64_t target_paths;
+  std::uint64_t version;         // bumped on every progress or state change
+  bool cancel_on_disconnect;
+  std::string error;             // set when state == failed
+};
+
+struct JobOptions {
+  std::uint64_t target_paths = 0;
+  std::optional<std::chrono::steady_clock::time_point> deadline{};
+  bool cancel_on_disconnect = true;
+  // Cancel the job once nobody has polled it (snapshot or wait_for_update)
+  // for this long, so work whose client went away stops. Unset keeps the job
+  // running unwatched.
+  std::optional<std::chrono::milliseconds> abandon_after{};
+};
+
+// Runs long Monte Carlo jobs on their own threads and keeps their progress
+// for polling or streaming. Work receives a stop token (set by cancel(), the
+// deadline, abandonment or shutdown) and a report callback for checkpoints; its return
+// value becomes the final result. At most `max_running` jobs (each holding
+// a thread) run at once; submit() refuses more rather than queueing them.
+// Finished jobs are retained, oldest evicted first, up to `max_retained`.
+class JobManager {
+ public:
+  using Report = std::function<void(const MonteCarloResult&)>;
+  using Work = std::function<MonteCarloResult(std::stop_token, const Report&)>;
+
+  explicit JobManager(std::size_t max_retained = 1024, std::size_t max_running = 16);
+  ~JobManager();
+
+  JobManager(const JobManager&) = delete;
+  JobManager& operator=(const JobManager&) = delete;
+
+  // Returns the new job's id, or nullopt when max_running jobs are running.
+  std::optional<std::uint64_t> submit(const JobOptions& options, Work work);
+
+  std::optional<JobSnapshot> snapshot(std::uint64_t id) const;
+
+  // Blocks until the job's version passes `seen_version` or `timeout`
+  // elapses, then returns its latest snapshot (nullopt for unknown ids).
+  // Like snapshot(), this counts as polling the job.
+  std::optional<JobSnapshot> wait_for_update(
+    std::uint64_t id,
+    std::uint64_t seen_version,
+    std::chrono::milliseconds timeout) const;
+
+  // Requests a stop; returns false for unknown or already finished jobs.
+  bool cancel(std::uint64_t id);
+
+ private:
+  struct Job {
+    JobSnapshot snapshot;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    bool deadline_hit = false;
+    std::optional<std::chrono::milliseconds> abandon_after;
+    std::chrono::steady_clock::time_point last_polled;
+    std::stop_source stop;
+    std::jthread worker;
+  };
+
+  void run(Job* job, const Work& work);
+  void watch_deadlines(std::stop_token stop);
+  void evict_finished();
+
+  std::size_t max_retained_;
+  std::size_t max_running_;
+  std::size_t running_ = 0;
+  mutable std::mutex mutex_;
+  mutable std::condition_variable updated_;
+  std::condition_variable_any deadline_changed_;
+  std::map<std::uint64_t, std::unique_ptr<Job>> jobs_;
+  std::uint64_t next_id_ = 1;
+  bool deadlines_changed_ = false;
+  std::jthread deadline_watcher_;
+};
+
+}  // namespace quant
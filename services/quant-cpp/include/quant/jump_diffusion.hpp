@@ -0,0 +1,91 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "quant/black_scholes.hpp"
+#include "quant/path_engine.hpp"
+
+namespace quant {
+
+// Merton (1976): log jump sizes ~ N(mean_jump, jump_volatility^2).
+struct MertonJumpParameters {
+  double intensity;        // lambda, jumps per year
+  double mean_jump;
+  double jump_volatility;
+};
+
+// Kou (2002): log jump sizes are Exp(up_rate) with probability up_probability
+// and -Exp(down_rate) otherwise. up_rate must exceed 1 for E[e^J] to exist.
+struct KouJumpParameters {
+  double intensity;
+  double up_probability;
+  double up_rate;          // eta_1
+  double down_rate;        // eta_2
+};
+
+// Merton's Poisson-weighted series of Black-Scholes prices. Terms are added
+// until the remaining Poisson mass bounds the truncation error below
+// `tolerance` (in price units) or `max_terms` is reached. The option's
+// volatility is the diffusion volatility.
+double merton_price(
+  const OptionInput& option,
+  const MertonJumpParameters& jumps,
+  double tolerance = 1e-10,
+  std::size_t max_terms = 500);
+
+std::complex<double> merton_characteristic_function(
+  const OptionInput& option,
+  const MertonJumpParameters& jumps,
+  std::complex<double> u);
+
+std::complex<double> kou_characteristic_function(
+  const OptionInput& option,
+  const KouJumpParameters& jumps,
+  std::complex<double> u);
+
+// European price via the characteristic-function pricer.
+double kou_price(const OptionInput& option, const KouJumpParameters& jumps);
+
+// GBM with compound-Poisson log jumps, compensated so discounted spot is a
+// martingale. Each step draws the jump count and sizes from PathStep::rng,
+// or takes the jump part from PathStep::log_jumps when given. step_variance
+// carries only the diffusive part, so bridge-based barrier monitoring treats
+// jumps as occurring at grid dates.
+class JumpDiffusionPathModel final : public PathModel {
+ public:
+  JumpDiffusionPathModel(const OptionInput& option, const MertonJumpParameters& jumps);
+  JumpDiffusionPathModel(const OptionInput& option, const KouJumpParameters& jumps);
+
+  std::unique_ptr<PathModel> clone() const override;
+  double initial_spot() const override { return spot_; }
+  double discount_rate() const override { return rate_; }
+
+  void begin(std::size_t size) override;
+  void advance(
+    const PathStep& step,
+    const double* previous,
+    double* next,
+    double* step_variance) override;
+  bool draw_log_jumps(double dt, RandomStream& rng, double* out, std::size_t size) const override;
+
+ private:
+  enum class JumpLaw { lognormal, double_exponential };
+
+  double jump_sum(RandomStream& rng, std::size_t count) const;
+
+  double spot_;
+  double rate_;
+  double dividend_yield_;
+  double volatility_;
+  JumpLaw law_;
+  MertonJumpParameters merton_{};
+  KouJumpParameters kou_{};
+  double intensity_;
+  double compensator_;  // E[e^J] - 1
+  std::vector<double> log_jumps_;
+};
+
+}  // namespace quant
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "quant/path_engine.hpp"
+
+namespace quant {
+
+// Largest regression matrix (exercise dates x regression paths) lsm_price
+// will hold: 400 MB of spots.
+inline constexpr std::uint64_t kMaxRegressionValues = 50'000'000;
+
+struct LsmConfig {
+  std::uint64_t regression_paths;
+  std::uint64_t pricing_paths;
+  std::uint32_t seed;
+  std::size_t basis_degree = 3;  // polynomial in moneyness S/K
+  std::size_t block_paths = kDefaultBlockPaths;
+};
+
+struct LsmResult {
+  double price;             // out-of-sample estimate, a lower bound
+  double standard_error;
+  double in_sample_price;   // estimate on the regression paths
+  std::uint64_t paths;      // out-of-sample paths
+};
+
+// Grid steps at which exercise is allowed: `dates` equally spaced dates on a
+// grid of `steps` steps, or every step when dates is 0. Always ends at maturity.
+std::vector<std::size_t> exercise_steps(std::size_t steps, std::size_t dates);
+
+// Longstaff-Schwartz pricing of an American/Bermudan vanilla under `model`.
+// The exercise boundary is fitted by least squares on one path set, with the
+// spot at each exercise date held for the backward pass (dates x paths), and
+// then applied to an independent path set for an unbiased lower bound.
+// Normal equations are accumulated per path block and summed in block order,
+// so results are deterministic for a seed regardless of thread count.
+// Returns zero paths for an empty grid or path set, or when dates x paths
+// exceeds kMaxRegressionValues.
+LsmResult lsm_price(
+  const PathModel& model,
+  const TimeGrid& grid,
+  const std::vector<std::size_t>& exercise_steps,
+  double strike,
+  bool is_call,
+  const LsmConfig& config);
+
+}  // namespace quant
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "quant/black_scholes.hpp"
+#include "quant/scheduler.hpp"
+
+namespace quant {
+
+struct MicroBatchConfig {
+  // How long the first call of a batch may wait for company; 0 disables
+  // micro-batching.
+  std::chrono::microseconds window{0};
+  // A batch is flushed early once it holds this many calls.
+  std::size_t max_batch = 256;
+  // Calls allowed to wait at once, in batches of max_batch; submit() refuses
+  // calls beyond that.
+  std::size_t max_pending_batches = 8;
+};
+
+struct MicroBatchStats {
+  std::uint64_t batches;
+  std::uint64_t calls;
+  std::uint64_t max_batch_size;
+  // Bucket k counts batches whose size lies in [2^k, 2^(k+1)).
+  std::array<std::uint64_t, 16> batch_size_histogram;
+  // Time from submit() until the call's batch started pricing.
+  std::uint64_t total_queue_delay_ns;
+  std::uint64_t max_queue_delay_ns;
+};
+
+// Gathers single-option Black-Scholes calls arriving within a short window
+// into one structure-of-arrays batch for black_scholes_greeks_batch, then
+// completes each call individually. Completions run on the batcher's thread
+// and must be quick. Pending calls are flushed on destruction.
+//
+// The waiting queue is bounded. A call that finds it full is refused, and
+// `done` is not called; retry_after estimates how long the queue takes to
+// drain, from the time the last batch took.
+class MicroBatcher {
+ public:
+  using Completion = std::function<void(const OptionGreeks&)>;
+
+  explicit MicroBatcher(MicroBatchConfig config);
+  ~MicroBatcher();
+
+  MicroBatcher(const MicroBatcher&) = delete;
+  MicroBatcher& operator=(const MicroBatcher&) = delete;
+
+  Admission submit(const OptionInput& option, Completion done);
+
+  MicroBatchStats stats() const;
+
+ private:
+  struct Pending {
+    OptionInput option;
+    Completion done;
+    std::chrono::steady_clock::time_point arrived;
+  };
+
+  void run();
+  void price(std::vector<Pending>& batch);
+
+  MicroBatchConfig config_;
+  mutable std::mutex mutex_;
+  std::condition_variable arrived_;
+  std::vector<Pending> pending_;
+  std::size_t max_pending_ = 0;
+  std::chrono::nanoseconds batch_time_{0};  // pricing plus completions, last batch
+  bool stopping_ = false;
+  MicroBatchStats stats_{};
+
+  // Column buffers sized for max_batch, touched only by the batcher thread.
+  std::vector<double> spot_;
+  std::vector<double> strike_;
+  std::vector<double> rate_;
+  std::vector<double> volatility_;
+  std::vector<double> maturity_;
+  std::vector<double> dividend_;
+  std::unique_ptr<bool[]> is_call_;
+  std::vector<double> price_;
+  std::vector<double> delta_;
+  std::vector<double> gamma_;
+  std::vector<double> vega_;
+  std::vector<double> theta_;
+  std::vector<double> rho_;
+
+  std::thread worker_;
+};
+
+}  // namespace quant
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "quant/path_engine.hpp"
+
+namespace quant {
+
+struct MlmcConfig {
+  double target_rmse;
+  std::uint32_t seed;
+  std::size_t base_steps = 1;        // steps on level 0; level l uses base * 2^l
+  std::size_t min_levels = 3;        // at least 2, for the bias estimate
+  std::size_t max_levels = 12;
+  std::uint64_t initial_paths = 4096;
+  std::size_t block_paths = kDefaultBlockPaths;
+  // Cost budget in simulated steps (fine plus coarse, summed over levels).
+  std::uint64_t max_simulated_steps = 1'000'000'000;
+};
+
+struct MlmcLevel {
+  std::size_t steps;
+  std::uint64_t paths;
+  double mean;      // discounted E[P_l - P_{l-1}] (E[P_0] on level 0)
+  double variance;  // discounted variance of the level correction
+};
+
+struct MlmcResult {
+  double price;
+  double standard_error;
+  std::uint64_t paths;          // summed over levels
+  std::uint64_t simulated_steps;
+  bool converged;               // bias and variance targets both met
+  bool budget_exhausted;        // stopped: the next allocation exceeds max_simulated_steps
+  std::vector<MlmcLevel> levels;
+};
+
+// Multilevel Monte Carlo (Giles 2008) over uniform grids with 2x refinement.
+// Level l > 0 simulates fine (base * 2^l steps) and coarse paths driven by
+// the same Brownian increments, the coarse normal being the scaled sum of
+// its two fine normals and its jump part (PathModel::draw_log_jumps) the sum
+// of theirs, so any PathModel/PathPayoff pair can be used. Per-level
+// variances are estimated as samples arrive and paths are allocated as
+// N_l ~ sqrt(V_l / C_l) to reach `target_rmse`; levels are added until the
+// estimated bias is below target_rmse / sqrt(2). Samples are drawn in whole
+// blocks on per-level random streams, so results are deterministic.
+// Before each round of sampling the planned total cost is checked against
+// max_simulated_steps; if it would be exceeded the run stops and returns an
+// empty result with budget_exhausted set, so an over-tight target fails fast
+// instead of running unbounded.
+MlmcResult mlmc_price(
+  const PathModel& model,
+  double maturity,
+  const PathPayoff& payoff,
+  const MlmcConfig& config);
+
+}  // namespace quant
@@ -1,14 +1,47 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <stop_token>
 
 #include "quant/black_scholes.hpp"
 
 namespace quant {
 
+// Streaming mean/variance accumulator (Welford). Partial accumulators from
+// independent blocks combine exactly via merge().
+struct RunningStats {
+  std::uint64_t count = 0;
+  double mean = 0.0;
+  double m2 = 0.0;
+
+  void add(double value);
+  void merge(const RunningStats& other);
+  double variance() const;
+  double standard_error() const;
+};
+
 struct MonteCarloResult {
   double price;
   double standard_error;
+  std::uint64_t paths;
+};
+
+struct MonteCarloEstimate {
+  double value;
+  double standard_error;
+};
+
+// Sensitivities estimated on the same paths as the price. Delta and vega are
+// pathwise when the payoff supports it (likelihood ratio otherwise); gamma is
+// always a likelihood-ratio estimate.
+struct MonteCarloGreeks {
+  MonteCarloEstimate price;
+  MonteCarloEstimate delta;
+  MonteCarloEstimate gamma;
+  MonteCarloEstimate vega;
+  std::uint64_t paths;
+  bool pathwise;
 };
 
 MonteCarloResult monte_carlo_price(
@@ -16,4 +49,44 @@ MonteCarloResult monte_carlo_price(
   std::uint32_t paths,
   std::uint32_t seed);
 
+// Simulates blocks of `block_paths` until the discounted standard error drops
+// to `target_standard_error` or `max_paths` is reached. The returned `paths`
+// is the number actually simulated.
+MonteCarloResult monte_carlo_price_adaptive(
+  const OptionInput& option,
+  double target_standard_error,
+  std::uint64_t max_paths,
+  std::uint32_t seed,
+  std::uint32_t block_paths = 4096U);
+
+// Receives the running (discounted) estimate at each checkpoint; returning
+// false stops the run after the blocks already merged.
+using MonteCarloCheckpoint = std::function<bool(const MonteCarloResult&)>;
+
+struct MonteCarloRunConfig {
+  std::uint64_t block_paths = 16'384;
+  std::size_t checkpoint_blocks = 64;  // blocks between checkpoints
+  double target_standard_error = 0.0;  // stop once reached when > 0
+  std::stop_token stop{};              // polled before every block
+  MonteCarloCheckpoint checkpoint{};
+};
+
+// Parallel vanilla pricer for long runs. Blocks draw from independent
+// RandomStream(seed, block) streams and are merged in block order, so the
+// estimate after N blocks depends only on the seed and block_paths. A stop
+// request is honoured within one block per worker; the result then covers
+// the contiguous prefix of completed blocks.
+MonteCarloResult monte_carlo_price_checkpointed(
+  const OptionInput& option,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  const MonteCarloRunConfig& config = {});
+
+// European greeks from the same normals monte_carlo_price draws for a seed,
+// so the price matches a plain run exactly.
+MonteCarloGreeks monte_carlo_greeks(
+  const OptionInput& option,
+  std::uint32_t paths,
+  std::uint32_t seed);
+
 }  // namespace quant
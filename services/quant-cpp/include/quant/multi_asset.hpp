@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "quant/monte_carlo.hpp"
+#include "quant/path_engine.hpp"
+
+namespace quant {
+
+struct MultiAssetInput {
+  std::vector<double> spots;
+  std::vector<double> volatilities;
+  std::vector<double> dividend_yields;
+  std::vector<double> correlation;  // n x n, row-major
+  double rate;
+  double time_to_maturity;
+};
+
+enum class MultiAssetPayoffType { basket, best_of, worst_of, spread };
+
+// basket:   weighted sum of terminal spots against the strike.
+// best_of:  max_i (w_i S_i), worst_of: min_i (w_i S_i).
+// spread:   w_0 S_0 - w_1 S_1 against the strike (first two assets).
+// Empty weights mean 1 for every asset (1/n for baskets).
+struct MultiAssetPayoff {
+  MultiAssetPayoffType type;
+  double strike;
+  bool is_call;
+  std::vector<double> weights;
+};
+
+// Square root F of a correlation matrix with F F^T = C, row-major n x n.
+// Lower-triangular Cholesky when C is positive definite; otherwise a
+// symmetric eigen-decomposition with negative eigenvalues clipped and rows
+// rescaled to unit variance (nearest valid correlation in that sense).
+struct CorrelationFactor {
+  std::vector<double> matrix;
+  std::size_t dimension = 0;
+  bool cholesky = true;
+};
+
+CorrelationFactor factor_correlation(const std::vector<double>& correlation, std::size_t dimension);
+
+// Empty if `correlation` is an n x n correlation matrix: finite, symmetric,
+// unit diagonal, entries in [-1, 1] and positive semi-definite up to
+// rounding. Otherwise names the check that failed. Singular matrices such
+// as perfect correlation pass and are factored through the eigen path.
+std::string validate_correlation(const std::vector<double>& correlation, std::size_t dimension);
+
+// Correlates a block of independent normals: out = F * in, where both are
+// dimension x size SoA arrays (one contiguous row per asset).
+void correlate_block(
+  const CorrelationFactor& factor,
+  const double* independent,
+  double* correlated,
+  std::size_t size);
+
+// European multi-asset price under correlated GBM. The correlation matrix is
+// factored once per call; returns an empty result on inconsistent input sizes
+// or a correlation matrix validate_correlation rejects.
+MonteCarloResult multi_asset_monte_carlo_price(
+  const MultiAssetInput& input,
+  const MultiAssetPayoff& payoff,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  std::size_t block_paths = kDefaultBlockPaths);
+
+}  // namespace quant
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "quant/black_scholes.hpp"
+
+namespace quant {
+
+// Options whose greeks changed in one reprice, as parallel columns.
+struct BookChanges {
+  std::vector<std::uint32_t> options;
+  std::vector<double> price;
+  std::vector<double> delta;
+  std::vector<double> gamma;
+  std::vector<double> vega;
+  std::vector<double> theta;
+  std::vector<double> rho;
+
+  std::size_t size() const { return options.size(); }
+  void clear();
+};
+
+// A registered book of Black-Scholes options for tick-by-tick repricing.
+// Market updates only mark the affected options dirty; reprice() then
+// values just those and reports the ones whose price moved by more than
+// `tolerance` since they were last reported (so slow drifts are reported
+// once they add up). Every option is reported on the first reprice.
+class OptionBook {
+ public:
+  // `underlyings[i]` names the underlying of option i; empty means all
+  // options share underlying 0. Ids are keys, not indices, so any value is
+  // fine. Inputs are floored as in OptionColumns.
+  OptionBook(const OptionColumns& options, const std::vector<std::uint32_t>& underlyings, double tolerance);
+
+  std::size_t size() const { return size_; }
+
+  // Return false (and change nothing) for unknown underlyings or options.
+  bool set_spot(std::uint32_t underlying, double spot);
+  bool set_volatility(std::uint32_t option, double volatility);
+
+  const BookChanges& reprice();
+
+ private:
+  std::size_t size_;
+  double floor_;
+  double tolerance_;
+  std::vector<double> spot_;
+  std::vector<double> strike_;
+  std::vector<double> rate_;
+  std::vector<double> volatility_;
+  std::vector<double> maturity_;
+  std::vector<double> dividend_;
+  std::unique_ptr<bool[]> is_call_;
+  std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> by_underlying_;
+  std::vector<std::uint32_t> dirty_;
+  std::vector<bool> is_dirty_;
+  std::vector<double> reported_price_;
+  std::vector<bool> reported_;
+  BookChanges changes_;
+};
+
+}  // namespace quant
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace quant {
+
+// Runs body(i) for every i in [0, count) on the shared TaskPool and returns
+// once all have run, rethrowing the first exception. Calls may nest. Indices
+// are claimed dynamically, so callers that need deterministic output must
+// write per-index results and reduce them in index order afterwards.
+void parallel_for(std::size_t count, const std::function<void(std::size_t)>& body);
+
+class TaskPool;
+
+// As above, on a specific pool.
+void parallel_for(TaskPool& pool, std::size_t count, const std::function<void(std::size_t)>& body);
+
+}  // namespace quant
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "quant/black_scholes.hpp"
+#include "quant/monte_carlo.hpp"
+#include "quant/random.hpp"
+
+namespace quant {
+
+// Paths per block. A block keeps a handful of SoA arrays of this length live
+// (spots, normals, payoff state), which stays inside L2 for typical payoffs.
+inline constexpr std::size_t kDefaultBlockPaths = 1024;
+
+// Observation dates t_1 < ... < t_n = maturity; t_0 = 0 is implicit.
+struct TimeGrid {
+  std::vector<double> times;
+
+  static TimeGrid uniform(double maturity, std::size_t steps);
+
+  double maturity() const { return times.empty() ? 0.0 : times.back(); }
+  std::size_t steps() const { return times.size(); }
+};
+
+struct PathStep {
+  std::size_t index;
+  double time;
+  double dt;
+  const double* normals;  // normals_per_step() arrays of `size` values, SoA
+  std::size_t size;
+  RandomStream* rng = nullptr;  // block stream, for non-Gaussian draws (jumps)
+  const double* log_jumps = nullptr;  // jump part per path, used instead of drawing from rng
+};
+
+// Derivatives of the observed per-path quantities with respect to one model
+// input (e.g. initial spot or volatility).
+struct PathTangent {
+  const double* previous;
+  const double* current;
+  const double* step_variance;
+};
+
+// Arguments passed to payoffs at every grid date, one value per path.
+struct PathObservation {
+  std::size_t step;
+  double time;
+  double dt;
+  const double* previous;       // spot at the previous grid date
+  const double* current;        // spot at this grid date
+  const double* step_variance;  // integrated log-variance over the step
+  std::size_t size;
+  const PathTangent* tangents = nullptr;  // set only by pathwise-greek runs
+  std::size_t tangent_count = 0;
+};
+
+// Evolves a block of paths one grid step at a time. Instances carry per-block
+// scratch state, so the engine clones one per block.
+class PathModel {
+ public:
+  virtual ~PathModel() = default;
+
+  virtual std::unique_ptr<PathModel> clone() const = 0;
+  virtual double initial_spot() const = 0;
+  virtual double discount_rate() const = 0;
+  virtual std::size_t normals_per_step() const { return 1; }
+  // Draws the jump part of the log increment over `dt` for `size` paths from
+  // `rng`, in the order advance() would draw it; false (nothing drawn) for
+  // models without jumps. Multilevel estimators use this to hand the same
+  // jumps to fine and coarse paths through PathStep::log_jumps.
+  virtual bool draw_log_jumps(double /*dt*/, RandomStream& /*rng*/, double* /*out*/, std::size_t /*size*/) const {
+    return false;
+  }
+
+  virtual void begin(std::size_t size) = 0;
+  virtual void advance(
+    const PathStep& step,
+    const double* previous,
+    double* next,
+    double* step_variance) = 0;
+};
+
+class GbmPathModel final : public PathModel {
+ public:
+  explicit GbmPathModel(const OptionInput& option);
+
+  std::unique_ptr<PathModel> clone() const override;
+  double initial_spot() const override { return spot_; }
+  double discount_rate() const override { return rate_; }
+
+  void begin(std::size_t size) override;
+  void advance(
+    const PathStep& step,
+    const double* previous,
+    double* next,
+    double* step_variance) override;
+
+ private:
+  double spot_;
+  double rate_;
+  double dividend_yield_;
+  double volatility_;
+};
+
+// Observes each path as it is generated and settles to an undiscounted cash
+// flow at maturity. Per-path state lives in the payoff, sized in begin(), so
+// the full paths x steps matrix is never stored.
+class PathPayoff {
+ public:
+  virtual ~PathPayoff() = default;
+
+  virtual std::unique_ptr<PathPayoff> clone() const = 0;
+  virtual void begin(std::size_t size, double initial_spot) = 0;
+  virtual void observe(const PathObservation& observation) = 0;
+  virtual void settle(double* payoffs, std::size_t size) = 0;
+
+  // Pathwise-differentiable payoffs propagate observation tangents and
+  // report d(payoff)/d(input) per tangent direction in settle_tangents().
+  virtual bool supports_tangents() const { return false; }
+  virtual void settle_tangents(double* const* derivatives, std::size_t directions, std::size_t size) {
+    (void)derivatives;
+    (void)directions;
+    (void)size;
+  }
+};
+
+// Reusable SoA scratch for one block of paths.
+struct PathBlockBuffers {
+  std::vector<double> previous;
+  std::vector<double> current;
+  std::vector<double> step_variance;
+  std::vector<double> normals;
+  std::vector<double> payoffs;
+
+  void resize(std::size_t size, std::size_t normals_per_step);
+};
+
+// Simulates one block of `size` paths over `grid`, feeding every grid date to
+// `payoff`, and leaves undiscounted payoffs in buffers.payoffs.
+void simulate_path_block(
+  PathModel& model,
+  const TimeGrid& grid,
+  PathPayoff& payoff,
+  RandomStream& rng,
+  std::size_t size,
+  PathBlockBuffers& buffers);
+
+// Same as above, but feeds every observation to each of `payoffs` in turn
+// and leaves the undiscounted payoffs of payoffs[p] in payoff_values[p].
+void simulate_path_block(
+  PathModel& model,
+  const TimeGrid& grid,
+  const std::vector<PathPayoff*>& payoffs,
+  RandomStream& rng,
+  std::size_t size,
+  PathBlockBuffers& buffers,
+  std::vector<std::vector<double>>& payoff_values);
+
+// Prices `payoff` under `model`. Blocks use independent random streams keyed
+// by (seed, block index) and run in parallel; per-block statistics are merged
+// in block order, so the result depends only on the inputs and block_paths.
+MonteCarloResult path_monte_carlo_price(
+  const PathModel& model,
+  const TimeGrid& grid,
+  const PathPayoff& payoff,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  std::size_t block_paths = kDefaultBlockPaths);
+
+struct MultiPayoffResult {
+  std::vector<MonteCarloResult> prices;  // one per payoff, in input order
+  // Row-major covariance of the price estimators (diagonal = SE^2); empty
+  // unless requested.
+  std::vector<double> covariance;
+  std::uint64_t paths;
+};
+
+// Prices several payoffs (e.g. a strike ladder) on one shared path set, so
+// path generation is paid once. Each payoff's price matches what
+// path_monte_carlo_price returns for the same seed and block_paths.
+MultiPayoffResult path_monte_carlo_price_many(
+  const PathModel& model,
+  const TimeGrid& grid,
+  const std::vector<const PathPayoff*>& payoffs,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  bool covariance = false,
+  std::size_t block_paths = kDefaultBlockPaths);
+
+}  // namespace quant
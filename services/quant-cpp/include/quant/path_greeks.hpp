@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "quant/black_scholes.hpp"
+#include "quant/monte_carlo.hpp"
+#include "quant/path_engine.hpp"
+
+namespace quant {
+
+// Price, delta, gamma and vega of a path payoff under GBM in one simulation
+// pass. The paths are those path_monte_carlo_price(GbmPathModel(option), ...)
+// generates for the same seed and block size, so the prices agree exactly.
+//
+// Delta/vega are pathwise when payoff.supports_tangents(): tangents of every
+// observed spot with respect to S_0 and sigma are fed to the payoff. Otherwise
+// they fall back to likelihood-ratio weights. Gamma uses the likelihood-ratio
+// weight of the first step, so its noise grows as that step shrinks.
+MonteCarloGreeks path_monte_carlo_greeks(
+  const OptionInput& option,
+  const TimeGrid& grid,
+  const PathPayoff& payoff,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  std::size_t block_paths = kDefaultBlockPaths);
+
+}  // namespace quant
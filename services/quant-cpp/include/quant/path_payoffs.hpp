@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "quant/path_engine.hpp"
+
+namespace quant {
+
+// All payoffs below support pathwise tangents; tangent state is laid out as
+// one row of `size` values per direction.
+
+enum class AverageType { arithmetic, geometric };
+
+enum class BarrierType { up_and_out, up_and_in, down_and_out, down_and_in };
+
+class EuropeanPathPayoff final : public PathPayoff {
+ public:
+  EuropeanPathPayoff(double strike, bool is_call);
+
+  std::unique_ptr<PathPayoff> clone() const override;
+  void begin(std::size_t size, double initial_spot) override;
+  void observe(const PathObservation& observation) override;
+  void settle(double* payoffs, std::size_t size) override;
+  bool supports_tangents() const override { return true; }
+  void settle_tangents(double* const* derivatives, std::size_t directions, std::size_t size) override;
+
+ private:
+  double strike_;
+  bool is_call_;
+  std::vector<double> terminal_;
+  std::vector<double> terminal_tangent_;
+};
+
+// Fixed-strike Asian option on the average over all grid dates (t_1..t_n).
+class AsianPayoff final : public PathPayoff {
+ public:
+  AsianPayoff(double strike, bool is_call, AverageType average);
+
+  std::unique_ptr<PathPayoff> clone() const override;
+  void begin(std::size_t size, double initial_spot) override;
+  void observe(const PathObservation& observation) override;
+  void settle(double* payoffs, std::size_t size) override;
+  bool supports_tangents() const override { return true; }
+  void settle_tangents(double* const* derivatives, std::size_t directions, std::size_t size) override;
+
+ private:
+  double strike_;
+  bool is_call_;
+  AverageType average_;
+  std::size_t observations_ = 0;
+  std::vector<double> sum_;
+  std::vector<double> sum_tangent_;
+};
+
+// Continuously monitored single barrier. Between grid dates the crossing
+// probability of the log-spot Brownian bridge is applied analytically and the
+// payoff is weighted by the survival probability, which removes the discrete
+// monitoring bias without drawing extra random numbers.
+class BarrierPayoff final : public PathPayoff {
+ public:
+  BarrierPayoff(double strike, bool is_call, double barrier, BarrierType type);
+
+  std::unique_ptr<PathPayoff> clone() const override;
+  void begin(std::size_t size, double initial_spot) override;
+  void observe(const PathObservation& observation) override;
+  void settle(double* payoffs, std::size_t size) override;
+  bool supports_tangents() const override { return true; }
+  void settle_tangents(double* const* derivatives, std::size_t directions, std::size_t size) override;
+
+ private:
+  double strike_;
+  bool is_call_;
+  double barrier_;
+  BarrierType type_;
+  std::vector<double> terminal_;
+  std::vector<double> survival_;
+  std::vector<double> terminal_tangent_;
+  std::vector<double> survival_tangent_;
+};
+
+// Lookback monitored on the grid (including t_0). Floating strike pays
+// S_T - min (call) or max - S_T (put); fixed strike pays max - K or K - min.
+class LookbackPayoff final : public PathPayoff {
+ public:
+  LookbackPayoff(double strike, bool is_call, bool floating_strike);
+
+  std::unique_ptr<PathPayoff> clone() const override;
+  void begin(std::size_t size, double initial_spot) override;
+  void observe(const PathObservation& observation) override;
+  void settle(double* payoffs, std::size_t size) override;
+  bool supports_tangents() const override { return true; }
+  void settle_tangents(double* const* derivatives, std::size_t directions, std::size_t size) override;
+
+ private:
+  double strike_;
+  bool is_call_;
+  bool floating_strike_;
+  std::vector<double> terminal_;
+  std::vector<double> minimum_;
+  std::vector<double> maximum_;
+  std::vector<double> terminal_tangent_;
+  std::vector<double> minimum_tangent_;
+  std::vector<double> maximum_tangent_;
+};
+
+}  // namespace quant
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "quant/path_engine.hpp"
+#include "quant/path_payoffs.hpp"
+
+namespace quant::payoff {
+
+// Compile-time payoff composition. An expression is a small value type with
+// a per-path State and three inline members:
+//
+//   State start(double initial_spot) const;
+//   void observe(State& state, double spot) const;   // once per grid date
+//   double value(const State& state) const;          // at maturity
+//
+// Composites nest their children's states, so a whole payoff such as
+//
+//   Barrier(DownAndOut, 80.0, Max(Sub(Average(Path), 100.0), 0.0))
+//
+// flattens into one struct and one inlined loop body, with no virtual calls
+// or per-path allocation.
+
+template <typename E>
+concept Expression = requires(const E& e, typename E::State& state, double x) {
+  { e.start(x) } -> std::same_as<typename E::State>;
+  e.observe(state, x);
+  { e.value(std::as_const(state)) } -> std::convertible_to<double>;
+};
+
+// ---- leaves ----
+
+struct Constant {
+  struct State {};
+  double constant;
+  State start(double) const { return {}; }
+  void observe(State&, double) const {}
+  double value(const State&) const { return constant; }
+};
+
+struct SpotNode {
+  struct State {
+    double spot;
+  };
+  State start(double initial_spot) const { return {initial_spot}; }
+  void observe(State& state, double spot) const { state.spot = spot; }
+  double value(const State& state) const { return state.spot; }
+};
+
+struct InitialSpotNode {
+  struct State {
+    double spot;
+  };
+  State start(double initial_spot) const { return {initial_spot}; }
+  void observe(State&, double) const {}
+  double value(const State& state) const { return state.spot; }
+};
+
+// Spot at the last observed date.
+inline constexpr SpotNode Spot{};
+inline constexpr InitialSpotNode InitialSpot{};
+
+// Marker for path aggregates: Average(Path), Minimum(Path), Maximum(Path).
+struct PathTag {};
+inline constexpr PathTag Path{};
+
+template <typename T>
+auto lift(const T& operand) {
+  if constexpr (Expression<T>) {
+    return operand;
+  } else {
+    static_assert(std::is_arithmetic_v<T>, "payoff operands must be expressions or numbers");
+    return Constant{static_cast<double>(operand)};
+  }
+}
+
+template <typename T>
+using Lifted = decltype(lift(std::declval<T>()));
+
+// ---- path aggregates ----
+
+struct AverageNode {
+  struct State {
+    double sum;
+    std::size_t count;
+  };
+  State start(double) const { return {0.0, 0U}; }
+  void observe(State& state, double spot) const {
+    state.sum += spot;
+    ++state.count;
+  }
+  double value(const State& state) const {
+    return state.count == 0U ? 0.0 : state.sum / static_cast<double>(state.count);
+  }
+};
+
+struct MinimumNode {
+  struct State {
+    double extreme;
+  };
+  State start(double initial_spot) const { return {initial_spot}; }
+  void observe(State& state, double spot) const { state.extreme = std::min(state.extreme, spot); }
+  double value(const State& state) const { return state.extreme; }
+};
+
+struct MaximumNode {
+  struct State {
+    double extreme;
+  };
+  State start(double initial_spot) const { return {initial_spot}; }
+  void observe(State& state, double spot) const { state.extreme = std::max(state.extreme, spot); }
+  double value(const State& state) const { return state.extreme; }
+};
+
+// Arithmetic average over the grid dates t_1..t_n, as AsianPayoff.
+inline AverageNode Average(PathTag) { return {}; }
+// Running extremes include the initial spot, as LookbackPayoff.
+inline MinimumNode Minimum(PathTag) { return {}; }
+inline MaximumNode Maximum(PathTag) { return {}; }
+
+// ---- arithmetic ----
+
+template <typename Op, Expression L, Expression R>
+struct BinaryNode {
+  struct State {
+    typename L::State left;
+    typename R::State right;
+  };
+  L left;
+  R right;
+
+  State start(double initial_spot) const { return {left.start(initial_spot), right.start(initial_spot)}; }
+  void observe(State& state, double spot) const {
+    left.observe(state.left, spot);
+    right.observe(state.right, spot);
+  }
+  double value(const State& state) const { return Op::apply(left.value(state.left), right.value(state.right)); }
+};
+
+struct AddOp {
+  static double apply(double a, double b) { return a + b; }
+};
+struct SubOp {
+  static double apply(double a, double b) { return a - b; }
+};
+struct MulOp {
+  static double apply(double a, double b) { return a * b; }
+};
+struct DivOp {
+  static double apply(double a, double b) { return a / b; }
+};
+struct MaxOp {
+  static double apply(double a, double b) { return std::max(a, b); }
+};
+struct MinOp {
+  static double apply(double a, double b) { return std::min(a, b); }
+};
+
+template <typename Op, typename A, typename B>
+BinaryNode<Op, Lifted<A>, Lifted<B>> make_binary(const A& a, const B& b) {
+  return {lift(a), lift(b)};
+}
+
+template <typename A, typename B>
+auto Add(const A& a, const B& b) { return make_binary<AddOp>(a, b); }
+template <typename A, typename B>
+auto Sub(const A& a, const B& b) { return make_binary<SubOp>(a, b); }
+template <typename A, typename B>
+auto Mul(const A& a, const B& b) { return make_binary<MulOp>(a, b); }
+template <typename A, typename B>
+auto Div(const A& a, const B& b) { return make_binary<DivOp>(a, b); }
+template <typename A, typename B>
+auto Max(const A& a, const B& b) { return make_binary<MaxOp>(a, b); }
+template <typename A, typename B>
+auto Min(const A& a, const B& b) { return make_binary<MinOp>(a, b); }
+
+// Operator sugar; at least one side must already be an expression.
+template <typename A, typename B>
+concept Operands = Expression<A> || Expression<B>;
+
+template <typename A, typename B> requires Operands<A, B>
+auto operator+(const A& a, const B& b) { return Add(a, b); }
+template <typename A, typename B> requires Operands<A, B>
+auto operator-(const A& a, const B& b) { return Sub(a, b); }
+template <typename A, typename B> requires Operands<A, B>
+auto operator*(const A& a, const B& b) { return Mul(a, b); }
+template <typename A, typename B> requires Operands<A, B>
+auto operator/(const A& a, const B& b) { return Div(a, b); }
+
+// ---- barriers ----
+
+template <BarrierType Type>
+struct BarrierKind {};
+
+inline constexpr BarrierKind<BarrierType::up_and_out> UpAndOut{};
+inline constexpr BarrierKind<BarrierType::up_and_in> UpAndIn{};
+inline constexpr BarrierKind<BarrierType::down_and_out> DownAndOut{};
+inline constexpr BarrierKind<BarrierType::down_and_in> DownAndIn{};
+
+// Discretely monitored at the observed dates; use BarrierPayoff when the
+// Brownian-bridge correction for continuous monitoring is needed.
+template <BarrierType Type, Expression E>
+struct BarrierNode {
+  static constexpr bool kUp = Type == BarrierType::up_and_out || Type == BarrierType::up_and_in;
+  static constexpr bool kOut = Type == BarrierType::up_and_out || Type == BarrierType::down_and_out;
+
+  struct State {
+    typename E::State inner;
+    bool touched;
+  };
+  double level;
+  E inner;
+
+  State start(double initial_spot) const {
+    return {inner.start(initial_spot), kUp ? initial_spot >= level : initial_spot <= level};
+  }
+  void observe(State& state, double spot) const {
+    state.touched = state.touched || (kUp ? spot >= level : spot <= level);
+    inner.observe(state.inner, spot);
+  }
+  double value(const State& state) const {
+    return state.touched == kOut ? 0.0 : inner.value(state.inner);
+  }
+};
+
+template <BarrierType Type, typename E>
+BarrierNode<Type, Lifted<E>> Barrier(BarrierKind<Type>, double level, const E& payoff) {
+  return {level, lift(payoff)};
+}
+
+// ---- evaluation ----
+
+// Payoff of a single path given its observations (t_1..t_n).
+template <Expression E>
+double evaluate(const E& expression, double initial_spot, const double* path, std::size_t count) {
+  auto state = expression.start(initial_spot);
+  for (std::size_t k = 0; k < count; ++k) {
+    expression.observe(state, path[k]);
+  }
+  return expression.value(state);
+}
+
+// Terminal-only payoffs, e.g. vanillas on a single-step simulation.
+template <Expression E>
+double evaluate_terminal(const E& expression, double initial_spot, double terminal) {
+  return evaluate(expression, initial_spot, &terminal, 1U);
+}
+
+// Adapts an expression to the path engine. The only virtual calls are per
+// block and grid date; the per-path work is the inlined expression.
+template <Expression E>
+class ExpressionPayoff final : public PathPayoff {
+ public:
+  explicit ExpressionPayoff(E expression) : expression_(std::move(expression)) {}
+
+  std::unique_ptr<PathPayoff> clone() const override { return std::make_unique<ExpressionPayoff>(expression_); }
+
+  void begin(std::size_t size, double initial_spot) override {
+    states_.assign(size, expression_.start(initial_spot));
+  }
+
+  void observe(const PathObservation& observation) override {
+    const double* spot = observation.current;
+    auto* states = states_.data();
+    for (std::size_t i = 0; i < observation.size; ++i) {
+      expression_.observe(states[i], spot[i]);
+    }
+  }
+
+  void settle(double* payoffs, std::size_t size) override {
+    for (std::size_t i = 0; i < size; ++i) {
+      payoffs[i] = expression_.value(states_[i]);
+    }
+  }
+
+ private:
+  E expression_;
+  std::vector<typename E::State> states_;
+};
+
+template <typename E>
+ExpressionPayoff<Lifted<E>> make_path_payoff(const E& expression) {
+  return ExpressionPayoff<Lifted<E>>(lift(expression));
+}
+
+}  // namespace quant::payoff
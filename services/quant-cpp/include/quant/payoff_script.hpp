@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "quant/path_engine.hpp"
+
+namespace quant {
+
+// A small payoff language, compiled once to register bytecode and run over
+// whole path blocks. The script body runs at every grid date:
+//
+//   var total = 0;                        # state, initialised at t = 0
+//   total = total + max(min(S / S_prev - 1, 0.05), -0.05);
+//   if step % 3 == 0 && S >= S0 { pay 100 * (1 + 0.02 * step / 3); stop; }
+//   if is_last { pay 100 * max(total, 0); }
+//
+// Statements: `var x = e;` (top level only), `x = e;`, `if e { } else { }`,
+// `pay e;` (cash flow at the current date) and `stop;` (terminates the path:
+// later statements and dates are skipped). Expressions use + - * / %,
+// comparisons, && || !, `c ? a : b` and min, max, abs, exp, log, sqrt.
+// Builtins: S, S_prev, S0, t, dt, T, step (1-based) and is_last.
+// Statements and expressions nest at most 256 levels deep, and a script uses
+// at most 1024 registers: builtins, constants, variables and temporaries.
+//
+// Conditionals are executed as masks over the block rather than branches,
+// so every instruction is a flat loop over `size` paths.
+enum class ScriptOp : std::uint8_t {
+  add,
+  sub,
+  mul,
+  div,
+  mod,
+  neg,
+  min,
+  max,
+  abs,
+  exp,
+  log,
+  sqrt,
+  lt,
+  le,
+  gt,
+  ge,
+  eq,
+  ne,
+  logical_and,
+  logical_or,
+  logical_not,
+  select,  // dst = a ? b : c
+  assign,  // dst = b where mask a and alive
+  pay,     // cash += b where mask a and alive
+  stop,    // alive = 0 where mask a
+};
+
+struct ScriptInstruction {
+  ScriptOp op;
+  std::uint16_t dst;
+  std::uint16_t a;
+  std::uint16_t b;
+  std::uint16_t c;
+};
+
+struct PayoffProgram {
+  std::vector<ScriptInstruction> init;  // `var` initialisers, run at t = 0
+  std::vector<ScriptInstruction> step;  // run at every grid date
+  std::vector<std::pair<std::uint16_t, double>> constants;
+  std::vector<std::string> variables;   // state registers, in order
+  std::size_t registers = 0;
+};
+
+struct PayoffScriptCompilation {
+  std::shared_ptr<const PayoffProgram> program;  // null on error
+  std::string error;                              // "line N: ..." on error
+};
+
+PayoffScriptCompilation compile_payoff_script(std::string_view source);
+
+// Runs a compiled program as a PathPayoff. Cash flows paid at t are carried
+// to maturity at `rate`, so the engine's single discount factor prices them
+// correctly.
+class ScriptPayoff final : public PathPayoff {
+ public:
+  ScriptPayoff(std::shared_ptr<const PayoffProgram> program, double rate, double maturity);
+
+  std::unique_ptr<PathPayoff> clone() const override;
+  void begin(std::size_t size, double initial_spot) override;
+  void observe(const PathObservation& observation) override;
+  void settle(double* payoffs, std::size_t size) override;
+
+ private:
+  void run(const std::vector<ScriptInstruction>& code, double growth);
+
+  std::shared_ptr<const PayoffProgram> program_;
+  double rate_;
+  double maturity_;
+  std::size_t size_ = 0;
+  std::size_t steps_ = 0;
+  std::vector<double> storage_;      // owned registers, `size_` values each
+  std::vector<double*> registers_;   // S and S_prev alias the observation
+  std::vector<double> cash_;
+};
+
+}  // namespace quant
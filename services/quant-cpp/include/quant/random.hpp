@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace quant {
+
+// xoshiro256** generator keyed by (seed, stream). Each path block draws from
+// its own stream, so blocks can be simulated in any order or in parallel and
+// still reproduce the same numbers for a given seed.
+class RandomStream {
+ public:
+  RandomStream(std::uint64_t seed, std::uint64_t stream);
+
+  std::uint64_t next_u64();
+
+  // Uniform on the open interval (0, 1).
+  double next_uniform();
+
+  // Fills `out` with standard normals (Box-Muller, two per uniform pair).
+  void fill_normals(double* out, std::size_t count);
+
+ private:
+  std::uint64_t state_[4];
+};
+
+}  // namespace quant
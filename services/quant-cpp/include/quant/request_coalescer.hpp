@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "quant/result_cache.hpp"
+#include "quant/task_pool.hpp"
+
+namespace quant {
+
+struct RequestCoalescerStats {
+  std::uint64_t leaders;    // computations actually run
+  std::uint64_t followers;  // requests served by another request's computation
+  std::uint64_t in_flight;
+};
+
+// Single-flight execution: concurrent calls with the same key share one
+// computation. The first caller runs `compute`; callers that arrive while it
+// is running wait for its result instead of starting their own. A follower
+// on a TaskPool worker waits on a TaskEvent, running forked work (often the
+// leader's own) rather than blocking its core. The flight
+// ends as soon as the result is ready, so later calls compute again (pair
+// with ResultCache to keep results around). Exceptions from `compute` are
+// rethrown to every caller of that flight.
+class RequestCoalescer {
+ public:
+  std::string run(const CacheKey& key, const std::function<std::string()>& compute);
+
+  RequestCoalescerStats stats() const;
+
+ private:
+  struct Flight {
+    TaskEvent done;
+    std::string result;
+    std::exception_ptr error;
+  };
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+  std::uint64_t leaders_ = 0;
+  std::uint64_t followers_ = 0;
+};
+
+}  // namespace quant
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace quant {
+
+// Canonical byte encoding of a request. Fields are appended in a fixed order
+// with fixed widths, -0.0 is folded into 0.0 and every NaN into one bit
+// pattern, so two requests that price the same thing produce the same key
+// regardless of how their wire encoding happened to look. Start each key with
+// a tag naming the computation and its version, so results from an older
+// algorithm are never served after an upgrade.
+class CacheKey {
+ public:
+  explicit CacheKey(std::string_view tag);
+
+  CacheKey& add(double value);
+  CacheKey& add(std::uint64_t value);
+  CacheKey& add(bool value);
+  CacheKey& add(std::string_view value);
+
+  const std::string& bytes() const { return bytes_; }
+
+ private:
+  void append(std::uint64_t value);
+
+  std::string bytes_;
+};
+
+struct ResultCacheConfig {
+  std::size_t memory_budget = 64U << 20U;
+  // When set, entries are also written to this memory-mapped file and
+  // reloaded on construction. Empty keeps the cache in memory only.
+  std::string persist_path{};
+  // Size of the backing file; 0 uses twice the memory budget.
+  std::size_t persist_bytes = 0;
+};
+
+struct ResultCacheStats {
+  std::uint64_t hits;
+  std::uint64_t misses;
+  std::uint64_t insertions;
+  std::uint64_t evictions;
+  std::uint64_t entries;
+  std::uint64_t bytes;
+  std::uint64_t persisted_bytes;
+};
+
+// LRU cache of serialized results for deterministic computations. Lookups
+// compare the full canonical key, so a hash collision can never return the
+// wrong result. The memory budget covers keys, values and a fixed per-entry
+// overhead; values larger than the budget are not cached.
+//
+// The backing file is an append-only log of checksummed records. Appends
+// that do not fit trigger a compaction that rewrites the live entries, and a
+// torn or corrupt tail is dropped when the file is reloaded.
+class ResultCache {
+ public:
+  explicit ResultCache(ResultCacheConfig config = {});
+  ~ResultCache();
+
+  ResultCache(const ResultCache&) = delete;
+  ResultCache& operator=(const ResultCache&) = delete;
+
+  std::optional<std::string> find(const CacheKey& key);
+
+  void insert(const CacheKey& key, std::string value);
+
+  ResultCacheStats stats() const;
+
+  bool persistent() const { return mapping_ != nullptr; }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::string value;
+  };
+  using Lru = std::list<Entry>;
+
+  void store(std::string key, std::string value, bool persist);
+  void evict_to_budget();
+  void open_backing_file(const std::string& path, std::size_t size);
+  void load_records();
+  bool append_record(const Entry& entry);
+  void compact();
+
+  std::size_t memory_budget_;
+  mutable std::mutex mutex_;
+  Lru lru_;  // most recently used first
+  std::unordered_map<std::string_view, Lru::iterator> index_;
+  std::size_t bytes_ = 0;
+  std::uint64_t hits_ = 0;
+  std::uint64_t misses_ = 0;
+  std::uint64_t insertions_ = 0;
+  std::uint64_t evictions_ = 0;
+
+  int fd_ = -1;
+  unsigned char* mapping_ = nullptr;
+  std::size_t mapping_size_ = 0;
+  std::size_t mapping_used_ = 0;
+};
+
+}  // namespace quant
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include "quant/task_pool.hpp"
+
+namespace quant {
+
+enum class WorkloadClass : std::uint8_t { analytic, heavy };
+
+inline constexpr std::size_t kWorkloadClasses = 2;
+
+struct WorkloadClassConfig {
+  // Most tasks of this class running at once.
+  std::size_t concurrency;
+  // Idle workers serve the highest-priority class with queued work.
+  int priority;
+  // Reject new work once its predicted queueing delay exceeds this.
+  std::chrono::milliseconds latency_budget;
+  // Seed for the running estimate of a task's service time.
+  std::chrono::microseconds expected_service_time;
+};
+
+struct SchedulerConfig {
+  WorkloadClassConfig analytic{
+    .concurrency = 4,
+    .priority = 1,
+    .latency_budget = std::chrono::milliseconds(50),
+    .expected_service_time = std::chrono::microseconds(100),
+  };
+  WorkloadClassConfig heavy{
+    .concurrency = 2,
+    .priority = 0,
+    .latency_budget = std::chrono::milliseconds(60'000),
+    .expected_service_time = std::chrono::microseconds(2'000'000),
+  };
+  // Tasks of all classes running at once; 0 means the sum of the class
+  // concurrency limits. With fewer, priority decides who waits.
+  std::size_t max_running = 0;
+};
+
+struct Admission {
+  bool admitted;
+  // When rejected: how long until the queue is predicted to be back within
+  // its latency budget.
+  std::chrono::milliseconds retry_after;
+};
+
+struct WorkloadStats {
+  std::uint64_t admitted;
+  std::uint64_t rejected;
+  std::uint64_t completed;
+  std::uint64_t queued;
+  std::uint64_t running;
+  double service_time_us;  // running estimate
+};
+
+// Runs tasks from separate per-class queues on a TaskPool. Each
+// class has a concurrency limit, so a burst of heavy work can never take
+// every worker, and a priority that orders classes when several have queued
+// work. Admission control predicts a new task's queueing delay from the
+// queue length, the concurrency limit and a moving average of service times,
+// and rejects work that would exceed the class's latency budget rather than
+// letting queues grow without bound. Tasks must not throw; they may fork
+// work into the same pool. The destructor waits for every admitted task.
+class WorkloadScheduler {
+ public:
+  explicit WorkloadScheduler(SchedulerConfig config = {}, TaskPool& pool = TaskPool::shared());
+  ~WorkloadScheduler();
+
+  WorkloadScheduler(const WorkloadScheduler&) = delete;
+  WorkloadScheduler& operator=(const WorkloadScheduler&) = delete;
+
+  Admission submit(WorkloadClass workload, std::function<void()> task);
+
+  WorkloadStats stats(WorkloadClass workload) const;
+
+ private:
+  struct Lane {
+    WorkloadClassConfig config;
+    std::deque<std::function<void()>> queue;
+    std::size_t running = 0;
+    double service_time_us = 0.0;
+    std::uint64_t admitted = 0;
+    std::uint64_t rejected = 0;
+    std::uint64_t completed = 0;
+  };
+
+  // Starts queued tasks while slots are free. Called with mutex_ held.
+  void dispatch();
+  void finish(Lane& lane, double elapsed_us);
+  Lane* next_lane();
+
+  TaskPool& pool_;
+  std::size_t max_running_ = 0;
+  mutable std::mutex mutex_;
+  std::condition_variable drained_;
+  std::array<Lane, kWorkloadClasses> lanes_;
+  std::array<std::size_t, kWorkloadClasses> by_priority_{};
+  std::size_t running_ = 0;
+};
+
+}  // namespace quant
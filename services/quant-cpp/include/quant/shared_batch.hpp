@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace quant {
+
+// Shared-memory transport for batch pricing between processes on one host.
+// A client creates a region, places structure-of-arrays input columns in it
+// and hands the server only byte offsets; the server runs the batch kernels
+// on the mapped columns and writes the outputs in place. Neither side
+// serializes or copies a column, apart from the one-byte is_call flags,
+// which the server converts to bools so a stray byte cannot reach the kernel
+// as an invalid bool.
+
+// Object names must start with this prefix and contain no other '/'.
+inline constexpr const char* kSharedRegionPrefix = "/crucible-quant.";
+
+// Column offsets are relative to the column space after this header, which
+// identifies the region and its layout version.
+inline constexpr std::size_t kSharedRegionHeaderBytes = 64;
+
+// A mapped POSIX shared-memory object. The creator unlinks it on
+// destruction; an opener only unmaps. The transport assumes co-located,
+// trusted clients: a client that truncates its object while the server is
+// using it can still fault the server.
+class SharedRegion {
+ public:
+  // Creates a new object with `capacity` bytes of column space. Returns null
+  // and sets `error` if the name is invalid or taken, or mapping fails.
+  static std::unique_ptr<SharedRegion> create(
+    const std::string& name, std::size_t capacity, std::string* error = nullptr);
+
+  // Maps an existing object and checks its header.
+  static std::unique_ptr<SharedRegion> open(const std::string& name, std::string* error = nullptr);
+
+  ~SharedRegion();
+
+  SharedRegion(const SharedRegion&) = delete;
+  SharedRegion& operator=(const SharedRegion&) = delete;
+
+  const std::string& name() const { return name_; }
+  std::size_t capacity() const { return capacity_; }
+  unsigned char* columns() { return mapping_ + kSharedRegionHeaderBytes; }
+
+  template <typename T>
+  T* at(std::uint64_t offset) {
+    return reinterpret_cast<T*>(columns() + offset);
+  }
+
+ private:
+  SharedRegion(std::string name, unsigned char* mapping, std::size_t mapping_size, bool owner);
+
+  std::string name_;
+  unsigned char* mapping_;
+  std::size_t mapping_size_;
+  std::size_t capacity_;
+  bool owner_;
+};
+
+// Client-side first-in first-out allocator of a region's column space, for
+// streaming batches through it: allocate a batch's columns, send it, read
+// its outputs, release it. Allocations are 64-byte aligned. Not thread-safe.
+class SharedRing {
+ public:
+  explicit SharedRing(std::size_t capacity) : capacity_(capacity) {}
+
+  // Offset of `bytes` contiguous bytes, or nullopt until older allocations
+  // are released.
+  std::optional<std::uint64_t> allocate(std::size_t bytes);
+
+  // Releases the oldest allocation still held.
+  void release();
+
+  std::size_t in_use() const { return in_use_; }
+
+ private:
+  std::size_t capacity_;
+  std::size_t head_ = 0;  // next free byte
+  std::size_t in_use_ = 0;
+  std::deque<std::pair<std::size_t, std::size_t>> live_;  // [start, end), oldest first
+};
+
+enum class SharedBatchKind : std::uint8_t { price, greeks, implied_volatility };
+
+// Column offsets of one batch, as carried by SharedBatchRequest. Doubles are
+// 8-byte aligned and iterations 4-byte aligned; is_call and converged take
+// one byte per option. Columns a kind does not use are ignored.
+struct SharedBatch {
+  SharedBatchKind kind;
+  std::uint64_t count;
+  std::uint64_t spot;
+  std::uint64_t strike;
+  std::uint64_t rate;
+  std::uint64_t volatility;
+  std::uint64_t time_to_maturity;
+  std::optional<std::uint64_t> dividend_yield;
+  std::uint64_t is_call;
+  std::uint64_t target_price;
+  std::uint64_t price;
+  std::uint64_t delta;
+  std::uint64_t gamma;
+  std::uint64_t vega;
+  std::uint64_t theta;
+  std::uint64_t rho;
+  std::uint64_t implied_volatility;
+  std::uint64_t converged;
+  std::uint64_t iterations;
+};
+
+// Runs `batch` on the region's columns. Returns an empty message on success,
+// or which column is out of bounds or misaligned.
+std::string run_shared_batch(SharedRegion& region, const SharedBatch& batch);
+
+}  // namespace quant
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "quant/scheduler.hpp"
+
+namespace quant {
+
+// Coroutines for request pipelines. A Task<T> is a lazily started coroutine
+// producing a T: it runs when awaited, and the awaiting coroutine resumes
+// directly when it finishes, without a trip through any queue. Exceptions
+// propagate to the awaiter. Tasks suspend only at scheduled() below or at
+// the async server's completion-queue events, so a call such as
+//
+//   const Admission admission = co_await scheduled(scheduler, WorkloadClass::heavy);
+//   co_return admission.admitted ? price(request) : reject(admission);
+//
+// holds no thread while it waits, and thousands can be in flight on a
+// handful of workers. Work inside a stage forks with parallel_for as usual.
+
+template <typename T = void>
+class Task;
+
+template <typename T>
+struct TaskPromiseBase {
+  std::coroutine_handle<> continuation;
+  std::exception_ptr failure;
+
+  struct FinalAwaiter {
+    bool await_ready() noexcept { return false; }
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> done) noexcept {
+      const std::coroutine_handle<> next = done.promise().continuation;
+      return next ? next : std::noop_coroutine();
+    }
+    void await_resume() noexcept {}
+  };
+
+  Task<T> get_return_object() noexcept;
+  std::suspend_always initial_suspend() noexcept { return {}; }
+  FinalAwaiter final_suspend() noexcept { return {}; }
+  void unhandled_exception() noexcept { failure = std::current_exception(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase<T> {
+  std::optional<T> value;
+
+  template <typename U>
+  void return_value(U&& result) {
+    value.emplace(std::forward<U>(result));
+  }
+  T take() {
+    if (this->failure) {
+      std::rethrow_exception(this->failure);
+    }
+    return std::move(*value);
+  }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase<void> {
+  void return_void() noexcept {}
+  void take() {
+    if (failure) {
+      std::rethrow_exception(failure);
+    }
+  }
+};
+
+template <typename T>
+class [[nodiscard]] Task {
+ public:
+  using promise_type = TaskPromise<T>;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  explicit Task(Handle handle) noexcept : handle_(handle) {}
+  Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      if (handle_) {
+        handle_.destroy();
+      }
+      handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  ~Task() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      Handle handle;
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+      T await_resume() { return handle.promise().take(); }
+    };
+    return Awaiter{handle_};
+  }
+
+ private:
+  Handle handle_;
+};
+
+template <typename T>
+Task<T> TaskPromiseBase<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(static_cast<TaskPromise<T>&>(*this)));
+}
+
+// Coroutine with no result and no owner, for spawn and sync_wait. Its frame
+// frees itself when the body finishes.
+struct DetachedCoroutine {
+  struct promise_type {
+    DetachedCoroutine get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+inline DetachedCoroutine run_detached(Task<void> task) {
+  co_await std::move(task);
+}
+
+// Starts `task` on this thread and lets it finish wherever its awaits leave
+// it. The task must not throw.
+inline void spawn(Task<void> task) {
+  run_detached(std::move(task));
+}
+
+template <typename T>
+struct SyncWaitState {
+  std::mutex mutex;
+  std::condition_variable finished;
+  bool done = false;
+  std::exception_ptr failure;
+  std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> result;
+};
+
+template <typename T>
+DetachedCoroutine run_and_signal(Task<T> task, SyncWaitState<T>& state) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(task);
+      state.result.emplace(true);
+    } else {
+      state.result.emplace(co_await std::move(task));
+    }
+  } catch (...) {
+    state.failure = std::current_exception();
+  }
+  // Notified under the lock: the waiter's state dies once it reacquires it.
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.done = true;
+  state.finished.notify_one();
+}
+
+// Runs `task` and blocks this thread until it finishes. For tests and for
+// callers outside any pipeline; never call it from a TaskPool worker.
+template <typename T>
+T sync_wait(Task<T> task) {
+  SyncWaitState<T> state;
+  run_and_signal(std::move(task), state);
+  std::unique_lock<std::mutex> lock(state.mutex);
+  state.finished.wait(lock, [&state] { return state.done; });
+  if (state.failure) {
+    std::rethrow_exception(state.failure);
+  }
+  if constexpr (!std::is_void_v<T>) {
+    return std::move(*state.result);
+  }
+}
+
+// Queues the rest of the coroutine on `scheduler` under `workload` and
+// returns the admission decision. A rejected coroutine continues at once on
+// the awaiting thread; an admitted one resumes on the scheduler's pool and
+// holds its slot until it next suspends or finishes.
+inline auto scheduled(WorkloadScheduler& scheduler, WorkloadClass workload) {
+  struct Awaiter {
+    WorkloadScheduler& scheduler;
+    WorkloadClass workload;
+    Admission admission;
+
+    bool await_ready() noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> awaiting) {
+      // Once admitted, the coroutine may resume elsewhere before submit
+      // returns, so only the resuming task writes the decision.
+      const Admission decision = scheduler.submit(workload, [this, awaiting] {
+        admission = Admission{.admitted = true, .retry_after = {}};
+        awaiting.resume();
+      });
+      if (decision.admitted) {
+        return true;
+      }
+      admission = decision;
+      return false;
+    }
+    Admission await_resume() const noexcept { return admission; }
+  };
+  return Awaiter{scheduler, workload, Admission{.admitted = false, .retry_after = {}}};
+}
+
+}  // namespace quant
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace quant {
+
+class TaskEvent;
+class TaskGroup;
+
+// A fixed set of worker threads with one task deque each. Tasks forked by a
+// worker go on its own deque, which it drains newest-first while idle
+// workers steal the oldest entries, so a fork-join tree spreads across the
+// cores with little contention. A worker joining a TaskGroup runs other
+// queued fork-join work instead of blocking, which makes nested parallelism
+// safe at any depth without extra threads. Threads that are not workers
+// block on joins, so the process computes on exactly `size()` threads no
+// matter how many callers fan out at once.
+//
+// Top-level work from outside the pool (`submit`) waits in a shared queue
+// and is only started by idle workers, never by one helping a join. Tasks
+// should not block on anything but a TaskGroup or TaskEvent: a blocked
+// worker is a core taken from every other caller.
+class TaskPool {
+ public:
+  // 0 threads means one per hardware thread.
+  explicit TaskPool(std::size_t threads = 0);
+  ~TaskPool();
+
+  TaskPool(const TaskPool&) = delete;
+  TaskPool& operator=(const TaskPool&) = delete;
+
+  std::size_t size() const { return workers_.size(); }
+
+  // Queues a top-level task. Tasks must not throw.
+  void submit(std::function<void()> task);
+
+  // The process-wide pool used by parallel_for and the async server, created
+  // on first use.
+  static TaskPool& shared();
+
+  // Sets the shared pool's thread count (0 = one per hardware thread).
+  // Returns false once the shared pool exists.
+  static bool configure_shared(std::size_t threads);
+
+ private:
+  friend class TaskEvent;
+  friend class TaskGroup;
+
+  struct Worker {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+    std::thread thread;
+  };
+
+  // This thread's worker if it belongs to this pool, else null.
+  Worker* local_worker() const;
+
+  void fork(std::function<void()> task);
+  void join(const std::atomic<std::size_t>& pending);
+  void joined();
+
+  bool run_one(Worker* self, bool include_submitted);
+  bool steal(Worker* self, std::function<void()>& task);
+  void work(Worker* self);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // Tasks sitting in worker deques, for wake-up decisions.
+  std::atomic<std::size_t> forked_{0};
+  std::atomic<std::size_t> sleepers_{0};
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::deque<std::function<void()>> submitted_;
+  bool stopping_ = false;
+};
+
+// Tasks forked together and joined as one. `wait` returns once every task
+// has run and rethrows the first exception any of them threw. Must be
+// waited on before destruction.
+class TaskGroup {
+ public:
+  explicit TaskGroup(TaskPool& pool = TaskPool::shared()) : pool_(pool) {}
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  void run(std::function<void()> task);
+  void wait();
+
+ private:
+  TaskPool& pool_;
+  std::atomic<std::size_t> pending_{0};
+  std::mutex failure_mutex_;
+  std::exception_ptr failure_;
+};
+
+// A one-shot signal for work that finishes elsewhere. A worker waiting on it
+// runs other fork-join work until it is set, as when joining a TaskGroup;
+// other threads block.
+class TaskEvent {
+ public:
+  explicit TaskEvent(TaskPool& pool = TaskPool::shared()) : pool_(pool) {}
+
+  TaskEvent(const TaskEvent&) = delete;
+  TaskEvent& operator=(const TaskEvent&) = delete;
+
+  void set();
+  void wait() const;
+
+ private:
+  TaskPool& pool_;
+  std::atomic<std::size_t> pending_{1};
+};
+
+}  // namespace quant
@@ -0,0 +1,69 @@
+#include "quant/aad.hpp"
+
+namespace quant::aad {
+
+namespace {
+
+thread_local Tape* current_tape = nullptr;
+
+}  // namespace
+
+std::uint32_t Tape::variable() {
+  nodes_.push_back(Node{.arg = {kNone, kNone}, .partial = {0.0, 0.0}});
+  adjoints_.push_back(0.0);
+  return static_cast<std::uint32_t>(nodes_.size() - 1U);
+}
+
+std::uint32_t Tape::record(std::uint32_t a, double da) {
+  nodes_.push_back(Node{.arg = {a, kNone}, .partial = {da, 0.0}});
+  adjoints_.push_back(0.0);
+  return static_cast<std::uint32_t>(nodes_.size() - 1U);
+}
+
+std::uint32_t Tape::record(std::uint32_t a, double da, std::uint32_t b, double db) {
+  nodes_.push_back(Node{.arg = {a, b}, .partial = {da, db}});
+  adjoints_.push_back(0.0);
+  return static_cast<std::uint32_t>(nodes_.size() - 1U);
+}
+
+void Tape::propagate(std::size_t mark) {
+  for (std::size_t i = nodes_.size(); i-- > mark;) {
+    const double adj = adjoints_[i];
+    if (adj == 0.0) {
+      continue;
+    }
+    const Node& node = nodes_[i];
+    if (node.arg[0] != kNone) {
+      adjoints_[node.arg[0]] += node.partial[0] * adj;
+    }
+    if (node.arg[1] != kNone) {
+      adjoints_[node.arg[1]] += node.partial[1] * adj;
+    }
+  }
+}
+
+void Tape::rewind(std::size_t mark) {
+  if (mark < nodes_.size()) {
+    nodes_.resize(mark);
+    adjoints_.resize(mark);
+  }
+}
+
+void Tape::clear() {
+  nodes_.clear();
+  adjoints_.clear();
+}
+
+Tape* active_tape() {
+  return current_tape;
+}
+
+TapeScope::TapeScope(Tape& tape) : previous_(current_tape) {
+  current_tape = &tape;
+}
+
+TapeScope::~TapeScope() {
+  current_tape = previous_;
+}
+
+}  // namespace quant::aad
@@ -0,0 +1,293 @@
+#include "quant/adjoint.hpp"
+
+#include <random>
+
+namespace quant {
+
+namespace {
+
+using aad::Real;
+
+struct OptionInputs {
+  Real spot;
+  Real strike;
+  Real rate;
+  Real volatility;
+  Real maturity;
+  Real dividend;
+};
+
+OptionInputs register_inputs(const OptionInput& option) {
+  return OptionInputs{
+    .spot = Real::input(option.spot),
+    .strike = Real::input(option.strike),
+    .rate = Real::input(option.rate),
+    .volatility = Real::input(option.volatility),
+    .maturity = Real::input(option.time_to_maturity),
+    .dividend = Real::input(option.dividend_yield),
+  };
+}
+
+AdjointGreeks read_adjoints(const aad::Tape& tape, const OptionInputs& in, double price) {
+  return AdjointGreeks{
+    .price = price,
+    .standard_error = 0.0,
+    .d_spot = tape.adjoint(in.spot.index()),
+    .d_strike = tape.adjoint(in.strike.index()),
+    .d_rate = tape.adjoint(in.rate.index()),
+    .d_volatility = tape.adjoint(in.volatility.index()),
+    .d_maturity = tape.adjoint(in.maturity.index()),
+    .d_dividend = tape.adjoint(in.dividend.index()),
+    .paths = 0U,
+  };
+}
+
+Real vanilla(const Real& underlying, const Real& strike, bool is_call) {
+  return is_call ? aad::max(underlying - strike, 0.0) : aad::max(strike - underlying, 0.0);
+}
+
+// Cholesky on the tape; false if the matrix is not positive definite.
+bool taped_cholesky(const std::vector<Real>& c, std::size_t n, std::vector<Real>& l) {
+  l.assign(n * n, Real(0.0));
+  for (std::size_t j = 0; j < n; ++j) {
+    Real diag = c[j * n + j];
+    for (std::size_t k = 0; k < j; ++k) {
+      diag -= l[j * n + k] * l[j * n + k];
+    }
+    if (diag.value() <= 1e-12) {
+      return false;
+    }
+    const Real l_jj = aad::sqrt(diag);
+    l[j * n + j] = l_jj;
+    for (std::size_t i = j + 1; i < n; ++i) {
+      Real value = c[i * n + j];
+      for (std::size_t k = 0; k < j; ++k) {
+        value -= l[i * n + k] * l[j * n + k];
+      }
+      l[i * n + j] = value / l_jj;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+AdjointGreeks black_scholes_adjoint(const OptionInput& option) {
+  aad::Tape tape;
+  aad::TapeScope scope(tape);
+  const OptionInputs in = register_inputs(option);
+
+  const Real sqrt_t = aad::sqrt(in.maturity);
+  const Real sigma_sqrt_t = in.volatility * sqrt_t;
+  const Real forward_spot = in.spot * aad::exp(-in.dividend * in.maturity);
+  const Real discounted_strike = in.strike * aad::exp(-in.rate * in.maturity);
+  const Real d1 = (aad::log(in.spot / in.strike)
+                   + (in.rate - in.dividend + 0.5 * in.volatility * in.volatility) * in.maturity)
+                  / sigma_sqrt_t;
+  const Real d2 = d1 - sigma_sqrt_t;
+  const Real price = option.is_call
+    ? forward_spot * aad::normal_cdf(d1) - discounted_strike * aad::normal_cdf(d2)
+    : discounted_strike * aad::normal_cdf(-d2) - forward_spot * aad::normal_cdf(-d1);
+
+  tape.adjoint(price.index()) = 1.0;
+  tape.propagate();
+  return read_adjoints(tape, in, price.value());
+}
+
+AdjointGreeks monte_carlo_adjoint(const OptionInput& option, std::uint32_t paths, std::uint32_t seed) {
+  if (paths == 0U) {
+    return AdjointGreeks{};
+  }
+
+  std::mt19937 rng(seed);
+  std::normal_distribution<double> standard_normal(0.0, 1.0);
+
+  aad::Tape tape;
+  aad::TapeScope scope(tape);
+  const OptionInputs in = register_inputs(option);
+  const Real drift = (in.rate - in.dividend - 0.5 * in.volatility * in.volatility) * in.maturity;
+  const Real diffusion = in.volatility * aad::sqrt(in.maturity);
+  const Real discount = aad::exp(-in.rate * in.maturity);
+  const std::size_t mark = tape.size();
+
+  const double scale = discount.value() / static_cast<double>(paths);
+  RunningStats stats;
+  for (std::uint32_t i = 0; i < paths; ++i) {
+    const double z = standard_normal(rng);
+    const Real terminal = in.spot * aad::exp(drift + diffusion * z);
+    const Real payoff = vanilla(terminal, in.strike, option.is_call);
+    stats.add(payoff.value());
+    if (payoff.active()) {
+      tape.adjoint(payoff.index()) += scale;
+      tape.propagate(mark);
+    }
+    tape.rewind(mark);
+  }
+
+  tape.adjoint(discount.index()) += stats.mean;
+  tape.propagate();
+  AdjointGreeks greeks = read_adjoints(tape, in, discount.value() * stats.mean);
+  greeks.standard_error = discount.value() * stats.standard_error();
+  greeks.paths = stats.count;
+  return greeks;
+}
+
+MultiAssetAdjointGreeks multi_asset_adjoint(
+  const MultiAssetInput& input,
+  const MultiAssetPayoff& payoff,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  std::size_t block_paths) {
+  const std::size_t n = input.spots.size();
+  const bool consistent = n > 0U
+    && input.volatilities.size() == n
+    && (input.dividend_yields.empty() || input.dividend_yields.size() == n)
+    && (payoff.type != MultiAssetPayoffType::spread || n >= 2U)
+    && validate_correlation(input.correlation, n).empty();
+  if (paths == 0U || !consistent) {
+    return MultiAssetAdjointGreeks{};
+  }
+
+  const std::vector<double> weights = payoff.weights.size() == n
+    ? payoff.weights
+    : std::vector<double>(n, payoff.type == MultiAssetPayoffType::basket ? 1.0 / static_cast<double>(n) : 1.0);
+  // Singular matrices go through the (untaped) eigen factor; correlation
+  // sensitivities are then not reported.
+  const CorrelationFactor fallback = factor_correlation(input.correlation, n);
+  const bool taped_correlation = fallback.cholesky;
+
+  // Input layout: spots, vols, dividends, correlation, rate, maturity.
+  const std::size_t corr_offset = 3U * n;
+  const std::size_t inputs = corr_offset + n * n + 2U;
+  const std::uint64_t block = std::max<std::size_t>(block_paths, 1U);
+  const std::size_t blocks = static_cast<std::size_t>((paths + block - 1U) / block);
+  const double scale = 1.0 / static_cast<double>(paths);
+  std::vector<RunningStats> block_stats(blocks);
+  std::vector<double> block_adjoints(blocks * inputs, 0.0);
+
+  parallel_for(blocks, [&](std::size_t b) {
+    const auto size = static_cast<std::size_t>(std::min(block, paths - b * block));
+    RandomStream rng(seed, b);
+    std::vector<double> normals(n * size);
+    rng.fill_normals(normals.data(), normals.size());
+
+    aad::Tape tape;
+    aad::TapeScope scope(tape);
+    std::vector<Real> in(inputs);
+    for (std::size_t i = 0; i < n; ++i) {
+      in[i] = Real::input(input.spots[i]);
+      in[n + i] = Real::input(input.volatilities[i]);
+      in[2U * n + i] = Real::input(input.dividend_yields.empty() ? 0.0 : input.dividend_yields[i]);
+    }
+    for (std::size_t k = 0; k < n * n; ++k) {
+      in[corr_offset + k] = Real::input(input.correlation[k]);
+    }
+    in[inputs - 2U] = Real::input(input.rate);
+    in[inputs - 1U] = Real::input(input.time_to_maturity);
+    const Real& rate = in[inputs - 2U];
+    const Real& maturity = in[inputs - 1U];
+
+    std::vector<Real> factor;
+    if (taped_correlation) {
+      const std::vector<Real> correlation(in.begin() + static_cast<std::ptrdiff_t>(corr_offset),
+                                          in.begin() + static_cast<std::ptrdiff_t>(corr_offset + n * n));
+      taped_cholesky(correlation, n, factor);
+    } else {
+      factor.assign(fallback.matrix.begin(), fallback.matrix.end());
+    }
+    std::vector<Real> drift(n);
+    std::vector<Real> diffusion(n);
+    const Real sqrt_t = aad::sqrt(maturity);
+    for (std::size_t i = 0; i < n; ++i) {
+      const Real& sigma = in[n + i];
+      drift[i] = (rate - in[2U * n + i] - 0.5 * sigma * sigma) * maturity;
+      diffusion[i] = sigma * sqrt_t;
+    }
+    const Real discount = aad::exp(-rate * maturity);
+    const std::size_t mark = tape.size();
+
+    std::vector<Real> terminal(n);
+    double payoff_sum = 0.0;
+    for (std::size_t p = 0; p < size; ++p) {
+      for (std::size_t i = 0; i < n; ++i) {
+        Real x(0.0);
+        const std::size_t columns = taped_correlation ? i + 1U : n;
+        for (std::size_t k = 0; k < columns; ++k) {
+          x += factor[i * n + k] * normals[k * size + p];
+        }
+        terminal[i] = weights[i] * in[i] * aad::exp(drift[i] + diffusion[i] * x);
+      }
+
+      Real underlying = terminal[0];
+      switch (payoff.type) {
+        case MultiAssetPayoffType::basket:
+          for (std::size_t i = 1; i < n; ++i) {
+            underlying += terminal[i];
+          }
+          break;
+        case MultiAssetPayoffType::best_of:
+          for (std::size_t i = 1; i < n; ++i) {
+            underlying = aad::max(underlying, terminal[i]);
+          }
+          break;
+        case MultiAssetPayoffType::worst_of:
+          for (std::size_t i = 1; i < n; ++i) {
+            underlying = aad::min(underlying, terminal[i]);
+          }
+          break;
+        case MultiAssetPayoffType::spread:
+          underlying = terminal[0] - terminal[1];
+          break;
+      }
+      const Real value = vanilla(underlying, payoff.strike, payoff.is_call);
+      block_stats[b].add(value.value());
+      payoff_sum += value.value();
+      if (value.active()) {
+        tape.adjoint(value.index()) += discount.value() * scale;
+        tape.propagate(mark);
+      }
+      tape.rewind(mark);
+    }
+
+    tape.adjoint(discount.index()) += payoff_sum * scale;
+    tape.propagate();
+    for (std::size_t j = 0; j < inputs; ++j) {
+      block_adjoints[b * inputs + j] = tape.adjoint(in[j].index());
+    }
+  });
+
+  RunningStats stats;
+  std::vector<double> totals(inputs, 0.0);
+  for (std::size_t b = 0; b < blocks; ++b) {
+    stats.merge(block_stats[b]);
+    for (std::size_t j = 0; j < inputs; ++j) {
+      totals[j] += block_adjoints[b * inputs + j];
+    }
+  }
+
+  MultiAssetAdjointGreeks greeks;
+  const double discount = std::exp(-input.rate * input.time_to_maturity);
+  greeks.price = discount * stats.mean;
+  greeks.standard_error = discount * stats.standard_error();
+  greeks.d_spots.assign(totals.begin(), totals.begin() + static_cast<std::ptrdiff_t>(n));
+  greeks.d_volatilities.assign(totals.begin() + static_cast<std::ptrdiff_t>(n),
+                               totals.begin() + static_cast<std::ptrdiff_t>(2U * n));
+  greeks.d_dividends.assign(totals.begin() + static_cast<std::ptrdiff_t>(2U * n),
+                            totals.begin() + static_cast<std::ptrdiff_t>(3U * n));
+  if (taped_correlation) {
+    // Cholesky reads the lower triangle; report symmetric pair sensitivities.
+    greeks.d_correlation.assign(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t j = 0; j < n; ++j) {
+        const double both = totals[corr_offset + i * n + j] + (i == j ? 0.0 : totals[corr_offset + j * n + i]);
+        greeks.d_correlation[i * n + j] = both;
+      }
+    }
+  }
+  greeks.d_rate = totals[inputs - 2U];
+  greeks.d_maturity = totals[inputs - 1U];
+  greeks.paths = stats.count;
+  return greeks;
+}
+
+}  // namespace quant
@@ -0,0 +1,532 @@
+#include "quant/async_server.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <google/protobuf/arena.h>
+#include <grpcpp/alarm.h>
+
+#include "quant/batch_messages.hpp"
+#include "quant/handler_status.hpp"
+#include "quant/task.hpp"
+
+namespace quant {
+
+namespace {
+
+using crucible::quant::QuantService;
+using AsyncService = QuantService::AsyncService;
+
+constexpr auto kWatchPollInterval = std::chrono::milliseconds(50);
+constexpr auto kShutdownGrace = std::chrono::seconds(5);
+
+// Completion-queue tag: every event is routed to the call that requested it.
+class Call {
+ public:
+  virtual ~Call() = default;
+  virtual void proceed(bool ok) = 0;
+};
+
+struct Dispatch {
+  AsyncService* service;
+  QuantGrpcService* handlers;
+  grpc::ServerCompletionQueue* queue;
+  WorkloadScheduler* scheduler;
+};
+
+template <typename Request, typename Response>
+using UnaryRequest = void (AsyncService::*)(
+  grpc::ServerContext*,
+  Request*,
+  grpc::ServerAsyncResponseWriter<Response>*,
+  grpc::CompletionQueue*,
+  grpc::ServerCompletionQueue*,
+  void*);
+
+template <typename Request, typename Response>
+using UnaryHandler = grpc::Status (QuantGrpcService::*)(grpc::ServerContext*, const Request*, Response*);
+
+// Where a unary handler runs: on the handler thread, or queued on the
+// scheduler under a workload class.
+enum class Placement { inline_call, analytic, heavy };
+
+// A completion-queue event awaited by a coroutine. `start` issues the gRPC
+// operation with this event as its tag; the coroutine resumes on the handler
+// thread that dequeues it and receives the event's ok flag.
+template <typename Start>
+class QueueEvent final : public Call {
+ public:
+  explicit QueueEvent(Start start) : start_(std::move(start)) {}
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> awaiting) {
+    awaiting_ = awaiting;
+    // The event may complete on another thread before start_ returns.
+    start_(static_cast<Call*>(this));
+  }
+  bool await_resume() const noexcept { return ok_; }
+
+  void proceed(bool ok) override {
+    ok_ = ok;
+    awaiting_.resume();
+  }
+
+ private:
+  Start start_;
+  std::coroutine_handle<> awaiting_;
+  bool ok_ = false;
+};
+
+template <typename Start>
+QueueEvent<Start> queue_event(Start start) {
+  return QueueEvent<Start>(std::move(start));
+}
+
+template <typename Request>
+constexpr bool kArenaMessages = std::is_same_v<Request, crucible::quant::PriceBatchRequest> ||
+                                std::is_same_v<Request, crucible::quant::ImpliedVolBatchRequest>;
+
+// One unary call, from request to reply. Once the request arrives it
+// re-arms a listener for the next call, then runs the handler inline or
+// through the scheduler; a handler that throws answers INTERNAL. Work the
+// scheduler will not admit fails fast with RESOURCE_EXHAUSTED and a
+// grpc-retry-pushback-ms hint, which gRPC's client retry policy honours. No
+// thread is held while the call waits for its request, its scheduler slot or
+// the reply to be sent.
+template <typename Request, typename Response>
+Task<void> serve_unary(
+  Dispatch dispatch,
+  UnaryRequest<Request, Response> method,
+  UnaryHandler<Request, Response> handler,
+  Placement placement) {
+  // Batch calls parse and build on one arena: columns of many thousands of
+  // values take a few large blocks rather than heap allocations, and are
+  // released together when the call ends.
+  std::optional<google::protobuf::Arena> arena;
+  if constexpr (kArenaMessages<Request>) {
+    arena.emplace(batch_arena_options());
+  }
+  Request heap_request;
+  Response heap_response;
+  Request& request = arena ? *google::protobuf::Arena::CreateMessage<Request>(&*arena) : heap_request;
+  Response& response = arena ? *google::protobuf::Arena::CreateMessage<Response>(&*arena) : heap_response;
+  grpc::ServerContext context;
+  grpc::ServerAsyncResponseWriter<Response> responder(&context);
+
+  const bool arrived = co_await queue_event([&](void* tag) {
+    (dispatch.service->*method)(&context, &request, &responder, dispatch.queue, dispatch.queue, tag);
+  });
+  if (!arrived) {
+    co_return;  // queue shutdown
+  }
+  spawn(serve_unary<Request, Response>(dispatch, method, handler, placement));
+
+  grpc::Status status;
+  if (placement != Placement::inline_call) {
+    const WorkloadClass workload =
+      placement == Placement::analytic ? WorkloadClass::analytic : WorkloadClass::heavy;
+    const Admission admission = co_await scheduled(*dispatch.scheduler, workload);
+    if (!admission.admitted) {
+      const auto retry_ms = std::to_string(admission.retry_after.count());
+      context.AddTrailingMetadata("grpc-retry-pushback-ms", retry_ms);
+      status = grpc::Status(
+        grpc::StatusCode::RESOURCE_EXHAUSTED,
+        std::string(workload == WorkloadClass::analytic ? "analytic" : "heavy") +
+          " queue is over its latency budget; retry after " + retry_ms + " ms");
+      co_await queue_event([&](void* tag) { responder.FinishWithError(status, tag); });
+      co_return;
+    }
+  }
+  // A throw would otherwise end the detached coroutine in std::terminate.
+  status = handler_status([&] { return (dispatch.handlers->*handler)(&context, &request, &response); });
+  co_await queue_event([&](void* tag) { responder.Finish(response, status, tag); });
+}
+
+// Only the handler's signature is deduced; the generated Request* method may
+// be declared on a base class of AsyncService.
+template <typename Request, typename Response>
+void listen_unary(
+  const Dispatch& dispatch,
+  std::type_identity_t<UnaryRequest<Request, Response>> method,
+  UnaryHandler<Request, Response> handler,
+  Placement placement) {
+  spawn(serve_unary<Request, Response>(dispatch, method, handler, placement));
+}
+
+// Price and Greeks under micro-batching: the call is parked in the batcher
+// and finished from its thread once the batch has been priced, so handler
+// threads never wait for the batching window. When the batcher's queue is
+// full the call fails with RESOURCE_EXHAUSTED and a grpc-retry-pushback-ms
+// hint.
+template <typename Response>
+class BatchedCall final : public Call {
+ public:
+  using Method = void (AsyncService::*)(
+    grpc::ServerContext*,
+    crucible::quant::PriceRequest*,
+    grpc::ServerAsyncResponseWriter<Response>*,
+    grpc::CompletionQueue*,
+    grpc::ServerCompletionQueue*,
+    void*);
+
+  static void listen(const Dispatch& dispatch, Method method) {
+    auto* call = new BatchedCall(dispatch, method);
+    (dispatch.service->*method)(
+      &call->context_, &call->request_, &call->responder_, dispatch.queue, dispatch.queue, call);
+  }
+
+  void proceed(bool ok) override {
+    if (!ok || finishing_) {
+      delete this;
+      return;
+    }
+    listen(dispatch_, method_);
+    // The completion can run before submit() returns.
+    finishing_ = true;
+    const grpc::Status status = handler_status([this] {
+      const Admission admission = dispatch_.handlers->micro_batcher()->submit(
+        sanitized_option_from_proto(request_.option()), [this](const OptionGreeks& greeks) {
+          greeks_to_proto(greeks, &response_);
+          responder_.Finish(response_, grpc::Status::OK, this);
+        });
+      if (!admission.admitted) {
+        // Refused calls never complete, so answer here like a full scheduler lane.
+        const auto retry_ms = std::to_string(admission.retry_after.count());
+        context_.AddTrailingMetadata("grpc-retry-pushback-ms", retry_ms);
+        return grpc::Status(
+          grpc::StatusCode::RESOURCE_EXHAUSTED, "micro-batch queue is full; retry after " + retry_ms + " ms");
+      }
+      return grpc::Status::OK;
+    });
+    if (!status.ok()) {
+      responder_.FinishWithError(status, this);
+    }
+  }
+
+ private:
+  BatchedCall(const Dispatch& dispatch, Method method)
+    : dispatch_(dispatch), method_(method), responder_(&context_) {}
+
+  Dispatch dispatch_;
+  Method method_;
+  bool finishing_ = false;
+  grpc::ServerContext context_;
+  crucible::quant::PriceRequest request_;
+  Response response_;
+  grpc::ServerAsyncResponseWriter<Response> responder_;
+};
+
+// WatchJob without blocking a handler thread: an alarm polls the job's
+// snapshot and progress is written whenever its version moves. The done tag
+// reports client disconnects, which cancel the job unless it is detached.
+class WatchCall final : public Call {
+ public:
+  static void listen(const Dispatch& dispatch) {
+    auto* call = new WatchCall(dispatch);
+    call->context_.AsyncNotifyWhenDone(&call->done_);
+    dispatch.service->RequestWatchJob(
+      &call->context_, &call->request_, &call->writer_, dispatch.queue, dispatch.queue, call);
+  }
+
+  void proceed(bool ok) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    switch (state_) {
+      case State::requested:
+        if (!ok) {
+          // Never started, so the done tag will not be delivered either.
+          lock.unlock();
+          delete this;
+          return;
+        }
+        listen(dispatch_);
+        poll();
+        return;
+      case State::polling:
+        poll();
+        return;
+      case State::writing:
+        if (!ok) {
+          cancel_job();
+          finish(grpc::Status(grpc::StatusCode::CANCELLED, "client disconnected"));
+        } else if (terminal_) {
+          finish(grpc::Status::OK);
+        } else {
+          arm();
+        }
+        return;
+      case State::finishing:
+        finished_ = true;
+        break;
+    }
+    if (done_seen_) {
+      lock.unlock();
+      delete this;
+    }
+  }
+
+ private:
+  enum class State { requested, polling, writing, finishing };
+
+  struct DoneTag final : Call {
+    WatchCall* owner = nullptr;
+    void proceed(bool) override { owner->on_done(); }
+  };
+
+  explicit WatchCall(const Dispatch& dispatch) : dispatch_(dispatch), writer_(&context_) { done_.owner = this; }
+
+  void on_done() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_seen_ = true;
+    if (context_.IsCancelled()) {
+      disconnected_ = true;
+      cancel_job();
+    }
+    if (finished_) {
+      lock.unlock();
+      delete this;
+    }
+  }
+
+  void poll() {
+    if (disconnected_) {
+      finish(grpc::Status(grpc::StatusCode::CANCELLED, "client disconnected"));
+      return;
+    }
+    const auto snapshot = dispatch_.handlers->jobs().snapshot(request_.job_id());
+    if (!snapshot) {
+      finish(grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown job id"));
+      return;
+    }
+    if (written_ && *written_ == snapshot->version) {
+      arm();
+      return;
+    }
+    written_ = snapshot->version;
+    terminal_ = snapshot->state != JobState::running;
+    progress_.Clear();
+    job_progress_to_proto(*snapshot, &progress_);
+    state_ = State::writing;
+    writer_.Write(progress_, this);
+  }
+
+  void arm() {
+    state_ = State::polling;
+    alarm_.Set(dispatch_.queue, std::chrono::system_clock::now() + kWatchPollInterval, this);
+  }
+
+  void finish(const grpc::Status& status) {
+    state_ = State::finishing;
+    writer_.Finish(status, this);
+  }
+
+  void cancel_job() {
+    auto& jobs = dispatch_.handlers->jobs();
+    if (const auto snapshot = jobs.snapshot(request_.job_id()); snapshot && snapshot->cancel_on_disconnect) {
+      jobs.cancel(request_.job_id());
+    }
+  }
+
+  Dispatch dispatch_;
+  std::mutex mutex_;
+  State state_ = State::requested;
+  grpc::ServerContext context_;
+  crucible::quant::JobHandle request_;
+  crucible::quant::JobProgress progress_;
+  grpc::ServerAsyncWriter<crucible::quant::JobProgress> writer_;
+  grpc::Alarm alarm_;
+  DoneTag done_;
+  std::optional<std::uint64_t> written_;
+  bool terminal_ = false;
+  bool disconnected_ = false;
+  bool done_seen_ = false;
+  bool finished_ = false;
+};
+
+// Reprice: read an update, apply it to the stream's books, write the
+// changes if any, repeat. Repricing a book is cheap, so it runs inline.
+class RepriceCall final : public Call {
+ public:
+  static void listen(const Dispatch& dispatch) {
+    auto* call = new RepriceCall(dispatch);
+    dispatch.service->RequestReprice(&call->context_, &call->stream_, dispatch.queue, dispatch.queue, call);
+  }
+
+  void proceed(bool ok) override {
+    switch (state_) {
+      case State::requested:
+        if (!ok) {
+          delete this;
+          return;
+        }
+        listen(dispatch_);
+        read();
+        return;
+      case State::reading:
+        if (!ok) {
+          // The client finished sending.
+          finish(grpc::Status::OK);
+          return;
+        }
+        apply();
+        return;
+      case State::writing:
+        if (!ok) {
+          finish(grpc::Status(grpc::StatusCode::CANCELLED, "client disconnected"));
+          return;
+        }
+        read();
+        return;
+      case State::finishing:
+        delete this;
+        return;
+    }
+  }
+
+ private:
+  enum class State { requested, reading, writing, finishing };
+
+  explicit RepriceCall(const Dispatch& dispatch) : dispatch_(dispatch), stream_(&context_) {}
+
+  void read() {
+    state_ = State::reading;
+    stream_.Read(&request_, this);
+  }
+
+  void apply() {
+    bool respond = false;
+    const grpc::Status status =
+      handler_status([this, &respond] { return session_.apply(request_, &response_, &respond); });
+    if (!status.ok()) {
+      finish(status);
+      return;
+    }
+    if (!respond) {
+      read();
+      return;
+    }
+    state_ = State::writing;
+    stream_.Write(response_, this);
+  }
+
+  void finish(const grpc::Status& status) {
+    state_ = State::finishing;
+    stream_.Finish(status, this);
+  }
+
+  Dispatch dispatch_;
+  State state_ = State::requested;
+  grpc::ServerContext context_;
+  grpc::ServerAsyncReaderWriter<crucible::quant::RepriceResponse, crucible::quant::RepriceRequest> stream_;
+  crucible::quant::RepriceRequest request_;
+  crucible::quant::RepriceResponse response_;
+  RepriceSession session_;
+};
+
+void listen_all(const Dispatch& dispatch) {
+  constexpr auto inline_call = Placement::inline_call;
+  constexpr auto analytic = Placement::analytic;
+  constexpr auto heavy = Placement::heavy;
+  if (dispatch.handlers->micro_batcher() != nullptr) {
+    BatchedCall<crucible::quant::PriceResponse>::listen(dispatch, &AsyncService::RequestPrice);
+    BatchedCall<crucible::quant::GreeksResponse>::listen(dispatch, &AsyncService::RequestGreeks);
+  } else {
+    listen_unary(dispatch, &AsyncService::RequestPrice, &QuantGrpcService::Price, analytic);
+    listen_unary(dispatch, &AsyncService::RequestGreeks, &QuantGrpcService::Greeks, analytic);
+  }
+  listen_unary(dispatch, &AsyncService::RequestImpliedVol, &QuantGrpcService::ImpliedVol, analytic);
+  listen_unary(dispatch, &AsyncService::RequestMonteCarlo, &QuantGrpcService::MonteCarlo, heavy);
+  listen_unary(dispatch, &AsyncService::RequestPathMonteCarlo, &QuantGrpcService::PathMonteCarlo, heavy);
+  listen_unary(dispatch, &AsyncService::RequestAmericanMonteCarlo, &QuantGrpcService::AmericanMonteCarlo, heavy);
+  listen_unary(
+    dispatch, &AsyncService::RequestMultiAssetMonteCarlo, &QuantGrpcService::MultiAssetMonteCarlo, heavy);
+  listen_unary(
+    dispatch, &AsyncService::RequestJumpDiffusionPrice, &QuantGrpcService::JumpDiffusionPrice, analytic);
+  listen_unary(
+    dispatch, &AsyncService::RequestMultiPayoffMonteCarlo, &QuantGrpcService::MultiPayoffMonteCarlo, heavy);
+  listen_unary(
+    dispatch, &AsyncService::RequestSubmitMonteCarloJob, &QuantGrpcService::SubmitMonteCarloJob, inline_call);
+  listen_unary(dispatch, &AsyncService::RequestCancelJob, &QuantGrpcService::CancelJob, inline_call);
+  listen_unary(dispatch, &AsyncService::RequestCacheStats, &QuantGrpcService::CacheStats, inline_call);
+  listen_unary(dispatch, &AsyncService::RequestPriceBatch, &QuantGrpcService::PriceBatch, analytic);
+  listen_unary(dispatch, &AsyncService::RequestGreeksBatch, &QuantGrpcService::GreeksBatch, analytic);
+  listen_unary(dispatch, &AsyncService::RequestImpliedVolBatch, &QuantGrpcService::ImpliedVolBatch, analytic);
+  listen_unary(dispatch, &AsyncService::RequestMicroBatchStats, &QuantGrpcService::MicroBatchStats, inline_call);
+  listen_unary(
+    dispatch, &AsyncService::RequestAttachSharedMemory, &QuantGrpcService::AttachSharedMemory, inline_call);
+  listen_unary(
+    dispatch, &AsyncService::RequestDetachSharedMemory, &QuantGrpcService::DetachSharedMemory, inline_call);
+  listen_unary(dispatch, &AsyncService::RequestSharedBatch, &QuantGrpcService::SharedBatch, analytic);
+  WatchCall::listen(dispatch);
+  RepriceCall::listen(dispatch);
+}
+
+}  // namespace
+
+QuantAsyncServer::QuantAsyncServer(QuantGrpcService& handlers, ServerThreading threading)
+  : handlers_(handlers), threading_(threading) {}
+
+QuantAsyncServer::~QuantAsyncServer() { shutdown(); }
+
+bool QuantAsyncServer::start(const std::string& address) {
+  grpc::ServerBuilder builder;
+  builder.AddListeningPort(address, grpc::InsecureServerCredentials());
+  builder.RegisterService(&service_);
+  const std::size_t queue_count = std::max<std::size_t>(threading_.completion_queues, 1U);
+  for (std::size_t i = 0; i < queue_count; ++i) {
+    queues_.push_back(builder.AddCompletionQueue());
+  }
+  server_ = builder.BuildAndStart();
+  if (!server_) {
+    queues_.clear();
+    return false;
+  }
+  scheduler_ = std::make_unique<WorkloadScheduler>(threading_.scheduler);
+  const std::size_t threads_per_queue = std::max<std::size_t>(threading_.handler_threads, 1U);
+  for (auto& queue : queues_) {
+    listen_all(Dispatch{&service_, &handlers_, queue.get(), scheduler_.get()});
+    for (std::size_t t = 0; t < threads_per_queue; ++t) {
+      threads_.emplace_back([queue = queue.get()] {
+        void* tag = nullptr;
+        bool ok = false;
+        while (queue->Next(&tag, &ok)) {
+          static_cast<Call*>(tag)->proceed(ok);
+        }
+      });
+    }
+  }
+  return true;
+}
+
+void QuantAsyncServer::wait() {
+  if (server_) {
+    server_->Wait();
+  }
+}
+
+void QuantAsyncServer::shutdown() {
+  if (!server_) {
+    return;
+  }
+  // Handler threads keep draining the queues while in-flight calls finish;
+  // calls still running after the grace period are cancelled.
+  server_->Shutdown(std::chrono::system_clock::now() + kShutdownGrace);
+  scheduler_.reset();
+  for (auto& queue : queues_) {
+    queue->Shutdown();
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  queues_.clear();
+  server_.reset();
+}
+
+}  // namespace quant
@@ -0,0 +1,108 @@
+#include "quant/batch_messages.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace quant {
+
+namespace {
+
+constexpr std::size_t kBatchArenaStartBlock = 64 * 1024;
+constexpr std::size_t kBatchArenaMaxBlock = 4 * 1024 * 1024;
+
+// Sizes `field` to `size` elements without initialising them and returns
+// their storage; the kernel writes every element.
+template <typename T>
+T* reserved_column(google::protobuf::RepeatedField<T>* field, int size) {
+  field->Clear();
+  field->Reserve(size);
+  return field->AddNAlreadyReserved(size);
+}
+
+}  // namespace
+
+std::string option_columns_from_proto(
+  const crucible::quant::OptionColumns& proto, bool needs_volatility, OptionColumns& columns) {
+  const int size = proto.spots_size();
+  if (proto.strikes_size() != size || proto.rates_size() != size || proto.maturities_size() != size ||
+      proto.is_call_size() != size) {
+    return "option columns must have the same length";
+  }
+  if (needs_volatility && proto.volatilities_size() != size) {
+    return "volatilities must have one value per option";
+  }
+  if (proto.dividends_size() != 0 && proto.dividends_size() != size) {
+    return "dividends must be empty or have one value per option";
+  }
+  columns = OptionColumns{
+    .spot = proto.spots().data(),
+    .strike = proto.strikes().data(),
+    .rate = proto.rates().data(),
+    .volatility = needs_volatility ? proto.volatilities().data() : nullptr,
+    .time_to_maturity = proto.maturities().data(),
+    .dividend_yield = proto.dividends_size() == 0 ? nullptr : proto.dividends().data(),
+    .is_call = proto.is_call().data(),
+    .size = static_cast<std::size_t>(size),
+    .input_floor = 1e-6,
+  };
+  return {};
+}
+
+std::string price_batch(
+  const crucible::quant::PriceBatchRequest& request, crucible::quant::PriceBatchResponse* response) {
+  OptionColumns columns{};
+  if (auto error = option_columns_from_proto(request.options(), true, columns); !error.empty()) {
+    return error;
+  }
+  const int size = static_cast<int>(columns.size);
+  black_scholes_price_batch(columns, reserved_column(response->mutable_prices(), size));
+  return {};
+}
+
+std::string greeks_batch(
+  const crucible::quant::PriceBatchRequest& request, crucible::quant::GreeksBatchResponse* response) {
+  OptionColumns columns{};
+  if (auto error = option_columns_from_proto(request.options(), true, columns); !error.empty()) {
+    return error;
+  }
+  const int size = static_cast<int>(columns.size);
+  black_scholes_greeks_batch(
+    columns,
+    GreeksColumns{
+      .price = reserved_column(response->mutable_prices(), size),
+      .delta = reserved_column(response->mutable_deltas(), size),
+      .gamma = reserved_column(response->mutable_gammas(), size),
+      .vega = reserved_column(response->mutable_vegas(), size),
+      .theta = reserved_column(response->mutable_thetas(), size),
+      .rho = reserved_column(response->mutable_rhos(), size),
+    });
+  return {};
+}
+
+std::string implied_vol_batch(
+  const crucible::quant::ImpliedVolBatchRequest& request, crucible::quant::ImpliedVolBatchResponse* response) {
+  OptionColumns columns{};
+  if (auto error = option_columns_from_proto(request.options(), false, columns); !error.empty()) {
+    return error;
+  }
+  const int size = static_cast<int>(columns.size);
+  if (request.target_prices_size() != size) {
+    return "target_prices must have one value per option";
+  }
+  implied_volatility_batch(
+    columns,
+    request.target_prices().data(),
+    reserved_column(response->mutable_implied_volatilities(), size),
+    reserved_column(response->mutable_converged(), size),
+    reserved_column(response->mutable_iterations(), size));
+  return {};
+}
+
+google::protobuf::ArenaOptions batch_arena_options() {
+  google::protobuf::ArenaOptions options;
+  options.start_block_size = kBatchArenaStartBlock;
+  options.max_block_size = kBatchArenaMaxBlock;
+  return options;
+}
+
+}  // namespace quant
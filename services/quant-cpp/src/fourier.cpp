@@ -0,0 +1,56 @@
+#include "quant/fourier.hpp"
+
+#include <cmath>
+
+namespace quant {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kUpperLimit = 400.0;
+constexpr int kPanels = 400;
+
+// 8-point Gauss-Legendre nodes and weights on [-1, 1].
+constexpr double kNodes[] = {-0.9602898564975363, -0.7966664774136267, -0.5255324099163290,
+                             -0.1834346424956498, 0.1834346424956498, 0.5255324099163290,
+                             0.7966664774136267, 0.9602898564975363};
+constexpr double kWeights[] = {0.1012285362903763, 0.2223810344533745, 0.3137066458778873,
+                               0.3626837833783620, 0.3626837833783620, 0.3137066458778873,
+                               0.2223810344533745, 0.1012285362903763};
+
+}  // namespace
+
+double characteristic_function_price(const CharacteristicFunction& phi, const OptionInput& option) {
+  const double T = option.time_to_maturity;
+  const double K = option.strike;
+  const double log_strike = std::log(K);
+  const std::complex<double> i(0.0, 1.0);
+  const std::complex<double> forward_moment = phi(-i);  // E[S_T]
+
+  // P1 (share measure) and P2 (risk-neutral exercise probability).
+  double integral_1 = 0.0;
+  double integral_2 = 0.0;
+  const double width = kUpperLimit / kPanels;
+  for (int panel = 0; panel < kPanels; ++panel) {
+    const double mid = (panel + 0.5) * width;
+    for (int k = 0; k < 8; ++k) {
+      const double u = mid + 0.5 * width * kNodes[k];
+      const std::complex<double> kernel = std::exp(-i * u * log_strike) / (i * u);
+      integral_1 += kWeights[k] * std::real(kernel * phi(u - i) / forward_moment);
+      integral_2 += kWeights[k] * std::real(kernel * phi(u));
+    }
+  }
+  integral_1 *= 0.5 * width;
+  integral_2 *= 0.5 * width;
+
+  const double p1 = 0.5 + integral_1 / kPi;
+  const double p2 = 0.5 + integral_2 / kPi;
+  const double discount = std::exp(-option.rate * T);
+  const double call = discount * (std::real(forward_moment) * p1 - K * p2);
+  if (option.is_call) {
+    return call;
+  }
+  return call - discount * std::real(forward_moment) + K * discount;
+}
+
+}  // namespace quant
@@ -1,15 +1,64 @@
 #include "quant/grpc_service.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <future>
 #include <limits>
+#include <map>
+#include <vector>
 
 #include <grpcpp/server_context.h>
 
+#include "quant/batch_messages.hpp"
+#include "quant/lsm.hpp"
+#include "quant/mlmc.hpp"
+#include "quant/path_greeks.hpp"
+#include "quant/path_payoffs.hpp"
+#include "quant/payoff_script.hpp"
+
 namespace quant {
 
 namespace {
 
+// Limits for adaptive MonteCarlo, which runs on one thread until it meets
+// the target or reaches max_paths.
+constexpr double kMinTargetStandardError = 1e-6;
+constexpr std::uint64_t kMaxAdaptivePaths = 100'000'000;
+
+// Limits for SubmitMonteCarloJob. A job that is not detached and that no
+// WatchJob or CancelJob has polled for the grace period is cancelled, so a
+// client that goes away without watching frees its cores.
+constexpr std::uint64_t kMaxJobPaths = 10'000'000'000;
+constexpr std::chrono::milliseconds kUnwatchedJobGrace{10'000};
+
+// Request size limits for AmericanMonteCarlo; the regression set is further
+// bounded by kMaxRegressionValues.
+constexpr std::uint32_t kMaxLsmSteps = 10'000;
+constexpr std::uint32_t kMaxLsmPaths = 10'000'000;
+
+// Limits for multilevel PathMonteCarlo: targets below the floor are rejected
+// outright, the rest run under a simulated-step budget.
+constexpr double kMinTargetRmse = 1e-6;
+constexpr std::uint64_t kDefaultMlmcSteps = 1'000'000'000;
+constexpr std::uint64_t kMaxMlmcSteps = 10'000'000'000;
+
+// Limits for path simulations on a fixed grid. The grid is allocated before
+// any path runs, and steps x paths bounds the work of a single call.
+constexpr std::uint32_t kMaxPathSteps = 10'000;
+constexpr std::uint64_t kMaxPathSimulatedSteps = 10'000'000'000;
+
+// Legs in one MultiPayoffMonteCarlo request. Every block keeps per-leg
+// statistics and, with covariance, a legs x legs co-moment matrix.
+constexpr int kMaxPayoffLegs = 64;
+
+// Longest payoff script accepted; the compiler bounds nesting itself.
+constexpr std::size_t kMaxPayoffScriptBytes = 64 * 1024;
+
+// Underlying ids in a RegisterBook must be below this. A book keys options
+// by id, so the limit only turns away ids no caller could mean.
+constexpr std::uint32_t kMaxUnderlyingIds = 1'000'000;
+
 OptionInput sanitize_option(const OptionInput& option) {
   OptionInput sanitized = option;
   sanitized.volatility = std::max(option.volatility, 1e-6);
@@ -19,8 +68,111 @@ OptionInput sanitize_option(const OptionInput& option) {
   return sanitized;
 }
 
+void set_greeks(const MonteCarloGreeks& greeks, crucible::quant::MonteCarloResponse* response) {
+  response->set_price(greeks.price.value);
+  response->set_standard_error(greeks.price.standard_error);
+  response->set_paths(greeks.paths);
+  response->set_delta(greeks.delta.value);
+  response->set_delta_standard_error(greeks.delta.standard_error);
+  response->set_gamma(greeks.gamma.value);
+  response->set_gamma_standard_error(greeks.gamma.standard_error);
+  response->set_vega(greeks.vega.value);
+  response->set_vega_standard_error(greeks.vega.standard_error);
+}
+
+crucible::quant::JobState job_state_to_proto(JobState state) {
+  switch (state) {
+    case JobState::completed: return crucible::quant::JOB_COMPLETED;
+    case JobState::cancelled: return crucible::quant::JOB_CANCELLED;
+    case JobState::deadline_exceeded: return crucible::quant::JOB_DEADLINE_EXCEEDED;
+    case JobState::failed: return crucible::quant::JOB_FAILED;
+    default: return crucible::quant::JOB_RUNNING;
+  }
+}
+
+void set_book_changes(const BookChanges& changes, crucible::quant::RepriceResponse* response) {
+  response->mutable_options()->Add(changes.options.begin(), changes.options.end());
+  response->mutable_prices()->Add(changes.price.begin(), changes.price.end());
+  response->mutable_deltas()->Add(changes.delta.begin(), changes.delta.end());
+  response->mutable_gammas()->Add(changes.gamma.begin(), changes.gamma.end());
+  response->mutable_vegas()->Add(changes.vega.begin(), changes.vega.end());
+  response->mutable_thetas()->Add(changes.theta.begin(), changes.theta.end());
+  response->mutable_rhos()->Add(changes.rho.begin(), changes.rho.end());
+}
+
+bool valid_jumps(const MertonJumpParameters& jumps) {
+  return jumps.intensity >= 0.0 && jumps.jump_volatility >= 0.0;
+}
+
+bool valid_jumps(const KouJumpParameters& jumps) {
+  return jumps.intensity >= 0.0 && jumps.up_probability >= 0.0 && jumps.up_probability <= 1.0
+    && jumps.up_rate > 1.0 && jumps.down_rate > 0.0;
+}
+
+// Builds the GBM, Heston or jump-diffusion model selected by a path request.
+template <typename Request>
+grpc::Status path_model_from_request(
+  const Request& request,
+  const OptionInput& option,
+  std::unique_ptr<PathModel>& model) {
+  if (static_cast<int>(request.has_heston()) + static_cast<int>(request.has_merton())
+        + static_cast<int>(request.has_kou()) > 1) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "at most one of heston, merton and kou may be set");
+  }
+  if (request.has_merton()) {
+    const MertonJumpParameters merton = merton_from_proto(request.merton());
+    if (!valid_jumps(merton)) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "invalid Merton jump parameters");
+    }
+    model = std::make_unique<JumpDiffusionPathModel>(option, merton);
+  } else if (request.has_kou()) {
+    const KouJumpParameters kou = kou_from_proto(request.kou());
+    if (!valid_jumps(kou)) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "invalid Kou jump parameters");
+    }
+    model = std::make_unique<JumpDiffusionPathModel>(option, kou);
+  } else if (request.has_heston()) {
+    const HestonParameters heston = heston_from_proto(request.heston());
+    if (heston.mean_reversion <= 0.0 || heston.long_run_variance <= 0.0 || heston.vol_of_vol <= 0.0
+        || heston.initial_variance < 0.0 || std::abs(heston.correlation) > 1.0) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "invalid Heston parameters");
+    }
+    model = std::make_unique<HestonPathModel>(option, heston);
+  } else {
+    model = std::make_unique<GbmPathModel>(option);
+  }
+  return grpc::Status::OK;
+}
+
 }  // namespace
 
+void job_progress_to_proto(const JobSnapshot& snapshot, crucible::quant::JobProgress* progress) {
+  progress->set_job_id(snapshot.id);
+  progress->set_state(job_state_to_proto(snapshot.state));
+  progress->set_price(snapshot.progress.price);
+  progress->set_standard_error(snapshot.progress.standard_error);
+  progress->set_paths_completed(snapshot.progress.paths);
+  progress->set_paths_total(snapshot.target_paths);
+  progress->set_error(snapshot.error);
+}
+
+OptionInput sanitized_option_from_proto(const crucible::quant::OptionSpecification& proto) {
+  return sanitize_option(option_from_proto(proto));
+}
+
+void greeks_to_proto(const OptionGreeks& greeks, crucible::quant::PriceResponse* response) {
+  response->set_price(greeks.price);
+}
+
+void greeks_to_proto(const OptionGreeks& greeks, crucible::quant::GreeksResponse* response) {
+  response->set_price(greeks.price);
+  response->set_delta(greeks.delta);
+  response->set_gamma(greeks.gamma);
+  response->set_vega(greeks.vega);
+  response->set_theta(greeks.theta);
+  response->set_rho(greeks.rho);
+}
+
 OptionInput option_from_proto(const crucible::quant::OptionSpecification& proto) {
   return OptionInput{
     .spot = proto.spot(),
@@ -33,6 +185,76 @@ OptionInput option_from_proto(const crucible::quant::OptionSpecification& proto)
   };
 }
 
+HestonParameters heston_from_proto(const crucible::quant::HestonParameters& proto) {
+  return HestonParameters{
+    .initial_variance = proto.initial_variance(),
+    .mean_reversion = proto.mean_reversion(),
+    .long_run_variance = proto.long_run_variance(),
+    .vol_of_vol = proto.vol_of_vol(),
+    .correlation = proto.correlation(),
+  };
+}
+
+MertonJumpParameters merton_from_proto(const crucible::quant::MertonJumpParameters& proto) {
+  return MertonJumpParameters{
+    .intensity = proto.intensity(),
+    .mean_jump = proto.mean_jump(),
+    .jump_volatility = proto.jump_volatility(),
+  };
+}
+
+KouJumpParameters kou_from_proto(const crucible::quant::KouJumpParameters& proto) {
+  return KouJumpParameters{
+    .intensity = proto.intensity(),
+    .up_probability = proto.up_probability(),
+    .up_rate = proto.up_rate(),
+    .down_rate = proto.down_rate(),
+  };
+}
+
+std::unique_ptr<PathPayoff> path_payoff_from_proto(
+  const OptionInput& option,
+  const crucible::quant::PathPayoffSpecification& proto,
+  std::string* error) {
+  using crucible::quant::PathPayoffType;
+  switch (proto.type()) {
+    case PathPayoffType::PATH_PAYOFF_ARITHMETIC_ASIAN:
+      return std::make_unique<AsianPayoff>(option.strike, option.is_call, AverageType::arithmetic);
+    case PathPayoffType::PATH_PAYOFF_GEOMETRIC_ASIAN:
+      return std::make_unique<AsianPayoff>(option.strike, option.is_call, AverageType::geometric);
+    case PathPayoffType::PATH_PAYOFF_BARRIER: {
+      BarrierType type = BarrierType::up_and_out;
+      switch (proto.barrier_type()) {
+        case crucible::quant::BARRIER_UP_AND_IN: type = BarrierType::up_and_in; break;
+        case crucible::quant::BARRIER_DOWN_AND_OUT: type = BarrierType::down_and_out; break;
+        case crucible::quant::BARRIER_DOWN_AND_IN: type = BarrierType::down_and_in; break;
+        default: break;
+      }
+      return std::make_unique<BarrierPayoff>(option.strike, option.is_call, proto.barrier(), type);
+    }
+    case PathPayoffType::PATH_PAYOFF_LOOKBACK:
+      return std::make_unique<LookbackPayoff>(option.strike, option.is_call, proto.floating_strike());
+    case PathPayoffType::PATH_PAYOFF_SCRIPT: {
+      if (proto.script().size() > kMaxPayoffScriptBytes) {
+        if (error != nullptr) {
+          *error = "payoff script must be at most " + std::to_string(kMaxPayoffScriptBytes) + " bytes";
+        }
+        return nullptr;
+      }
+      auto compiled = compile_payoff_script(proto.script());
+      if (!compiled.program) {
+        if (error != nullptr) {
+          *error = "payoff script: " + compiled.error;
+        }
+        return nullptr;
+      }
+      return std::make_unique<ScriptPayoff>(std::move(compiled.program), option.rate, option.time_to_maturity);
+    }
+    default:
+      return std::make_unique<EuropeanPathPayoff>(option.strike, option.is_call);
+  }
+}
+
 grpc::Status QuantGrpcService::Price(
   grpc::ServerContext*,
   const crucible::quant::PriceRequest* request,
@@ -40,9 +262,7 @@ grpc::Status QuantGrpcService::Price(
   if (request == nullptr || response == nullptr) {
     return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
   }
-  const OptionInput option = sanitize_option(option_from_proto(request->option()));
-  const auto greeks = black_scholes(option);
-  response->set_price(greeks.price);
+  greeks_to_proto(price_single(sanitized_option_from_proto(request->option())), response);
   return grpc::Status::OK;
 }
 
@@ -53,17 +273,24 @@ grpc::Status QuantGrpcService::Greeks(
   if (request == nullptr || response == nullptr) {
     return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
   }
-  const OptionInput option = sanitize_option(option_from_proto(request->option()));
-  const auto greeks = black_scholes(option);
-  response->set_price(greeks.price);
-  response->set_delta(greeks.delta);
-  response->set_gamma(greeks.gamma);
-  response->set_vega(greeks.vega);
-  response->set_theta(greeks.theta);
-  response->set_rho(greeks.rho);
+  greeks_to_proto(price_single(sanitized_option_from_proto(request->option())), response);
   return grpc::Status::OK;
 }
 
+OptionGreeks QuantGrpcService::price_single(const OptionInput& option) {
+  if (!micro_batcher_) {
+    return black_scholes(option);
+  }
+  std::promise<OptionGreeks> result;
+  auto future = result.get_future();
+  // A refused call is never completed. This path already holds its thread,
+  // so it prices the option itself rather than fail the call.
+  if (!micro_batcher_->submit(option, [&result](const OptionGreeks& greeks) { result.set_value(greeks); }).admitted) {
+    return black_scholes(option);
+  }
+  return future.get();
+}
+
 grpc::Status QuantGrpcService::ImpliedVol(
   grpc::ServerContext*,
   const crucible::quant::ImpliedVolRequest* request,
@@ -88,11 +315,662 @@ grpc::Status QuantGrpcService::MonteCarlo(
     return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
   }
   const OptionInput option = sanitize_option(option_from_proto(request->option()));
-  const std::uint32_t paths = request->paths() == 0U ? 10'000U : request->paths();
   const std::uint32_t seed = request->seed();
-  const auto result = monte_carlo_price(option, paths, seed);
+  const std::uint32_t paths = request->paths() == 0U ? 10'000U : request->paths();
+  const bool adaptive = !request->greeks() && request->target_standard_error() > 0.0;
+  const std::uint64_t max_paths = request->max_paths() == 0U ? 10'000'000U : request->max_paths();
+  if (adaptive) {
+    if (!std::isfinite(request->target_standard_error())
+        || request->target_standard_error() < kMinTargetStandardError) {
+      return grpc::Status(
+        grpc::StatusCode::INVALID_ARGUMENT,
+        "target_standard_error must be finite and at least " + std::to_string(kMinTargetStandardError));
+    }
+    if (max_paths > kMaxAdaptivePaths) {
+      return grpc::Status(
+        grpc::StatusCode::INVALID_ARGUMENT, "max_paths must be at most " + std::to_string(kMaxAdaptivePaths));
+    }
+  }
+
+  // Results are a pure function of the sanitized inputs, so key on those
+  // rather than the raw request.
+  CacheKey key("monte_carlo.v1");
+  key.add(option.spot).add(option.strike).add(option.rate).add(option.volatility);
+  key.add(option.time_to_maturity).add(option.dividend_yield).add(option.is_call);
+  key.add(std::uint64_t{seed}).add(request->greeks()).add(adaptive);
+  if (adaptive) {
+    key.add(request->target_standard_error()).add(max_paths);
+  } else {
+    key.add(std::uint64_t{paths});
+  }
+  if (const auto cached = result_cache_.find(key); cached && response->ParseFromString(*cached)) {
+    return grpc::Status::OK;
+  }
+
+  // Identical requests that miss together share one simulation. The leader
+  // fills the cache before retiring its flight, so later arrivals hit it.
+  const std::string serialized = in_flight_.run(key, [&] {
+    crucible::quant::MonteCarloResponse computed;
+    if (request->greeks()) {
+      set_greeks(monte_carlo_greeks(option, paths, seed), &computed);
+    } else {
+      const MonteCarloResult result = adaptive
+        ? monte_carlo_price_adaptive(option, request->target_standard_error(), max_paths, seed)
+        : monte_carlo_price(option, paths, seed);
+      computed.set_price(result.price);
+      computed.set_standard_error(result.standard_error);
+      computed.set_paths(result.paths);
+    }
+    std::string bytes = computed.SerializeAsString();
+    result_cache_.insert(key, bytes);
+    return bytes;
+  });
+  if (!response->ParseFromString(serialized)) {
+    return grpc::Status(grpc::StatusCode::INTERNAL, "failed to decode shared result");
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::PathMonteCarlo(
+  grpc::ServerContext*,
+  const crucible::quant::PathMonteCarloRequest* request,
+  crucible::quant::MonteCarloResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  if (request->steps() > kMaxPathSteps) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "steps must be at most " + std::to_string(kMaxPathSteps));
+  }
+  const auto& payoff_spec = request->payoff();
+  if (payoff_spec.type() == crucible::quant::PATH_PAYOFF_BARRIER && payoff_spec.barrier() <= 0.0) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "barrier must be positive");
+  }
+  const OptionInput option = sanitize_option(option_from_proto(request->option()));
+  std::unique_ptr<PathModel> model;
+  if (const auto status = path_model_from_request(*request, option, model); !status.ok()) {
+    return status;
+  }
+  std::string payoff_error;
+  const auto payoff = path_payoff_from_proto(option, payoff_spec, &payoff_error);
+  if (!payoff) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, payoff_error);
+  }
+  if (request->target_rmse() > 0.0) {
+    if (request->greeks()) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "greeks are not available with target_rmse");
+    }
+    if (!std::isfinite(request->target_rmse()) || request->target_rmse() < kMinTargetRmse) {
+      return grpc::Status(
+        grpc::StatusCode::INVALID_ARGUMENT,
+        "target_rmse must be finite and at least " + std::to_string(kMinTargetRmse));
+    }
+    if (request->max_simulated_steps() > kMaxMlmcSteps) {
+      return grpc::Status(
+        grpc::StatusCode::INVALID_ARGUMENT, "max_simulated_steps must be at most " + std::to_string(kMaxMlmcSteps));
+    }
+    const MlmcConfig config{
+      .target_rmse = request->target_rmse(),
+      .seed = request->seed(),
+      .base_steps = request->steps() == 0U ? 1U : request->steps(),
+      .max_simulated_steps = request->max_simulated_steps() == 0U ? kDefaultMlmcSteps : request->max_simulated_steps(),
+    };
+    const auto result = mlmc_price(*model, option.time_to_maturity, *payoff, config);
+    if (result.budget_exhausted) {
+      return grpc::Status(
+        grpc::StatusCode::RESOURCE_EXHAUSTED,
+        "target_rmse needs more than " + std::to_string(config.max_simulated_steps) + " simulated steps");
+    }
+    response->set_price(result.price);
+    response->set_standard_error(result.standard_error);
+    response->set_paths(result.paths);
+    response->set_levels(static_cast<std::uint32_t>(result.levels.size()));
+    return grpc::Status::OK;
+  }
+  const std::uint32_t steps = request->steps() == 0U ? 252U : request->steps();
+  const std::uint32_t paths = request->paths() == 0U ? 10'000U : request->paths();
+  if (std::uint64_t{steps} * paths > kMaxPathSimulatedSteps) {
+    return grpc::Status(
+      grpc::StatusCode::INVALID_ARGUMENT,
+      "steps x paths must be at most " + std::to_string(kMaxPathSimulatedSteps));
+  }
+  const TimeGrid grid = TimeGrid::uniform(option.time_to_maturity, steps);
+  if (request->greeks()) {
+    if (request->has_heston() || request->has_merton() || request->has_kou()) {
+      return grpc::Status(grpc::StatusCode::UNIMPLEMENTED, "path greeks are only implemented under GBM");
+    }
+    set_greeks(path_monte_carlo_greeks(option, grid, *payoff, paths, request->seed()), response);
+    return grpc::Status::OK;
+  }
+  const auto result = path_monte_carlo_price(*model, grid, *payoff, paths, request->seed());
+  response->set_price(result.price);
+  response->set_standard_error(result.standard_error);
+  response->set_paths(result.paths);
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::AmericanMonteCarlo(
+  grpc::ServerContext*,
+  const crucible::quant::AmericanMonteCarloRequest* request,
+  crucible::quant::AmericanMonteCarloResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  const OptionInput option = sanitize_option(option_from_proto(request->option()));
+  const std::uint32_t steps = request->steps() == 0U ? 50U : request->steps();
+  const std::uint32_t paths = request->paths() == 0U ? 10'000U : request->paths();
+  const LsmConfig config{
+    .regression_paths = request->regression_paths() == 0U ? paths : request->regression_paths(),
+    .pricing_paths = paths,
+    .seed = request->seed(),
+    .basis_degree = request->basis_degree() == 0U ? 3U : request->basis_degree(),
+  };
+  if (steps > kMaxLsmSteps || paths > kMaxLsmPaths || config.regression_paths > kMaxLsmPaths) {
+    return grpc::Status(
+      grpc::StatusCode::INVALID_ARGUMENT,
+      "steps must be at most " + std::to_string(kMaxLsmSteps) + " and paths and regression_paths at most " +
+        std::to_string(kMaxLsmPaths));
+  }
+  const auto dates = exercise_steps(steps, request->exercise_dates());
+  if (dates.size() * config.regression_paths > kMaxRegressionValues) {
+    return grpc::Status(
+      grpc::StatusCode::INVALID_ARGUMENT,
+      "exercise dates x regression_paths must be at most " + std::to_string(kMaxRegressionValues));
+  }
+  const auto result = lsm_price(
+    GbmPathModel(option), TimeGrid::uniform(option.time_to_maturity, steps), dates, option.strike, option.is_call,
+    config);
+  response->set_price(result.price);
+  response->set_standard_error(result.standard_error);
+  response->set_in_sample_price(result.in_sample_price);
+  response->set_paths(result.paths);
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::MultiAssetMonteCarlo(
+  grpc::ServerContext*,
+  const crucible::quant::MultiAssetMonteCarloRequest* request,
+  crucible::quant::MonteCarloResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  const auto n = static_cast<std::size_t>(request->spots_size());
+  if (n == 0U || static_cast<std::size_t>(request->volatilities_size()) != n
+      || static_cast<std::size_t>(request->correlation_size()) != n * n
+      || (request->dividends_size() != 0 && static_cast<std::size_t>(request->dividends_size()) != n)
+      || (request->weights_size() != 0 && static_cast<std::size_t>(request->weights_size()) != n)) {
+    return grpc::Status(
+      grpc::StatusCode::INVALID_ARGUMENT,
+      "spots, volatilities, dividends, weights and correlation (n x n) sizes must agree");
+  }
+  if (request->payoff() == crucible::quant::MULTI_ASSET_SPREAD && n < 2U) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "spread payoff needs two underlyings");
+  }
+
+  MultiAssetInput input{
+    .spots = {request->spots().begin(), request->spots().end()},
+    .volatilities = {request->volatilities().begin(), request->volatilities().end()},
+    .dividend_yields = {request->dividends().begin(), request->dividends().end()},
+    .correlation = {request->correlation().begin(), request->correlation().end()},
+    .rate = request->rate(),
+    .time_to_maturity = std::max(request->time_to_maturity(), 1e-6),
+  };
+  if (auto error = validate_correlation(input.correlation, n); !error.empty()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, error);
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    input.spots[i] = std::max(input.spots[i], 1e-6);
+    input.volatilities[i] = std::max(input.volatilities[i], 1e-6);
+  }
+
+  MultiAssetPayoffType type = MultiAssetPayoffType::basket;
+  switch (request->payoff()) {
+    case crucible::quant::MULTI_ASSET_BEST_OF: type = MultiAssetPayoffType::best_of; break;
+    case crucible::quant::MULTI_ASSET_WORST_OF: type = MultiAssetPayoffType::worst_of; break;
+    case crucible::quant::MULTI_ASSET_SPREAD: type = MultiAssetPayoffType::spread; break;
+    default: break;
+  }
+  const MultiAssetPayoff payoff{
+    .type = type,
+    .strike = request->strike(),
+    .is_call = request->is_call(),
+    .weights = {request->weights().begin(), request->weights().end()},
+  };
+
+  const std::uint32_t paths = request->paths() == 0U ? 10'000U : request->paths();
+  const auto result = multi_asset_monte_carlo_price(input, payoff, paths, request->seed());
   response->set_price(result.price);
   response->set_standard_error(result.standard_error);
+  response->set_paths(result.paths);
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::JumpDiffusionPrice(
+  grpc::ServerContext*,
+  const crucible::quant::JumpDiffusionRequest* request,
+  crucible::quant::PriceResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  if (request->has_merton() == request->has_kou()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "exactly one of merton and kou must be set");
+  }
+  const OptionInput option = sanitize_option(option_from_proto(request->option()));
+  if (request->has_merton()) {
+    const MertonJumpParameters merton = merton_from_proto(request->merton());
+    if (!valid_jumps(merton)) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "invalid Merton jump parameters");
+    }
+    response->set_price(merton_price(option, merton));
+    return grpc::Status::OK;
+  }
+  const KouJumpParameters kou = kou_from_proto(request->kou());
+  if (!valid_jumps(kou)) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "invalid Kou jump parameters");
+  }
+  response->set_price(kou_price(option, kou));
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::MultiPayoffMonteCarlo(
+  grpc::ServerContext*,
+  const crucible::quant::MultiPayoffMonteCarloRequest* request,
+  crucible::quant::MultiPayoffMonteCarloResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  if (request->payoffs_size() == 0 || request->payoffs_size() > kMaxPayoffLegs) {
+    return grpc::Status(
+      grpc::StatusCode::INVALID_ARGUMENT,
+      "payoffs must hold between 1 and " + std::to_string(kMaxPayoffLegs) + " legs");
+  }
+  const std::uint32_t steps = request->steps() == 0U ? 252U : request->steps();
+  const std::uint32_t paths = request->paths() == 0U ? 10'000U : request->paths();
+  if (steps > kMaxPathSteps || std::uint64_t{steps} * paths > kMaxPathSimulatedSteps) {
+    return grpc::Status(
+      grpc::StatusCode::INVALID_ARGUMENT,
+      "steps must be at most " + std::to_string(kMaxPathSteps) + " and steps x paths at most " +
+        std::to_string(kMaxPathSimulatedSteps));
+  }
+  const OptionInput option = sanitize_option(option_from_proto(request->option()));
+  std::unique_ptr<PathModel> model;
+  if (const auto status = path_model_from_request(*request, option, model); !status.ok()) {
+    return status;
+  }
+
+  std::vector<std::unique_ptr<PathPayoff>> owned;
+  std::vector<const PathPayoff*> payoffs;
+  owned.reserve(static_cast<std::size_t>(request->payoffs_size()));
+  for (const auto& leg : request->payoffs()) {
+    if (leg.payoff().type() == crucible::quant::PATH_PAYOFF_BARRIER && leg.payoff().barrier() <= 0.0) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "barrier must be positive");
+    }
+    OptionInput leg_option = option;
+    leg_option.strike = std::max(leg.strike(), 0.0);
+    leg_option.is_call = leg.is_call();
+    std::string payoff_error;
+    owned.push_back(path_payoff_from_proto(leg_option, leg.payoff(), &payoff_error));
+    if (!owned.back()) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, payoff_error);
+    }
+    payoffs.push_back(owned.back().get());
+  }
+
+  const auto result = path_monte_carlo_price_many(
+    *model,
+    TimeGrid::uniform(option.time_to_maturity, steps),
+    payoffs,
+    paths,
+    request->seed(),
+    request->covariance());
+  for (const auto& price : result.prices) {
+    auto* estimate = response->add_estimates();
+    estimate->set_price(price.price);
+    estimate->set_standard_error(price.standard_error);
+  }
+  response->mutable_covariance()->Add(result.covariance.begin(), result.covariance.end());
+  response->set_paths(result.paths);
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::SubmitMonteCarloJob(
+  grpc::ServerContext*,
+  const crucible::quant::MonteCarloJobRequest* request,
+  crucible::quant::JobHandle* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  const auto& mc = request->request();
+  if (mc.greeks()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "greeks are not available for jobs");
+  }
+  const OptionInput option = sanitize_option(option_from_proto(mc.option()));
+  const double target = mc.target_standard_error();
+  const std::uint64_t paths = target > 0.0
+    ? (mc.max_paths() == 0U ? 10'000'000U : mc.max_paths())
+    : (mc.paths() == 0U ? 10'000U : mc.paths());
+  const std::uint64_t seed = mc.seed();
+  if (paths > kMaxJobPaths) {
+    return grpc::Status(
+      grpc::StatusCode::INVALID_ARGUMENT, "paths and max_paths must be at most " + std::to_string(kMaxJobPaths));
+  }
+
+  JobOptions options{.target_paths = paths, .cancel_on_disconnect = !request->detached()};
+  if (!request->detached()) {
+    options.abandon_after = kUnwatchedJobGrace;
+  }
+  if (request->deadline_ms() > 0U) {
+    options.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(request->deadline_ms());
+  }
+  const auto id = jobs_.submit(
+    options,
+    [option, paths, seed, target](std::stop_token stop, const JobManager::Report& report) {
+      MonteCarloRunConfig config{.target_standard_error = target, .stop = stop};
+      config.checkpoint = [&report](const MonteCarloResult& running) {
+        report(running);
+        return true;
+      };
+      return monte_carlo_price_checkpointed(option, paths, seed, config);
+    });
+  if (!id) {
+    return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "too many running jobs");
+  }
+  response->set_job_id(*id);
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::WatchJob(
+  grpc::ServerContext* context,
+  const crucible::quant::JobHandle* request,
+  grpc::ServerWriter<crucible::quant::JobProgress>* writer) {
+  if (request == nullptr || writer == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/writer must not be null");
+  }
+  const std::uint64_t id = request->job_id();
+  std::optional<std::uint64_t> written;
+  for (;;) {
+    const auto snapshot = jobs_.wait_for_update(id, written.value_or(0U), std::chrono::milliseconds(250));
+    if (!snapshot) {
+      return grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown job id");
+    }
+    // Poll for disconnects between checkpoints so abandoned jobs free their cores.
+    if (context != nullptr && context->IsCancelled()) {
+      if (snapshot->cancel_on_disconnect) {
+        jobs_.cancel(id);
+      }
+      return grpc::Status(grpc::StatusCode::CANCELLED, "client disconnected");
+    }
+    if (written && snapshot->version == *written) {
+      continue;
+    }
+    crucible::quant::JobProgress progress;
+    job_progress_to_proto(*snapshot, &progress);
+    if (!writer->Write(progress)) {
+      if (snapshot->cancel_on_disconnect) {
+        jobs_.cancel(id);
+      }
+      return grpc::Status(grpc::StatusCode::CANCELLED, "client disconnected");
+    }
+    written = snapshot->version;
+    if (snapshot->state != JobState::running) {
+      return grpc::Status::OK;
+    }
+  }
+}
+
+grpc::Status QuantGrpcService::CancelJob(
+  grpc::ServerContext*,
+  const crucible::quant::JobHandle* request,
+  crucible::quant::JobProgress* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  jobs_.cancel(request->job_id());
+  const auto snapshot = jobs_.snapshot(request->job_id());
+  if (!snapshot) {
+    return grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown job id");
+  }
+  job_progress_to_proto(*snapshot, response);
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::CacheStats(
+  grpc::ServerContext*,
+  const crucible::quant::CacheStatsRequest* request,
+  crucible::quant::CacheStatsResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  const auto stats = result_cache_.stats();
+  response->set_hits(stats.hits);
+  response->set_misses(stats.misses);
+  response->set_insertions(stats.insertions);
+  response->set_evictions(stats.evictions);
+  response->set_entries(stats.entries);
+  response->set_bytes(stats.bytes);
+  response->set_persisted_bytes(stats.persisted_bytes);
+  response->set_coalesced(in_flight_.stats().followers);
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::PriceBatch(
+  grpc::ServerContext*,
+  const crucible::quant::PriceBatchRequest* request,
+  crucible::quant::PriceBatchResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  if (const auto error = price_batch(*request, response); !error.empty()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, error);
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::GreeksBatch(
+  grpc::ServerContext*,
+  const crucible::quant::PriceBatchRequest* request,
+  crucible::quant::GreeksBatchResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  if (const auto error = greeks_batch(*request, response); !error.empty()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, error);
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::ImpliedVolBatch(
+  grpc::ServerContext*,
+  const crucible::quant::ImpliedVolBatchRequest* request,
+  crucible::quant::ImpliedVolBatchResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  if (const auto error = implied_vol_batch(*request, response); !error.empty()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, error);
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status RepriceSession::apply(
+  const crucible::quant::RepriceRequest& request, crucible::quant::RepriceResponse* response, bool* respond) {
+  *respond = false;
+  response->Clear();
+  if (request.has_register_book()) {
+    const auto& spec = request.register_book();
+    OptionColumns columns{};
+    if (const auto error = option_columns_from_proto(spec.options(), true, columns); !error.empty()) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, error);
+    }
+    if (spec.underlyings_size() != 0 && static_cast<std::size_t>(spec.underlyings_size()) != columns.size) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "underlyings must be empty or one per option");
+    }
+    const std::vector<std::uint32_t> underlyings(spec.underlyings().begin(), spec.underlyings().end());
+    if (std::any_of(underlyings.begin(), underlyings.end(), [](std::uint32_t id) { return id >= kMaxUnderlyingIds; })) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "underlying ids must be below 1000000");
+    }
+    const std::uint64_t id = next_book_id_++;
+    auto& book = books_.try_emplace(id, columns, underlyings, spec.tolerance()).first->second;
+    response->set_book_id(id);
+    set_book_changes(book.reprice(), response);
+    *respond = true;
+  } else if (request.has_update()) {
+    const auto& update = request.update();
+    const auto found = books_.find(update.book_id());
+    if (found == books_.end()) {
+      return grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown book id");
+    }
+    if (update.spot_underlyings_size() != update.spots_size() ||
+        update.vol_options_size() != update.volatilities_size()) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "update pairs must have matching lengths");
+    }
+    OptionBook& book = found->second;
+    for (int i = 0; i < update.spots_size(); ++i) {
+      if (!book.set_spot(update.spot_underlyings(i), update.spots(i))) {
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "unknown underlying in update");
+      }
+    }
+    for (int i = 0; i < update.volatilities_size(); ++i) {
+      if (!book.set_volatility(update.vol_options(i), update.volatilities(i))) {
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "unknown option in update");
+      }
+    }
+    const auto& changes = book.reprice();
+    if (changes.size() != 0U) {
+      response->set_book_id(update.book_id());
+      response->set_sequence(update.sequence());
+      set_book_changes(changes, response);
+      *respond = true;
+    }
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::Reprice(
+  grpc::ServerContext*,
+  grpc::ServerReaderWriter<crucible::quant::RepriceResponse, crucible::quant::RepriceRequest>* stream) {
+  if (stream == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "stream must not be null");
+  }
+  RepriceSession session;
+  crucible::quant::RepriceRequest request;
+  crucible::quant::RepriceResponse response;
+  while (stream->Read(&request)) {
+    bool respond = false;
+    if (const auto status = session.apply(request, &response, &respond); !status.ok()) {
+      return status;
+    }
+    if (respond && !stream->Write(response)) {
+      break;
+    }
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::MicroBatchStats(
+  grpc::ServerContext*,
+  const crucible::quant::MicroBatchStatsRequest* request,
+  crucible::quant::MicroBatchStatsResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  if (!micro_batcher_) {
+    return grpc::Status::OK;
+  }
+  const auto stats = micro_batcher_->stats();
+  response->set_enabled(true);
+  response->set_batches(stats.batches);
+  response->set_calls(stats.calls);
+  response->set_max_batch_size(stats.max_batch_size);
+  response->mutable_batch_size_histogram()->Add(stats.batch_size_histogram.begin(), stats.batch_size_histogram.end());
+  response->set_total_queue_delay_ns(stats.total_queue_delay_ns);
+  response->set_max_queue_delay_ns(stats.max_queue_delay_ns);
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::AttachSharedMemory(
+  grpc::ServerContext*,
+  const crucible::quant::AttachSharedMemoryRequest* request,
+  crucible::quant::AttachSharedMemoryResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  if (!shared_memory_) {
+    return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, "shared-memory transport is disabled");
+  }
+  std::string error;
+  std::shared_ptr<SharedRegion> region = SharedRegion::open(request->name(), &error);
+  if (!region) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, error);
+  }
+  response->set_capacity(region->capacity());
+  std::lock_guard<std::mutex> lock(regions_mutex_);
+  const std::uint64_t id = next_region_id_++;
+  regions_.emplace(id, std::move(region));
+  response->set_region_id(id);
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::DetachSharedMemory(
+  grpc::ServerContext*,
+  const crucible::quant::DetachSharedMemoryRequest* request,
+  crucible::quant::DetachSharedMemoryResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  std::lock_guard<std::mutex> lock(regions_mutex_);
+  if (regions_.erase(request->region_id()) == 0U) {
+    return grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown region_id");
+  }
+  return grpc::Status::OK;
+}
+
+grpc::Status QuantGrpcService::SharedBatch(
+  grpc::ServerContext*,
+  const crucible::quant::SharedBatchRequest* request,
+  crucible::quant::SharedBatchResponse* response) {
+  if (request == nullptr || response == nullptr) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "request/response must not be null");
+  }
+  std::shared_ptr<SharedRegion> region;
+  {
+    std::lock_guard<std::mutex> lock(regions_mutex_);
+    const auto found = regions_.find(request->region_id());
+    if (found == regions_.end()) {
+      return grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown region_id");
+    }
+    region = found->second;
+  }
+  SharedBatchKind kind = SharedBatchKind::price;
+  switch (request->kind()) {
+    case crucible::quant::SHARED_BATCH_PRICE: kind = SharedBatchKind::price; break;
+    case crucible::quant::SHARED_BATCH_GREEKS: kind = SharedBatchKind::greeks; break;
+    case crucible::quant::SHARED_BATCH_IMPLIED_VOL: kind = SharedBatchKind::implied_volatility; break;
+    default: return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "unknown batch kind");
+  }
+  const quant::SharedBatch batch{
+    .kind = kind,
+    .count = request->count(),
+    .spot = request->spots(),
+    .strike = request->strikes(),
+    .rate = request->rates(),
+    .volatility = request->volatilities(),
+    .time_to_maturity = request->maturities(),
+    .dividend_yield = request->has_dividends() ? std::optional<std::uint64_t>(request->dividends()) : std::nullopt,
+    .is_call = request->is_call(),
+    .target_price = request->target_prices(),
+    .price = request->prices(),
+    .delta = request->deltas(),
+    .gamma = request->gammas(),
+    .vega = request->vegas(),
+    .theta = request->thetas(),
+    .rho = request->rhos(),
+    .implied_volatility = request->implied_volatilities(),
+    .converged = request->converged(),
+    .iterations = request->iterations(),
+  };
+  if (const auto error = run_shared_batch(*region, batch); !error.empty()) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, error);
+  }
   return grpc::Status::OK;
 }
 
@@ -0,0 +1,76 @@
+#include "quant/heston.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "quant/fourier.hpp"
+
+namespace quant {
+
+std::complex<double> heston_characteristic_function(
+  const OptionInput& option,
+  const HestonParameters& heston,
+  std::complex<double> u) {
+  const std::complex<double> i(0.0, 1.0);
+  const double T = option.time_to_maturity;
+  const double kappa = heston.mean_reversion;
+  const double theta = heston.long_run_variance;
+  const double xi = heston.vol_of_vol;
+  const double rho = heston.correlation;
+
+  const std::complex<double> beta = kappa - rho * xi * i * u;
+  const std::complex<double> d = std::sqrt(beta * beta + xi * xi * (i * u + u * u));
+  const std::complex<double> g = (beta - d) / (beta + d);
+  const std::complex<double> decay = std::exp(-d * T);
+  const std::complex<double> C = (option.rate - option.dividend_yield) * i * u * T
+    + kappa * theta / (xi * xi) * ((beta - d) * T - 2.0 * std::log((1.0 - g * decay) / (1.0 - g)));
+  const std::complex<double> D = (beta - d) / (xi * xi) * (1.0 - decay) / (1.0 - g * decay);
+  return std::exp(C + D * heston.initial_variance + i * u * std::log(option.spot));
+}
+
+double heston_price(const OptionInput& option, const HestonParameters& heston) {
+  return characteristic_function_price(
+    [&](std::complex<double> u) { return heston_characteristic_function(option, heston, u); },
+    option);
+}
+
+HestonPathModel::HestonPathModel(const OptionInput& option, const HestonParameters& heston)
+  : spot_(option.spot),
+    rate_(option.rate),
+    dividend_yield_(option.dividend_yield),
+    heston_(heston) {
+  // The QE step divides by both; keep them away from zero.
+  heston_.mean_reversion = std::max(heston_.mean_reversion, 1e-8);
+  heston_.vol_of_vol = std::max(heston_.vol_of_vol, 1e-8);
+}
+
+std::unique_ptr<PathModel> HestonPathModel::clone() const {
+  return std::make_unique<HestonPathModel>(*this);
+}
+
+void HestonPathModel::begin(std::size_t size) {
+  variance_.assign(size, std::max(heston_.initial_variance, 0.0));
+}
+
+void HestonPathModel::advance(
+  const PathStep& step,
+  const double* previous,
+  double* next,
+  double* step_variance) {
+  const HestonStep<double> constants = heston_step(
+    heston_.mean_reversion,
+    heston_.long_run_variance,
+    heston_.vol_of_vol,
+    heston_.correlation,
+    rate_ - dividend_yield_,
+    step.dt);
+  const double* zv = step.normals;
+  const double* zs = step.normals + step.size;
+  for (std::size_t i = 0; i < step.size; ++i) {
+    const double v = variance_[i];
+    next[i] = previous[i] * std::exp(heston_qe_step(constants, variance_[i], zv[i], zs[i]));
+    step_variance[i] = 0.5 * step.dt * (v + variance_[i]);
+  }
+}
+
+}  // namespace quant
@@ -0,0 +1,185 @@
+#include "quant/job_manager.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace quant {
+
+JobManager::JobManager(std::size_t max_retained, std::size_t max_running)
+  : max_retained_(max_retained),
+    max_running_(max_running),
+    deadline_watcher_([this](std::stop_token stop) { watch_deadlines(stop); }) {}
+
+JobManager::~JobManager() {
+  std::map<std::uint64_t, std::unique_ptr<Job>> jobs;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [id, job] : jobs_) {
+      job->stop.request_stop();
+    }
+    jobs.swap(jobs_);
+  }
+  // Workers still report under mutex_, so join without holding it.
+  jobs.clear();
+  deadline_watcher_.request_stop();
+  deadline_watcher_.join();
+}
+
+std::optional<std::uint64_t> JobManager::submit(const JobOptions& options, Work work) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_ >= max_running_) {
+    return std::nullopt;
+  }
+  ++running_;
+  const std::uint64_t id = next_id_++;
+  auto job = std::make_unique<Job>();
+  job->snapshot = JobSnapshot{
+    .id = id,
+    .state = JobState::running,
+    .progress = MonteCarloResult{.price = 0.0, .standard_error = 0.0, .paths = 0U},
+    .target_paths = options.target_paths,
+    .version = 0U,
+    .cancel_on_disconnect = options.cancel_on_disconnect,
+    .error = {},
+  };
+  job->deadline = options.deadline;
+  job->abandon_after = options.abandon_after;
+  job->last_polled = std::chrono::steady_clock::now();
+  Job* raw = job.get();
+  jobs_.emplace(id, std::move(job));
+  if (options.deadline || options.abandon_after) {
+    deadlines_changed_ = true;
+    deadline_changed_.notify_all();
+  }
+  evict_finished();
+  raw->worker = std::jthread([this, raw, work = std::move(work)] { run(raw, work); });
+  return id;
+}
+
+std::optional<JobSnapshot> JobManager::snapshot(std::uint64_t id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto found = jobs_.find(id);
+  if (found == jobs_.end()) {
+    return std::nullopt;
+  }
+  found->second->last_polled = std::chrono::steady_clock::now();
+  return found->second->snapshot;
+}
+
+std::optional<JobSnapshot> JobManager::wait_for_update(
+  std::uint64_t id,
+  std::uint64_t seen_version,
+  std::chrono::milliseconds timeout) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  updated_.wait_for(lock, timeout, [&] {
+    const auto found = jobs_.find(id);
+    return found == jobs_.end() || found->second->snapshot.version > seen_version;
+  });
+  const auto found = jobs_.find(id);
+  if (found == jobs_.end()) {
+    return std::nullopt;
+  }
+  found->second->last_polled = std::chrono::steady_clock::now();
+  return found->second->snapshot;
+}
+
+bool JobManager::cancel(std::uint64_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto found = jobs_.find(id);
+  if (found == jobs_.end() || found->second->snapshot.state != JobState::running) {
+    return false;
+  }
+  found->second->stop.request_stop();
+  return true;
+}
+
+void JobManager::run(Job* job, const Work& work) {
+  const std::stop_token stop = job->stop.get_token();
+  const Report report = [this, job](const MonteCarloResult& progress) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job->snapshot.progress = progress;
+    ++job->snapshot.version;
+    updated_.notify_all();
+  };
+
+  std::optional<MonteCarloResult> result;
+  std::string error;
+  try {
+    result = work(stop, report);
+  } catch (const std::exception& e) {
+    error = e.what();
+  } catch (...) {
+    error = "unknown error";
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  JobSnapshot& snapshot = job->snapshot;
+  if (!result) {
+    snapshot.state = JobState::failed;
+    snapshot.error = error.empty() ? "job failed" : error;
+  } else {
+    snapshot.progress = *result;
+    if (job->deadline_hit) {
+      snapshot.state = JobState::deadline_exceeded;
+    } else if (stop.stop_requested()) {
+      snapshot.state = JobState::cancelled;
+    } else {
+      snapshot.state = JobState::completed;
+    }
+  }
+  ++snapshot.version;
+  --running_;
+  updated_.notify_all();
+}
+
+void JobManager::watch_deadlines(std::stop_token stop) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop.stop_requested()) {
+    const auto now = std::chrono::steady_clock::now();
+    auto next = std::chrono::steady_clock::time_point::max();
+    for (auto& [id, job] : jobs_) {
+      if (job->snapshot.state != JobState::running || job->stop.stop_requested()) {
+        continue;
+      }
+      if (job->deadline && *job->deadline <= now) {
+        job->deadline_hit = true;
+        job->stop.request_stop();
+        continue;
+      }
+      if (job->abandon_after && job->last_polled + *job->abandon_after <= now) {
+        job->stop.request_stop();
+        continue;
+      }
+      if (job->deadline) {
+        next = std::min(next, *job->deadline);
+      }
+      if (job->abandon_after) {
+        // Polls push this back; waking early just recomputes it.
+        next = std::min(next, job->last_polled + *job->abandon_after);
+      }
+    }
+    const auto changed = [this] { return std::exchange(deadlines_changed_, false); };
+    if (next == std::chrono::steady_clock::time_point::max()) {
+      deadline_changed_.wait(lock, stop, changed);
+    } else {
+      deadline_changed_.wait_until(lock, stop, next, changed);
+    }
+  }
+}
+
+void JobManager::evict_finished() {
+  std::vector<std::uint64_t> finished;
+  for (const auto& [id, job] : jobs_) {
+    if (job->snapshot.state != JobState::running) {
+      finished.push_back(id);
+    }
+  }
+  // Map order is submission order, so the oldest finished jobs go first.
+  for (std::size_t i = 0; i + max_retained_ < finished.size(); ++i) {
+    jobs_.erase(finished[i]);
+  }
+}
+
+}  // namespace quant
@@ -0,0 +1,205 @@
+#include "quant/jump_diffusion.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "quant/fourier.hpp"
+
+namespace quant {
+
+namespace {
+
+double merton_compensator(const MertonJumpParameters& jumps) {
+  return std::exp(jumps.mean_jump + 0.5 * jumps.jump_volatility * jumps.jump_volatility) - 1.0;
+}
+
+double kou_compensator(const KouJumpParameters& jumps) {
+  const double p = jumps.up_probability;
+  return p * jumps.up_rate / (jumps.up_rate - 1.0) + (1.0 - p) * jumps.down_rate / (jumps.down_rate + 1.0) - 1.0;
+}
+
+// Log-spot characteristic function of a compensated jump diffusion given
+// the log jump-size transform psi(u) = E[exp(i u J)].
+std::complex<double> jump_diffusion_characteristic_function(
+  const OptionInput& option,
+  double intensity,
+  double compensator,
+  std::complex<double> psi,
+  std::complex<double> u) {
+  const std::complex<double> i(0.0, 1.0);
+  const double T = option.time_to_maturity;
+  const double sigma = option.volatility;
+  const double drift = option.rate - option.dividend_yield - 0.5 * sigma * sigma - intensity * compensator;
+  return std::exp(
+    i * u * (std::log(option.spot) + drift * T) - 0.5 * sigma * sigma * u * u * T + intensity * T * (psi - 1.0));
+}
+
+}  // namespace
+
+double merton_price(
+  const OptionInput& option,
+  const MertonJumpParameters& jumps,
+  double tolerance,
+  std::size_t max_terms) {
+  const double T = std::max(option.time_to_maturity, 0.0);
+  const double intensity = std::max(jumps.intensity, 0.0);
+  const double compensator = merton_compensator(jumps);
+  const double mean = intensity * (1.0 + compensator) * T;  // lambda' T
+  const double log_growth = std::log1p(compensator);
+  const double forward_cap = option.spot * std::exp(-option.dividend_yield * T);
+
+  // Each term is a call on the n-jump conditional lognormal, bounded by the
+  // dividend-discounted spot, so the tail mass bounds the truncation error.
+  OptionInput term = option;
+  term.is_call = true;
+  double call = 0.0;
+  double mass = 0.0;
+  for (std::size_t n = 0; n < std::max<std::size_t>(max_terms, 1U); ++n) {
+    const double count = static_cast<double>(n);
+    const double weight = mean > 0.0
+      ? std::exp(-mean + count * std::log(mean) - std::lgamma(count + 1.0))
+      : (n == 0U ? 1.0 : 0.0);
+    if (T > 0.0) {
+      term.volatility = std::sqrt(
+        option.volatility * option.volatility + count * jumps.jump_volatility * jumps.jump_volatility / T);
+      term.rate = option.rate - intensity * compensator + count * log_growth / T;
+    }
+    call += weight * black_scholes(term).price;
+    mass += weight;
+    if (count >= mean && std::max(1.0 - mass, 0.0) * forward_cap < tolerance) {
+      break;
+    }
+  }
+
+  if (option.is_call) {
+    return call;
+  }
+  return call - forward_cap + option.strike * std::exp(-option.rate * T);
+}
+
+std::complex<double> merton_characteristic_function(
+  const OptionInput& option,
+  const MertonJumpParameters& jumps,
+  std::complex<double> u) {
+  const std::complex<double> i(0.0, 1.0);
+  const double delta = jumps.jump_volatility;
+  const std::complex<double> psi = std::exp(i * u * jumps.mean_jump - 0.5 * delta * delta * u * u);
+  return jump_diffusion_characteristic_function(option, jumps.intensity, merton_compensator(jumps), psi, u);
+}
+
+std::complex<double> kou_characteristic_function(
+  const OptionInput& option,
+  const KouJumpParameters& jumps,
+  std::complex<double> u) {
+  const std::complex<double> i(0.0, 1.0);
+  const double p = jumps.up_probability;
+  const std::complex<double> psi =
+    p * jumps.up_rate / (jumps.up_rate - i * u) + (1.0 - p) * jumps.down_rate / (jumps.down_rate + i * u);
+  return jump_diffusion_characteristic_function(option, jumps.intensity, kou_compensator(jumps), psi, u);
+}
+
+double kou_price(const OptionInput& option, const KouJumpParameters& jumps) {
+  return characteristic_function_price(
+    [&](std::complex<double> u) { return kou_characteristic_function(option, jumps, u); },
+    option);
+}
+
+JumpDiffusionPathModel::JumpDiffusionPathModel(const OptionInput& option, const MertonJumpParameters& jumps)
+  : spot_(option.spot),
+    rate_(option.rate),
+    dividend_yield_(option.dividend_yield),
+    volatility_(option.volatility),
+    law_(JumpLaw::lognormal),
+    merton_(jumps),
+    intensity_(std::max(jumps.intensity, 0.0)),
+    compensator_(merton_compensator(jumps)) {}
+
+JumpDiffusionPathModel::JumpDiffusionPathModel(const OptionInput& option, const KouJumpParameters& jumps)
+  : spot_(option.spot),
+    rate_(option.rate),
+    dividend_yield_(option.dividend_yield),
+    volatility_(option.volatility),
+    law_(JumpLaw::double_exponential),
+    kou_(jumps),
+    intensity_(std::max(jumps.intensity, 0.0)),
+    compensator_(kou_compensator(jumps)) {}
+
+std::unique_ptr<PathModel> JumpDiffusionPathModel::clone() const {
+  return std::make_unique<JumpDiffusionPathModel>(*this);
+}
+
+void JumpDiffusionPathModel::begin(std::size_t size) { log_jumps_.resize(size); }
+
+double JumpDiffusionPathModel::jump_sum(RandomStream& rng, std::size_t count) const {
+  if (law_ == JumpLaw::lognormal) {
+    // A sum of n normal log jumps is N(n mu, n delta^2).
+    double z = 0.0;
+    rng.fill_normals(&z, 1U);
+    const double n = static_cast<double>(count);
+    return n * merton_.mean_jump + std::sqrt(n) * merton_.jump_volatility * z;
+  }
+  double sum = 0.0;
+  for (std::size_t j = 0; j < count; ++j) {
+    const bool up = rng.next_uniform() < kou_.up_probability;
+    const double size = -std::log(rng.next_uniform());
+    sum += up ? size / kou_.up_rate : -size / kou_.down_rate;
+  }
+  return sum;
+}
+
+bool JumpDiffusionPathModel::draw_log_jumps(double dt, RandomStream& rng, double* out, std::size_t size) const {
+  if (intensity_ <= 0.0) {
+    return false;
+  }
+  const double rate = intensity_ * dt;
+  const double no_jump = std::exp(-rate);
+  for (std::size_t i = 0; i < size; ++i) {
+    // Poisson count by inversion: P(N = k) = P(N = k - 1) * lambda dt / k.
+    // Stops once the remaining terms vanish, so rounding in the cumulative
+    // sum cannot run away when u is within an ulp of 1.
+    const double u = rng.next_uniform();
+    std::size_t count = 0;
+    double probability = no_jump;
+    double cumulative = probability;
+    while (u > cumulative) {
+      const double next_probability = probability * rate / static_cast<double>(count + 1U);
+      if (static_cast<double>(count) > rate && next_probability < 1e-18) {
+        break;
+      }
+      ++count;
+      probability = next_probability;
+      cumulative += probability;
+    }
+    out[i] = count > 0U ? jump_sum(rng, count) : 0.0;
+  }
+  return true;
+}
+
+void JumpDiffusionPathModel::advance(
+  const PathStep& step,
+  const double* previous,
+  double* next,
+  double* step_variance) {
+  const double variance = volatility_ * volatility_ * step.dt;
+  const double diffusion = std::sqrt(variance);
+  const double* z = step.normals;
+  // Without supplied jumps or a block stream to draw them from, no jumps
+  // occur; fall back to plain GBM.
+  const double* log_jumps = step.log_jumps;
+  if (log_jumps == nullptr && step.rng != nullptr) {
+    log_jumps_.resize(step.size);
+    if (draw_log_jumps(step.dt, *step.rng, log_jumps_.data(), step.size)) {
+      log_jumps = log_jumps_.data();
+    }
+  }
+  const double compensator = log_jumps != nullptr ? intensity_ * compensator_ * step.dt : 0.0;
+  const double drift = (rate_ - dividend_yield_) * step.dt - 0.5 * variance - compensator;
+
+  for (std::size_t i = 0; i < step.size; ++i) {
+    const double log_jump = log_jumps != nullptr ? log_jumps[i] : 0.0;
+    next[i] = previous[i] * std::exp(drift + diffusion * z[i] + log_jump);
+    step_variance[i] = variance;
+  }
+}
+
+}  // namespace quant
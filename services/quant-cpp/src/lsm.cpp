@@ -0,0 +1,314 @@
+#include "quant/lsm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "quant/parallel.hpp"
+
+namespace quant {
+
+namespace {
+
+constexpr std::size_t kMaxBasisDegree = 8;
+// Seed offset that keeps out-of-sample paths independent of the regression set.
+constexpr std::uint64_t kPricingStreamOffset = 1ULL << 40U;
+
+double exercise_value(double spot, double strike, bool is_call) {
+  return is_call ? std::max(spot - strike, 0.0) : std::max(strike - spot, 0.0);
+}
+
+double continuation(const std::vector<double>& beta, double x) {
+  double value = 0.0;
+  for (std::size_t k = beta.size(); k-- > 0;) {
+    value = value * x + beta[k];
+  }
+  return value;
+}
+
+// Records the spot at each exercise date into a dates x paths matrix.
+class ExerciseRecorder final : public PathPayoff {
+ public:
+  ExerciseRecorder(const std::vector<std::size_t>& steps, double* spots, std::uint64_t stride)
+    : steps_(steps), spots_(spots), stride_(stride) {}
+
+  std::unique_ptr<PathPayoff> clone() const override {
+    return std::make_unique<ExerciseRecorder>(*this);
+  }
+
+  void begin(std::size_t, double) override { next_ = 0; }
+
+  void observe(const PathObservation& observation) override {
+    if (next_ < steps_.size() && observation.step == steps_[next_]) {
+      std::copy(observation.current, observation.current + observation.size, spots_ + next_ * stride_);
+      ++next_;
+    }
+  }
+
+  void settle(double* payoffs, std::size_t size) override {
+    std::fill(payoffs, payoffs + size, 0.0);
+  }
+
+ private:
+  const std::vector<std::size_t>& steps_;
+  double* spots_;
+  std::uint64_t stride_;
+  std::size_t next_ = 0;
+};
+
+// Applies a fitted exercise policy; cash flows are rolled forward to maturity
+// so the engine's single maturity discount prices them correctly.
+class LsmExercisePayoff final : public PathPayoff {
+ public:
+  LsmExercisePayoff(
+    const std::vector<std::size_t>& steps,
+    const std::vector<std::vector<double>>& coefficients,
+    double strike,
+    bool is_call,
+    double rate,
+    double maturity)
+    : steps_(steps),
+      coefficients_(coefficients),
+      strike_(strike),
+      is_call_(is_call),
+      rate_(rate),
+      maturity_(maturity) {}
+
+  std::unique_ptr<PathPayoff> clone() const override {
+    return std::make_unique<LsmExercisePayoff>(*this);
+  }
+
+  void begin(std::size_t size, double) override {
+    next_ = 0;
+    cash_.assign(size, 0.0);
+    alive_.assign(size, 1U);
+  }
+
+  void observe(const PathObservation& observation) override {
+    if (next_ >= steps_.size() || observation.step != steps_[next_]) {
+      return;
+    }
+    const bool last = next_ + 1U == steps_.size();
+    const double growth = std::exp(rate_ * (maturity_ - observation.time));
+    for (std::size_t i = 0; i < observation.size; ++i) {
+      if (alive_[i] == 0U) {
+        continue;
+      }
+      const double spot = observation.current[i];
+      const double value = exercise_value(spot, strike_, is_call_);
+      if (value <= 0.0) {
+        continue;
+      }
+      if (last || value >= continuation(coefficients_[next_], spot / strike_)) {
+        cash_[i] = value * growth;
+        alive_[i] = 0U;
+      }
+    }
+    ++next_;
+  }
+
+  void settle(double* payoffs, std::size_t size) override {
+    std::copy(cash_.begin(), cash_.begin() + static_cast<std::ptrdiff_t>(size), payoffs);
+  }
+
+ private:
+  const std::vector<std::size_t>& steps_;
+  const std::vector<std::vector<double>>& coefficients_;
+  double strike_;
+  bool is_call_;
+  double rate_;
+  double maturity_;
+  std::size_t next_ = 0;
+  std::vector<double> cash_;
+  std::vector<unsigned char> alive_;
+};
+
+// Solves the symmetric system A x = b by Cholesky. A small ridge keeps the
+// factorisation defined when few paths are in the money.
+std::vector<double> solve_normal_equations(std::vector<double> a, std::vector<double> b, std::size_t n) {
+  double trace = 0.0;
+  for (std::size_t i = 0; i < n; ++i) {
+    trace += a[i * n + i];
+  }
+  const double ridge = 1e-10 * std::max(trace, 1.0);
+  for (std::size_t i = 0; i < n; ++i) {
+    a[i * n + i] += ridge;
+  }
+
+  for (std::size_t j = 0; j < n; ++j) {
+    double diag = a[j * n + j];
+    for (std::size_t k = 0; k < j; ++k) {
+      diag -= a[j * n + k] * a[j * n + k];
+    }
+    if (diag <= 0.0) {
+      return std::vector<double>(n, 0.0);
+    }
+    const double l_jj = std::sqrt(diag);
+    a[j * n + j] = l_jj;
+    for (std::size_t i = j + 1; i < n; ++i) {
+      double value = a[i * n + j];
+      for (std::size_t k = 0; k < j; ++k) {
+        value -= a[i * n + k] * a[j * n + k];
+      }
+      a[i * n + j] = value / l_jj;
+    }
+  }
+
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t k = 0; k < i; ++k) {
+      b[i] -= a[i * n + k] * b[k];
+    }
+    b[i] /= a[i * n + i];
+  }
+  for (std::size_t i = n; i-- > 0;) {
+    for (std::size_t k = i + 1; k < n; ++k) {
+      b[i] -= a[k * n + i] * b[k];
+    }
+    b[i] /= a[i * n + i];
+  }
+  return b;
+}
+
+}  // namespace
+
+std::vector<std::size_t> exercise_steps(std::size_t steps, std::size_t dates) {
+  const std::size_t count = std::max<std::size_t>(steps, 1U);
+  std::vector<std::size_t> result;
+  if (dates == 0U || dates >= count) {
+    result.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      result[i] = i;
+    }
+    return result;
+  }
+  for (std::size_t j = 1; j <= dates; ++j) {
+    const std::size_t step = (j * count + dates - 1U) / dates - 1U;
+    if (result.empty() || result.back() != step) {
+      result.push_back(step);
+    }
+  }
+  return result;
+}
+
+LsmResult lsm_price(
+  const PathModel& model,
+  const TimeGrid& grid,
+  const std::vector<std::size_t>& exercise_steps,
+  double strike,
+  bool is_call,
+  const LsmConfig& config) {
+  const std::uint64_t paths = config.regression_paths;
+  if (paths == 0U || config.pricing_paths == 0U || grid.steps() == 0U || exercise_steps.empty()
+      || exercise_steps.back() != grid.steps() - 1U || exercise_steps.size() > kMaxRegressionValues / paths) {
+    return LsmResult{.price = 0.0, .standard_error = 0.0, .in_sample_price = 0.0, .paths = 0U};
+  }
+
+  const std::size_t dates = exercise_steps.size();
+  const std::size_t basis = std::min(config.basis_degree, kMaxBasisDegree) + 1U;
+  const std::uint64_t block = std::max<std::size_t>(config.block_paths, 1U);
+  const std::size_t blocks = static_cast<std::size_t>((paths + block - 1U) / block);
+  const double rate = model.discount_rate();
+
+  // Regression set: spot at every exercise date, one contiguous row per date.
+  std::vector<double> spots(dates * paths);
+  parallel_for(blocks, [&](std::size_t b) {
+    const std::uint64_t offset = b * block;
+    const auto size = static_cast<std::size_t>(std::min(block, paths - offset));
+    auto block_model = model.clone();
+    ExerciseRecorder recorder(exercise_steps, spots.data() + offset, paths);
+    RandomStream rng(config.seed, b);
+    PathBlockBuffers buffers;
+    simulate_path_block(*block_model, grid, recorder, rng, size, buffers);
+  });
+
+  // Backward induction. `cash` holds each path's cash flow valued at the
+  // current exercise date under the policy fitted so far.
+  std::vector<double> cash(paths);
+  const double* last_row = spots.data() + (dates - 1U) * paths;
+  for (std::uint64_t i = 0; i < paths; ++i) {
+    cash[i] = exercise_value(last_row[i], strike, is_call);
+  }
+
+  std::vector<std::vector<double>> coefficients(dates, std::vector<double>(basis, 0.0));
+  const std::size_t terms = basis * basis + basis;
+  std::vector<double> partials(blocks * terms);
+
+  for (std::size_t j = dates - 1U; j-- > 0;) {
+    const double t_j = grid.times[exercise_steps[j]];
+    const double t_next = grid.times[exercise_steps[j + 1U]];
+    const double step_discount = std::exp(-rate * (t_next - t_j));
+    const double* row = spots.data() + j * paths;
+
+    parallel_for(blocks, [&](std::size_t b) {
+      const std::uint64_t begin = b * block;
+      const std::uint64_t end = std::min(begin + block, paths);
+      double* a = partials.data() + b * terms;
+      double* rhs = a + basis * basis;
+      std::fill(a, a + terms, 0.0);
+      double phi[kMaxBasisDegree + 1];
+      for (std::uint64_t i = begin; i < end; ++i) {
+        cash[i] *= step_discount;
+        if (exercise_value(row[i], strike, is_call) <= 0.0) {
+          continue;
+        }
+        const double x = row[i] / strike;
+        phi[0] = 1.0;
+        for (std::size_t k = 1; k < basis; ++k) {
+          phi[k] = phi[k - 1] * x;
+        }
+        for (std::size_t r = 0; r < basis; ++r) {
+          for (std::size_t c = 0; c <= r; ++c) {
+            a[r * basis + c] += phi[r] * phi[c];
+          }
+          rhs[r] += phi[r] * cash[i];
+        }
+      }
+    });
+
+    std::vector<double> a(basis * basis, 0.0);
+    std::vector<double> rhs(basis, 0.0);
+    for (std::size_t b = 0; b < blocks; ++b) {
+      const double* partial = partials.data() + b * terms;
+      for (std::size_t k = 0; k < basis * basis; ++k) {
+        a[k] += partial[k];
+      }
+      for (std::size_t k = 0; k < basis; ++k) {
+        rhs[k] += partial[basis * basis + k];
+      }
+    }
+    for (std::size_t r = 0; r < basis; ++r) {
+      for (std::size_t c = r + 1; c < basis; ++c) {
+        a[r * basis + c] = a[c * basis + r];
+      }
+    }
+    coefficients[j] = solve_normal_equations(std::move(a), std::move(rhs), basis);
+
+    for (std::uint64_t i = 0; i < paths; ++i) {
+      const double value = exercise_value(row[i], strike, is_call);
+      if (value > 0.0 && value >= continuation(coefficients[j], row[i] / strike)) {
+        cash[i] = value;
+      }
+    }
+  }
+
+  RunningStats in_sample;
+  for (double value : cash) {
+    in_sample.add(value);
+  }
+  const double first_discount = std::exp(-rate * grid.times[exercise_steps.front()]);
+
+  // Out-of-sample pass on independent streams with the fitted policy.
+  const LsmExercisePayoff policy(exercise_steps, coefficients, strike, is_call, rate, grid.maturity());
+  const auto out_of_sample = path_monte_carlo_price(
+    model, grid, policy, config.pricing_paths,
+    config.seed + kPricingStreamOffset, block);
+
+  return LsmResult{
+    .price = out_of_sample.price,
+    .standard_error = out_of_sample.standard_error,
+    .in_sample_price = first_discount * in_sample.mean,
+    .paths = out_of_sample.paths,
+  };
+}
+
+}  // namespace quant
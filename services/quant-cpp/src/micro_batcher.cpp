@@ -0,0 +1,139 @@
+#include "quant/micro_batcher.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <utility>
+
+namespace quant {
+
+MicroBatcher::MicroBatcher(MicroBatchConfig config) : config_(config) {
+  config_.max_batch = std::max<std::size_t>(config_.max_batch, 1U);
+  max_pending_ = config_.max_batch * std::max<std::size_t>(config_.max_pending_batches, 1U);
+  const std::size_t capacity = config_.max_batch;
+  for (auto* column : {&spot_, &strike_, &rate_, &volatility_, &maturity_, &dividend_, &price_, &delta_, &gamma_,
+                       &vega_, &theta_, &rho_}) {
+    column->resize(capacity);
+  }
+  is_call_ = std::make_unique<bool[]>(capacity);
+  pending_.reserve(capacity);
+  worker_ = std::thread([this] { run(); });
+}
+
+MicroBatcher::~MicroBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  arrived_.notify_all();
+  worker_.join();
+}
+
+Admission MicroBatcher::submit(const OptionInput& option, Completion done) {
+  std::size_t waiting = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_.size() >= max_pending_) {
+      const double batches = std::ceil(static_cast<double>(pending_.size()) / static_cast<double>(config_.max_batch));
+      const double drain_ms = batches * std::chrono::duration<double, std::milli>(batch_time_).count();
+      const auto retry_ms = static_cast<std::int64_t>(std::ceil(drain_ms));
+      return Admission{
+        .admitted = false,
+        .retry_after = std::chrono::milliseconds(std::max<std::int64_t>(retry_ms, 1)),
+      };
+    }
+    pending_.push_back(Pending{option, std::move(done), std::chrono::steady_clock::now()});
+    waiting = pending_.size();
+  }
+  // Wake the batcher to start the window, or to flush a full batch.
+  if (waiting == 1U || waiting >= config_.max_batch) {
+    arrived_.notify_one();
+  }
+  return Admission{.admitted = true, .retry_after = std::chrono::milliseconds(0)};
+}
+
+MicroBatchStats MicroBatcher::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void MicroBatcher::run() {
+  std::vector<Pending> batch;
+  batch.reserve(config_.max_batch);
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      arrived_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;
+      }
+      const auto deadline = pending_.front().arrived + config_.window;
+      arrived_.wait_until(lock, deadline, [this] { return stopping_ || pending_.size() >= config_.max_batch; });
+      const std::size_t take = std::min(pending_.size(), config_.max_batch);
+      batch.assign(
+        std::make_move_iterator(pending_.begin()), std::make_move_iterator(pending_.begin() + take));
+      pending_.erase(pending_.begin(), pending_.begin() + take);
+    }
+    price(batch);
+    batch.clear();
+  }
+}
+
+void MicroBatcher::price(std::vector<Pending>& batch) {
+  const std::size_t size = batch.size();
+  const auto started = std::chrono::steady_clock::now();
+  std::uint64_t total_delay = 0;
+  std::uint64_t max_delay = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    const OptionInput& option = batch[i].option;
+    spot_[i] = option.spot;
+    strike_[i] = option.strike;
+    rate_[i] = option.rate;
+    volatility_[i] = option.volatility;
+    maturity_[i] = option.time_to_maturity;
+    dividend_[i] = option.dividend_yield;
+    is_call_[i] = option.is_call;
+    const auto delay = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(started - batch[i].arrived).count());
+    total_delay += delay;
+    max_delay = std::max(max_delay, delay);
+  }
+  const OptionColumns columns{
+    .spot = spot_.data(),
+    .strike = strike_.data(),
+    .rate = rate_.data(),
+    .volatility = volatility_.data(),
+    .time_to_maturity = maturity_.data(),
+    .dividend_yield = dividend_.data(),
+    .is_call = is_call_.get(),
+    .size = size,
+  };
+  black_scholes_greeks_batch(
+    columns, {price_.data(), delta_.data(), gamma_.data(), vega_.data(), theta_.data(), rho_.data()});
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.batches;
+    stats_.calls += size;
+    stats_.max_batch_size = std::max<std::uint64_t>(stats_.max_batch_size, size);
+    const std::size_t bucket =
+      std::min<std::size_t>(std::bit_width(size) - 1U, stats_.batch_size_histogram.size() - 1U);
+    ++stats_.batch_size_histogram[bucket];
+    stats_.total_queue_delay_ns += total_delay;
+    stats_.max_queue_delay_ns = std::max(stats_.max_queue_delay_ns, max_delay);
+  }
+  for (std::size_t i = 0; i < size; ++i) {
+    batch[i].done(OptionGreeks{
+      .price = price_[i],
+      .delta = delta_[i],
+      .gamma = gamma_[i],
+      .vega = vega_[i],
+      .theta = theta_[i],
+      .rho = rho_[i],
+    });
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - started;
+  std::lock_guard<std::mutex> lock(mutex_);
+  batch_time_ = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+}
+
+}  // namespace quant
@@ -0,0 +1,284 @@
+#include "quant/mlmc.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "quant/parallel.hpp"
+#include "quant/random.hpp"
+
+namespace quant {
+
+namespace {
+
+constexpr double kInvSqrtTwo = 0.70710678118654752440;
+
+struct LevelState {
+  std::size_t steps = 0;
+  std::uint64_t blocks_done = 0;
+  RunningStats stats;
+};
+
+// Runs `size` coupled paths: fine on `fine_steps`, coarse on half as many,
+// writing P_fine - P_coarse (or P_fine alone when coarse_steps is 0).
+void simulate_level_block(
+  const PathModel& model,
+  const PathPayoff& payoff,
+  double maturity,
+  std::size_t fine_steps,
+  bool coupled,
+  RandomStream& rng,
+  std::size_t size,
+  std::vector<double>& out) {
+  const std::size_t normals_per_step = model.normals_per_step();
+  const double fine_dt = maturity / static_cast<double>(fine_steps);
+
+  auto fine_model = model.clone();
+  auto fine_payoff = payoff.clone();
+  PathBlockBuffers fine;
+  fine.resize(size, normals_per_step);
+  const double spot = model.initial_spot();
+  std::fill(fine.current.begin(), fine.current.end(), spot);
+  fine_model->begin(size);
+  fine_payoff->begin(size, spot);
+
+  std::unique_ptr<PathModel> coarse_model;
+  std::unique_ptr<PathPayoff> coarse_payoff;
+  PathBlockBuffers coarse;
+  std::vector<double> first_normals;
+  if (coupled) {
+    coarse_model = model.clone();
+    coarse_payoff = payoff.clone();
+    coarse.resize(size, normals_per_step);
+    std::fill(coarse.current.begin(), coarse.current.end(), spot);
+    coarse_model->begin(size);
+    coarse_payoff->begin(size, spot);
+    first_normals.resize(size * normals_per_step);
+  }
+  // Jump parts, drawn once per fine step and summed for the coarse step so
+  // both levels see the same jumps.
+  std::vector<double> fine_jumps;
+  std::vector<double> coarse_jumps;
+  if (coupled) {
+    fine_jumps.resize(size);
+    coarse_jumps.resize(size);
+  }
+
+  for (std::size_t k = 0; k < fine_steps; ++k) {
+    const double time = fine_dt * static_cast<double>(k + 1U);
+    fine.previous.swap(fine.current);
+    rng.fill_normals(fine.normals.data(), size * normals_per_step);
+    const bool jumps = coupled && fine_model->draw_log_jumps(fine_dt, rng, fine_jumps.data(), size);
+    fine_model->advance(
+      PathStep{
+        .index = k,
+        .time = time,
+        .dt = fine_dt,
+        .normals = fine.normals.data(),
+        .size = size,
+        .rng = &rng,
+        .log_jumps = jumps ? fine_jumps.data() : nullptr,
+      },
+      fine.previous.data(), fine.current.data(), fine.step_variance.data());
+    fine_payoff->observe(PathObservation{
+      .step = k,
+      .time = time,
+      .dt = fine_dt,
+      .previous = fine.previous.data(),
+      .current = fine.current.data(),
+      .step_variance = fine.step_variance.data(),
+      .size = size,
+    });
+
+    if (!coupled) {
+      continue;
+    }
+    if (k % 2U == 0U) {
+      first_normals.swap(fine.normals);
+      if (jumps) {
+        coarse_jumps.swap(fine_jumps);
+      }
+      continue;
+    }
+    // Coarse increment = sum of the two fine increments, jumps included.
+    for (std::size_t j = 0; j < size * normals_per_step; ++j) {
+      coarse.normals[j] = (first_normals[j] + fine.normals[j]) * kInvSqrtTwo;
+    }
+    if (jumps) {
+      for (std::size_t i = 0; i < size; ++i) {
+        coarse_jumps[i] += fine_jumps[i];
+      }
+    }
+    const double coarse_dt = 2.0 * fine_dt;
+    const std::size_t coarse_step = k / 2U;
+    coarse.previous.swap(coarse.current);
+    coarse_model->advance(
+      PathStep{
+        .index = coarse_step,
+        .time = time,
+        .dt = coarse_dt,
+        .normals = coarse.normals.data(),
+        .size = size,
+        .rng = &rng,
+        .log_jumps = jumps ? coarse_jumps.data() : nullptr,
+      },
+      coarse.previous.data(), coarse.current.data(), coarse.step_variance.data());
+    coarse_payoff->observe(PathObservation{
+      .step = coarse_step,
+      .time = time,
+      .dt = coarse_dt,
+      .previous = coarse.previous.data(),
+      .current = coarse.current.data(),
+      .step_variance = coarse.step_variance.data(),
+      .size = size,
+    });
+  }
+
+  out.resize(size);
+  fine_payoff->settle(out.data(), size);
+  if (coupled) {
+    coarse_payoff->settle(coarse.payoffs.data(), size);
+    for (std::size_t i = 0; i < size; ++i) {
+      out[i] -= coarse.payoffs[i];
+    }
+  }
+}
+
+}  // namespace
+
+MlmcResult mlmc_price(
+  const PathModel& model,
+  double maturity,
+  const PathPayoff& payoff,
+  const MlmcConfig& config) {
+  MlmcResult result{
+    .price = 0.0,
+    .standard_error = 0.0,
+    .paths = 0U,
+    .simulated_steps = 0U,
+    .converged = false,
+    .budget_exhausted = false,
+    .levels = {},
+  };
+  if (config.target_rmse <= 0.0 || maturity <= 0.0) {
+    return result;
+  }
+
+  const std::uint64_t block = std::max<std::size_t>(config.block_paths, 1U);
+  const std::size_t base_steps = std::max<std::size_t>(config.base_steps, 1U);
+  const std::size_t max_levels = std::max<std::size_t>(config.max_levels, 2U);
+  const std::size_t min_levels = std::clamp<std::size_t>(config.min_levels, 2U, max_levels);
+  const double discount = std::exp(-model.discount_rate() * maturity);
+  const double eps2 = config.target_rmse * config.target_rmse;
+  const double budget = static_cast<double>(config.max_simulated_steps);
+  // Block counts stay in double until checked against the budget, so an
+  // allocation that would not fit in an integer is never converted.
+  const auto blocks_for = [block](double paths) {
+    return std::ceil(std::max(paths, 0.0) / static_cast<double>(block));
+  };
+
+  std::vector<LevelState> levels;
+  std::vector<double> wanted_blocks;
+  auto add_level = [&]() {
+    LevelState level;
+    level.steps = base_steps << levels.size();
+    levels.push_back(level);
+    wanted_blocks.push_back(std::max(blocks_for(static_cast<double>(config.initial_paths)), 1.0));
+  };
+  for (std::size_t l = 0; l < min_levels; ++l) {
+    add_level();
+  }
+
+  // Steps simulated per sample; a coupled sample runs fine and coarse paths.
+  auto steps_per_sample = [&](std::size_t l) {
+    return levels[l].steps + (l == 0U ? 0U : levels[l].steps / 2U);
+  };
+  auto cost = [&](std::size_t l) { return static_cast<double>(steps_per_sample(l)); };
+  auto variance = [&](std::size_t l) { return discount * discount * levels[l].stats.variance(); };
+  auto mean = [&](std::size_t l) { return discount * levels[l].stats.mean; };
+
+  for (;;) {
+    double planned_steps = 0.0;
+    for (std::size_t l = 0; l < levels.size(); ++l) {
+      planned_steps += wanted_blocks[l] * static_cast<double>(block) * cost(l);
+    }
+    if (!(planned_steps <= budget)) {
+      result.budget_exhausted = true;
+      return result;
+    }
+
+    // Draw any outstanding blocks, per level, in parallel across blocks.
+    for (std::size_t l = 0; l < levels.size(); ++l) {
+      LevelState& level = levels[l];
+      const auto wanted = static_cast<std::uint64_t>(wanted_blocks[l]);
+      if (wanted <= level.blocks_done) {
+        continue;
+      }
+      const std::uint64_t first = level.blocks_done;
+      const auto count = static_cast<std::size_t>(wanted - first);
+      std::vector<RunningStats> partial(count);
+      parallel_for(count, [&](std::size_t j) {
+        // Disjoint stream per (level, block index).
+        RandomStream rng(config.seed, (static_cast<std::uint64_t>(l) << 40U) + first + j);
+        std::vector<double> values;
+        simulate_level_block(model, payoff, maturity, level.steps, l > 0U, rng, block, values);
+        for (double v : values) {
+          partial[j].add(v);
+        }
+      });
+      for (const auto& p : partial) {
+        level.stats.merge(p);
+      }
+      level.blocks_done = wanted;
+    }
+
+    // Optimal allocation N_l = eps^-2 * 2 * sqrt(V_l / C_l) * sum_k sqrt(V_k C_k).
+    double sum = 0.0;
+    for (std::size_t l = 0; l < levels.size(); ++l) {
+      sum += std::sqrt(variance(l) * cost(l));
+    }
+    bool more = false;
+    for (std::size_t l = 0; l < levels.size(); ++l) {
+      const double target = 2.0 / eps2 * std::sqrt(variance(l) / cost(l)) * sum;
+      const double blocks = blocks_for(target);
+      if (blocks > static_cast<double>(levels[l].blocks_done)) {
+        wanted_blocks[l] = blocks;
+        more = true;
+      }
+    }
+    if (more) {
+      continue;
+    }
+
+    // Weak error estimate from the last two corrections (first-order scheme).
+    const std::size_t L = levels.size() - 1U;
+    const double bias = std::max(std::abs(mean(L)), 0.5 * std::abs(mean(L - 1U)));
+    if (bias <= config.target_rmse * kInvSqrtTwo) {
+      result.converged = true;
+      break;
+    }
+    if (levels.size() >= max_levels) {
+      break;
+    }
+    add_level();
+  }
+
+  double variance_sum = 0.0;
+  for (std::size_t l = 0; l < levels.size(); ++l) {
+    const LevelState& level = levels[l];
+    result.price += mean(l);
+    variance_sum += variance(l) / static_cast<double>(level.stats.count);
+    result.paths += level.stats.count;
+    result.simulated_steps += level.stats.count * steps_per_sample(l);
+    result.levels.push_back(MlmcLevel{
+      .steps = level.steps,
+      .paths = level.stats.count,
+      .mean = mean(l),
+      .variance = variance(l),
+    });
+  }
+  result.standard_error = std::sqrt(variance_sum);
+  return result;
+}
+
+}  // namespace quant
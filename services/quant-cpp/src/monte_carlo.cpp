@@ -5,58 +5,269 @@
 #include <random>
 #include <vector>
 
+#include "quant/parallel.hpp"
+#include "quant/payoff_expression.hpp"
+#include "quant/random.hpp"
+
 namespace quant {
 
+namespace {
+
+struct TerminalModel {
+  double spot;
+  double strike;
+  double drift;
+  double diffusion;
+  double discount;
+  bool is_call;
+};
+
+TerminalModel terminal_model(const OptionInput& option) {
+  const double sigma = option.volatility;
+  const double T = option.time_to_maturity;
+  return TerminalModel{
+    .spot = option.spot,
+    .strike = option.strike,
+    .drift = (option.rate - option.dividend_yield - 0.5 * sigma * sigma) * T,
+    .diffusion = sigma * std::sqrt(T),
+    .discount = std::exp(-option.rate * T),
+    .is_call = option.is_call,
+  };
+}
+
+// Calls `fn` with the model's vanilla payoff as a compile-time expression, so
+// the path loops below are instantiated once per payoff with no branching.
+template <typename Fn>
+decltype(auto) with_vanilla_payoff(const TerminalModel& model, Fn&& fn) {
+  using namespace payoff;
+  if (model.is_call) {
+    return fn(Max(Sub(Spot, model.strike), 0.0));
+  }
+  return fn(Max(Sub(model.strike, Spot), 0.0));
+}
+
+template <payoff::Expression Payoff>
+void simulate_block(
+  const TerminalModel& model,
+  const Payoff& vanilla,
+  std::uint64_t count,
+  std::mt19937& rng,
+  std::normal_distribution<double>& standard_normal,
+  RunningStats& stats) {
+  for (std::uint64_t i = 0; i < count; ++i) {
+    const double z = standard_normal(rng);
+    const double terminal = model.spot * std::exp(model.drift + model.diffusion * z);
+    stats.add(payoff::evaluate_terminal(vanilla, model.spot, terminal));
+  }
+}
+
+MonteCarloEstimate discounted_estimate(double discount, const RunningStats& stats) {
+  return MonteCarloEstimate{
+    .value = discount * stats.mean,
+    .standard_error = discount * stats.standard_error(),
+  };
+}
+
+MonteCarloResult discounted_result(const TerminalModel& model, const RunningStats& stats) {
+  return MonteCarloResult{
+    .price = model.discount * stats.mean,
+    .standard_error = model.discount * stats.standard_error(),
+    .paths = stats.count,
+  };
+}
+
+}  // namespace
+
+void RunningStats::add(double value) {
+  ++count;
+  const double delta = value - mean;
+  mean += delta / static_cast<double>(count);
+  m2 += delta * (value - mean);
+}
+
+void RunningStats::merge(const RunningStats& other) {
+  if (other.count == 0U) {
+    return;
+  }
+  if (count == 0U) {
+    *this = other;
+    return;
+  }
+  const double n_a = static_cast<double>(count);
+  const double n_b = static_cast<double>(other.count);
+  const double n = n_a + n_b;
+  const double delta = other.mean - mean;
+  mean += delta * n_b / n;
+  m2 += other.m2 + delta * delta * n_a * n_b / n;
+  count += other.count;
+}
+
+double RunningStats::variance() const {
+  return count == 0U ? 0.0 : m2 / static_cast<double>(count);
+}
+
+double RunningStats::standard_error() const {
+  return count == 0U ? 0.0 : std::sqrt(variance() / static_cast<double>(count));
+}
+
 MonteCarloResult monte_carlo_price(
   const OptionInput& option,
   std::uint32_t paths,
   std::uint32_t seed) {
   if (paths == 0U) {
-    return MonteCarloResult{.price = 0.0, .standard_error = 0.0};
+    return MonteCarloResult{.price = 0.0, .standard_error = 0.0, .paths = 0U};
   }
 
   std::mt19937 rng(seed);
   std::normal_distribution<double> standard_normal(0.0, 1.0);
 
-  const double S = option.spot;
-  const double K = option.strike;
-  const double r = option.rate;
-  const double q = option.dividend_yield;
-  const double sigma = option.volatility;
-  const double T = option.time_to_maturity;
+  const TerminalModel model = terminal_model(option);
+  RunningStats stats;
+  with_vanilla_payoff(model, [&](const auto& vanilla) {
+    simulate_block(model, vanilla, paths, rng, standard_normal, stats);
+  });
+  return discounted_result(model, stats);
+}
+
+MonteCarloResult monte_carlo_price_adaptive(
+  const OptionInput& option,
+  double target_standard_error,
+  std::uint64_t max_paths,
+  std::uint32_t seed,
+  std::uint32_t block_paths) {
+  if (max_paths == 0U) {
+    return MonteCarloResult{.price = 0.0, .standard_error = 0.0, .paths = 0U};
+  }
 
-  const double drift = (r - q - 0.5 * sigma * sigma) * T;
-  const double diffusion = sigma * std::sqrt(T);
-  const double discount = std::exp(-r * T);
+  std::mt19937 rng(seed);
+  std::normal_distribution<double> standard_normal(0.0, 1.0);
 
-  std::vector<double> payoffs;
-  payoffs.reserve(paths);
+  const TerminalModel model = terminal_model(option);
+  const std::uint64_t block = std::max<std::uint64_t>(block_paths, 2U);
+  RunningStats stats;
 
-  double sum = 0.0;
-  for (std::uint32_t i = 0; i < paths; ++i) {
-    const double z = standard_normal(rng);
-    const double terminal = S * std::exp(drift + diffusion * z);
-    const double payoff = option.is_call
-      ? std::max(terminal - K, 0.0)
-      : std::max(K - terminal, 0.0);
-    payoffs.push_back(payoff);
-    sum += payoff;
+  // Blocks are drawn from one sequential stream, so a run that stops after N
+  // paths sees the same normals as monte_carlo_price(option, N, seed).
+  with_vanilla_payoff(model, [&](const auto& vanilla) {
+    while (stats.count < max_paths) {
+      const std::uint64_t count = std::min(block, max_paths - stats.count);
+      RunningStats block_stats;
+      simulate_block(model, vanilla, count, rng, standard_normal, block_stats);
+      stats.merge(block_stats);
+      if (model.discount * stats.standard_error() <= target_standard_error) {
+        break;
+      }
+    }
+  });
+
+  return discounted_result(model, stats);
+}
+
+MonteCarloResult monte_carlo_price_checkpointed(
+  const OptionInput& option,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  const MonteCarloRunConfig& config) {
+  const TerminalModel model = terminal_model(option);
+  RunningStats stats;
+  if (paths == 0U) {
+    return discounted_result(model, stats);
   }
 
-  const double mean_payoff = sum / static_cast<double>(paths);
-  double variance_sum = 0.0;
-  for (double payoff : payoffs) {
-    const double diff = payoff - mean_payoff;
-    variance_sum += diff * diff;
+  const std::uint64_t block = std::max<std::uint64_t>(config.block_paths, 1U);
+  const std::uint64_t blocks = (paths + block - 1U) / block;
+  const std::size_t chunk = std::max<std::size_t>(config.checkpoint_blocks, 1U);
+
+  with_vanilla_payoff(model, [&](const auto& vanilla) {
+    for (std::uint64_t first = 0; first < blocks; first += chunk) {
+      const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(chunk, blocks - first));
+      std::vector<RunningStats> partial(count);
+      std::vector<char> done(count, 0);
+      parallel_for(count, [&](std::size_t j) {
+        if (config.stop.stop_requested()) {
+          return;
+        }
+        const std::uint64_t b = first + j;
+        const auto size = static_cast<std::size_t>(std::min(block, paths - b * block));
+        RandomStream rng(seed, b);
+        std::vector<double> normals(size);
+        rng.fill_normals(normals.data(), size);
+        for (double z : normals) {
+          const double terminal = model.spot * std::exp(model.drift + model.diffusion * z);
+          partial[j].add(payoff::evaluate_terminal(vanilla, model.spot, terminal));
+        }
+        done[j] = 1;
+      });
+
+      // Only a contiguous prefix is merged, keeping stopped runs reproducible.
+      std::size_t merged = 0;
+      while (merged < count && done[merged] != 0) {
+        stats.merge(partial[merged]);
+        ++merged;
+      }
+      if (merged < count || config.stop.stop_requested()) {
+        return;
+      }
+      if (config.checkpoint && !config.checkpoint(discounted_result(model, stats))) {
+        return;
+      }
+      if (config.target_standard_error > 0.0
+          && model.discount * stats.standard_error() <= config.target_standard_error) {
+        return;
+      }
+    }
+  });
+
+  return discounted_result(model, stats);
+}
+
+MonteCarloGreeks monte_carlo_greeks(
+  const OptionInput& option,
+  std::uint32_t paths,
+  std::uint32_t seed) {
+  const MonteCarloEstimate zero{.value = 0.0, .standard_error = 0.0};
+  if (paths == 0U) {
+    return MonteCarloGreeks{
+      .price = zero, .delta = zero, .gamma = zero, .vega = zero, .paths = 0U, .pathwise = true,
+    };
   }
 
-  const double variance = variance_sum / static_cast<double>(paths);
-  const double stddev = std::sqrt(variance);
-  const double standard_error = stddev / std::sqrt(static_cast<double>(paths));
+  std::mt19937 rng(seed);
+  std::normal_distribution<double> standard_normal(0.0, 1.0);
 
-  return MonteCarloResult{
-    .price = discount * mean_payoff,
-    .standard_error = discount * standard_error,
+  const TerminalModel model = terminal_model(option);
+  const double S = option.spot;
+  const double sigma = option.volatility;
+  const double sqrt_t = std::sqrt(option.time_to_maturity);
+  const double sigma_t = sigma * option.time_to_maturity;
+  const double gamma_scale = 1.0 / (S * S * sigma * sqrt_t);
+
+  RunningStats price;
+  RunningStats delta;
+  RunningStats gamma;
+  RunningStats vega;
+  const double direction = model.is_call ? 1.0 : -1.0;
+  with_vanilla_payoff(model, [&](const auto& vanilla) {
+    for (std::uint32_t i = 0; i < paths; ++i) {
+      const double z = standard_normal(rng);
+      const double terminal = S * std::exp(model.drift + model.diffusion * z);
+      const double payoff = payoff::evaluate_terminal(vanilla, S, terminal);
+      const double slope = payoff > 0.0 ? direction : 0.0;
+      price.add(payoff);
+      // dS_T/dS = S_T/S and dS_T/dsigma = S_T (sqrt(T) z - sigma T).
+      delta.add(slope * terminal / S);
+      vega.add(slope * terminal * (sqrt_t * z - sigma_t));
+      gamma.add(payoff * gamma_scale * ((z * z - 1.0) / (sigma * sqrt_t) - z));
+    }
+  });
+
+  return MonteCarloGreeks{
+    .price = discounted_estimate(model.discount, price),
+    .delta = discounted_estimate(model.discount, delta),
+    .gamma = discounted_estimate(model.discount, gamma),
+    .vega = discounted_estimate(model.discount, vega),
+    .paths = price.count,
+    .pathwise = true,
   };
 }
 
@@ -0,0 +1,282 @@
+#include "quant/multi_asset.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "quant/parallel.hpp"
+#include "quant/random.hpp"
+
+namespace quant {
+
+namespace {
+
+constexpr std::size_t kMaxJacobiSweeps = 100;
+// Tolerances for validate_correlation: symmetry and unit diagonal, and the
+// most negative eigenvalue still taken as rounding of a singular matrix.
+constexpr double kCorrelationTolerance = 1e-9;
+constexpr double kMinEigenvalue = -1e-8;
+
+bool try_cholesky(const std::vector<double>& c, std::size_t n, std::vector<double>& l) {
+  l.assign(n * n, 0.0);
+  for (std::size_t j = 0; j < n; ++j) {
+    double diag = c[j * n + j];
+    for (std::size_t k = 0; k < j; ++k) {
+      diag -= l[j * n + k] * l[j * n + k];
+    }
+    if (diag <= 1e-12) {
+      return false;
+    }
+    const double l_jj = std::sqrt(diag);
+    l[j * n + j] = l_jj;
+    for (std::size_t i = j + 1; i < n; ++i) {
+      double value = c[i * n + j];
+      for (std::size_t k = 0; k < j; ++k) {
+        value -= l[i * n + k] * l[j * n + k];
+      }
+      l[i * n + j] = value / l_jj;
+    }
+  }
+  return true;
+}
+
+// Cyclic Jacobi eigen-decomposition of a symmetric matrix. On return `a`
+// holds the eigenvalues on its diagonal and `v` the eigenvectors as columns.
+void jacobi_eigen(std::vector<double>& a, std::vector<double>& v, std::size_t n) {
+  v.assign(n * n, 0.0);
+  for (std::size_t i = 0; i < n; ++i) {
+    v[i * n + i] = 1.0;
+  }
+  for (std::size_t sweep = 0; sweep < kMaxJacobiSweeps; ++sweep) {
+    double off = 0.0;
+    for (std::size_t p = 0; p < n; ++p) {
+      for (std::size_t q = p + 1; q < n; ++q) {
+        off += a[p * n + q] * a[p * n + q];
+      }
+    }
+    if (off < 1e-22) {
+      return;
+    }
+    for (std::size_t p = 0; p < n; ++p) {
+      for (std::size_t q = p + 1; q < n; ++q) {
+        const double apq = a[p * n + q];
+        if (std::abs(apq) < 1e-300) {
+          continue;
+        }
+        const double theta = (a[q * n + q] - a[p * n + p]) / (2.0 * apq);
+        const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+        const double c = 1.0 / std::sqrt(t * t + 1.0);
+        const double s = t * c;
+        for (std::size_t k = 0; k < n; ++k) {
+          const double akp = a[k * n + p];
+          const double akq = a[k * n + q];
+          a[k * n + p] = c * akp - s * akq;
+          a[k * n + q] = s * akp + c * akq;
+        }
+        for (std::size_t k = 0; k < n; ++k) {
+          const double apk = a[p * n + k];
+          const double aqk = a[q * n + k];
+          a[p * n + k] = c * apk - s * aqk;
+          a[q * n + k] = s * apk + c * aqk;
+        }
+        for (std::size_t k = 0; k < n; ++k) {
+          const double vkp = v[k * n + p];
+          const double vkq = v[k * n + q];
+          v[k * n + p] = c * vkp - s * vkq;
+          v[k * n + q] = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+}
+
+std::vector<double> payoff_weights(const MultiAssetPayoff& payoff, std::size_t n) {
+  if (payoff.weights.size() == n) {
+    return payoff.weights;
+  }
+  const double uniform = payoff.type == MultiAssetPayoffType::basket ? 1.0 / static_cast<double>(n) : 1.0;
+  return std::vector<double>(n, uniform);
+}
+
+}  // namespace
+
+CorrelationFactor factor_correlation(const std::vector<double>& correlation, std::size_t dimension) {
+  const std::size_t n = dimension;
+  CorrelationFactor factor;
+  factor.dimension = n;
+  if (try_cholesky(correlation, n, factor.matrix)) {
+    factor.cholesky = true;
+    return factor;
+  }
+
+  std::vector<double> a = correlation;
+  std::vector<double> v;
+  jacobi_eigen(a, v, n);
+  factor.cholesky = false;
+  factor.matrix.assign(n * n, 0.0);
+  for (std::size_t i = 0; i < n; ++i) {
+    double norm = 0.0;
+    for (std::size_t k = 0; k < n; ++k) {
+      const double root = std::sqrt(std::max(a[k * n + k], 0.0));
+      const double value = v[i * n + k] * root;
+      factor.matrix[i * n + k] = value;
+      norm += value * value;
+    }
+    const double scale = norm > 0.0 ? 1.0 / std::sqrt(norm) : 0.0;
+    for (std::size_t k = 0; k < n; ++k) {
+      factor.matrix[i * n + k] *= scale;
+    }
+  }
+  return factor;
+}
+
+std::string validate_correlation(const std::vector<double>& correlation, std::size_t dimension) {
+  const std::size_t n = dimension;
+  if (n == 0U || correlation.size() != n * n) {
+    return "correlation must be an n x n matrix";
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      const double value = correlation[i * n + j];
+      if (!std::isfinite(value) || std::abs(value) > 1.0 + kCorrelationTolerance) {
+        return "correlation entries must be in [-1, 1]";
+      }
+      if (std::abs(value - correlation[j * n + i]) > kCorrelationTolerance) {
+        return "correlation must be symmetric";
+      }
+    }
+    if (std::abs(correlation[i * n + i] - 1.0) > kCorrelationTolerance) {
+      return "correlation must have a unit diagonal";
+    }
+  }
+  std::vector<double> factor;
+  if (try_cholesky(correlation, n, factor)) {
+    return {};
+  }
+  // Cholesky also stops on singular matrices; only a clearly negative
+  // eigenvalue makes the matrix impossible.
+  std::vector<double> a = correlation;
+  std::vector<double> v;
+  jacobi_eigen(a, v, n);
+  for (std::size_t k = 0; k < n; ++k) {
+    if (a[k * n + k] < kMinEigenvalue) {
+      return "correlation must be positive semi-definite";
+    }
+  }
+  return {};
+}
+
+void correlate_block(
+  const CorrelationFactor& factor,
+  const double* independent,
+  double* correlated,
+  std::size_t size) {
+  const std::size_t n = factor.dimension;
+  // Row-by-row AXPY over the block keeps the inner loop contiguous and
+  // vectorisable; a Cholesky factor skips the upper triangle.
+  for (std::size_t i = 0; i < n; ++i) {
+    double* out = correlated + i * size;
+    std::fill(out, out + size, 0.0);
+    const std::size_t columns = factor.cholesky ? i + 1U : n;
+    for (std::size_t k = 0; k < columns; ++k) {
+      const double f = factor.matrix[i * n + k];
+      if (f == 0.0) {
+        continue;
+      }
+      const double* z = independent + k * size;
+      for (std::size_t p = 0; p < size; ++p) {
+        out[p] += f * z[p];
+      }
+    }
+  }
+}
+
+MonteCarloResult multi_asset_monte_carlo_price(
+  const MultiAssetInput& input,
+  const MultiAssetPayoff& payoff,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  std::size_t block_paths) {
+  const std::size_t n = input.spots.size();
+  const bool consistent = n > 0U
+    && input.volatilities.size() == n
+    && (input.dividend_yields.empty() || input.dividend_yields.size() == n)
+    && (payoff.type != MultiAssetPayoffType::spread || n >= 2U)
+    && validate_correlation(input.correlation, n).empty();
+  if (paths == 0U || !consistent) {
+    return MonteCarloResult{.price = 0.0, .standard_error = 0.0, .paths = 0U};
+  }
+
+  const CorrelationFactor factor = factor_correlation(input.correlation, n);
+  const std::vector<double> weights = payoff_weights(payoff, n);
+  const double T = input.time_to_maturity;
+  std::vector<double> drift(n);
+  std::vector<double> diffusion(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const double sigma = input.volatilities[i];
+    const double q = input.dividend_yields.empty() ? 0.0 : input.dividend_yields[i];
+    drift[i] = (input.rate - q - 0.5 * sigma * sigma) * T;
+    diffusion[i] = sigma * std::sqrt(T);
+  }
+
+  const std::uint64_t block = std::max<std::size_t>(block_paths, 1U);
+  const std::size_t blocks = static_cast<std::size_t>((paths + block - 1U) / block);
+  std::vector<RunningStats> block_stats(blocks);
+
+  parallel_for(blocks, [&](std::size_t b) {
+    const auto size = static_cast<std::size_t>(std::min(block, paths - b * block));
+    RandomStream rng(seed, b);
+    std::vector<double> normals(n * size);
+    std::vector<double> terminal(n * size);
+    rng.fill_normals(normals.data(), normals.size());
+    correlate_block(factor, normals.data(), terminal.data(), size);
+    for (std::size_t i = 0; i < n; ++i) {
+      double* row = terminal.data() + i * size;
+      for (std::size_t p = 0; p < size; ++p) {
+        row[p] = weights[i] * input.spots[i] * std::exp(drift[i] + diffusion[i] * row[p]);
+      }
+    }
+
+    for (std::size_t p = 0; p < size; ++p) {
+      double underlying = 0.0;
+      switch (payoff.type) {
+        case MultiAssetPayoffType::basket:
+          for (std::size_t i = 0; i < n; ++i) {
+            underlying += terminal[i * size + p];
+          }
+          break;
+        case MultiAssetPayoffType::best_of:
+          underlying = terminal[p];
+          for (std::size_t i = 1; i < n; ++i) {
+            underlying = std::max(underlying, terminal[i * size + p]);
+          }
+          break;
+        case MultiAssetPayoffType::worst_of:
+          underlying = terminal[p];
+          for (std::size_t i = 1; i < n; ++i) {
+            underlying = std::min(underlying, terminal[i * size + p]);
+          }
+          break;
+        case MultiAssetPayoffType::spread:
+          underlying = terminal[p] - terminal[size + p];
+          break;
+      }
+      const double value = payoff.is_call
+        ? std::max(underlying - payoff.strike, 0.0)
+        : std::max(payoff.strike - underlying, 0.0);
+      block_stats[b].add(value);
+    }
+  });
+
+  RunningStats stats;
+  for (const auto& partial : block_stats) {
+    stats.merge(partial);
+  }
+  const double discount = std::exp(-input.rate * T);
+  return MonteCarloResult{
+    .price = discount * stats.mean,
+    .standard_error = discount * stats.standard_error(),
+    .paths = stats.count,
+  };
+}
+
+}  // namespace quant
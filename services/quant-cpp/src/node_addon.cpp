@@ -0,0 +1,507 @@
+// Node-API binding of quant_core for in-process callers such as the backtest
+// worker, which would otherwise pay a gRPC round trip per pricing call.
+//
+//   priceBatch(options, prices?)                 -> Float64Array
+//   greeksBatch(options, out?)                   -> { price, delta, gamma, vega, theta, rho }
+//   impliedVolBatch(options, targetPrices, out?) -> { impliedVolatility, converged, iterations }
+//   monteCarlo(option, config?)                  -> Promise<{ price, standardError, paths, ... }>
+//   configureThreads(threads)                    -> boolean
+//
+// Batch `options` hold Float64Array columns spot, strike, rate, volatility
+// (unused by impliedVolBatch), timeToMaturity and optional dividendYield, and
+// a Uint8Array isCall. The kernels read the columns and write the outputs in
+// the arrays' own buffers; the only copy is of the isCall bytes into bools.
+// Outputs passed in (`prices`, or named columns of `out`) are reused, so a
+// caller pricing in a loop allocates nothing per call. Batches run on the
+// calling thread: they are short, and the columns belong to the event loop.
+//
+// monteCarlo runs on the shared TaskPool and settles its promise on the
+// event loop through a thread-safe function. Its inputs and defaults match
+// the MonteCarlo RPC, so both return the same numbers for the same request.
+
+#include <node_api.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "quant/black_scholes.hpp"
+#include "quant/monte_carlo.hpp"
+#include "quant/task_pool.hpp"
+
+namespace quant {
+
+namespace {
+
+static_assert(sizeof(bool) == 1, "converged is written as one byte per option");
+
+constexpr double kInputFloor = 1e-6;
+
+// Throws `message` as a TypeError unless a property getter already threw.
+napi_value throw_error(napi_env env, const std::string& message) {
+  bool pending = false;
+  napi_is_exception_pending(env, &pending);
+  if (!pending) {
+    napi_throw_type_error(env, nullptr, message.c_str());
+  }
+  return nullptr;
+}
+
+bool is_undefined(napi_env env, napi_value value) {
+  napi_valuetype type = napi_undefined;
+  return value == nullptr || (napi_typeof(env, value, &type) == napi_ok && type == napi_undefined);
+}
+
+// `object[name]`, or undefined when `object` is itself undefined.
+napi_value property(napi_env env, napi_value object, const char* name) {
+  napi_value value = nullptr;
+  if (!is_undefined(env, object)) {
+    napi_get_named_property(env, object, name, &value);
+  }
+  return value;
+}
+
+const char* type_name(napi_typedarray_type type) {
+  switch (type) {
+    case napi_float64_array: return "a Float64Array";
+    case napi_uint8_array: return "a Uint8Array";
+    default: return "a Uint32Array";
+  }
+}
+
+std::string typed_array(
+  napi_env env, napi_value value, napi_typedarray_type type, const char* name, void** data, std::size_t* length) {
+  bool is_typed_array = false;
+  napi_typedarray_type actual = napi_int8_array;
+  if (napi_is_typedarray(env, value, &is_typed_array) != napi_ok || !is_typed_array ||
+      napi_get_typedarray_info(env, value, &actual, length, data, nullptr, nullptr) != napi_ok || actual != type) {
+    return std::string(name) + " must be " + type_name(type);
+  }
+  if (*data == nullptr && *length != 0U) {
+    return std::string(name) + " is detached";
+  }
+  return {};
+}
+
+// Input column `options[name]` with exactly `size` elements; `size` is set
+// by the first column read.
+template <typename T>
+std::string input_column(
+  napi_env env, napi_value options, const char* name, napi_typedarray_type type, std::size_t* size, const T** data) {
+  void* raw = nullptr;
+  std::size_t length = 0;
+  if (auto error = typed_array(env, property(env, options, name), type, name, &raw, &length); !error.empty()) {
+    return error;
+  }
+  if (*size == SIZE_MAX) {
+    *size = length;
+  } else if (length != *size) {
+    return std::string(name) + " must have one value per option";
+  }
+  *data = static_cast<const T*>(raw);
+  return {};
+}
+
+// Borrows the option columns of `options`; `flags` receives is_call.
+std::string option_columns(
+  napi_env env, napi_value options, bool needs_volatility, OptionColumns& columns, std::unique_ptr<bool[]>& flags) {
+  napi_valuetype type = napi_undefined;
+  if (napi_typeof(env, options, &type) != napi_ok || type != napi_object) {
+    return "options must be an object of option columns";
+  }
+  std::size_t size = SIZE_MAX;
+  columns = OptionColumns{};
+  const unsigned char* is_call = nullptr;
+  for (auto error : {
+         input_column(env, options, "spot", napi_float64_array, &size, &columns.spot),
+         input_column(env, options, "strike", napi_float64_array, &size, &columns.strike),
+         input_column(env, options, "rate", napi_float64_array, &size, &columns.rate),
+         input_column(env, options, "timeToMaturity", napi_float64_array, &size, &columns.time_to_maturity),
+         input_column(env, options, "isCall", napi_uint8_array, &size, &is_call),
+       }) {
+    if (!error.empty()) {
+      return error;
+    }
+  }
+  if (needs_volatility) {
+    if (auto error = input_column(env, options, "volatility", napi_float64_array, &size, &columns.volatility);
+        !error.empty()) {
+      return error;
+    }
+  }
+  if (!is_undefined(env, property(env, options, "dividendYield"))) {
+    if (auto error = input_column(env, options, "dividendYield", napi_float64_array, &size, &columns.dividend_yield);
+        !error.empty()) {
+      return error;
+    }
+  }
+
+  flags = std::make_unique<bool[]>(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    flags[i] = is_call[i] != 0U;
+  }
+  columns.is_call = flags.get();
+  columns.size = size;
+  columns.input_floor = kInputFloor;
+  return {};
+}
+
+// Reuses `supplied` when it is given, otherwise creates an array of `size`
+// elements. Either way `data` points into the array's own buffer.
+std::string output_column(
+  napi_env env,
+  napi_value supplied,
+  const char* name,
+  napi_typedarray_type type,
+  std::size_t element_bytes,
+  std::size_t size,
+  void** data,
+  napi_value* array) {
+  if (!is_undefined(env, supplied)) {
+    std::size_t length = 0;
+    if (auto error = typed_array(env, supplied, type, name, data, &length); !error.empty()) {
+      return error;
+    }
+    if (length != size) {
+      return std::string(name) + " must have one value per option";
+    }
+    *array = supplied;
+    return {};
+  }
+  napi_value buffer = nullptr;
+  if (napi_create_arraybuffer(env, size * element_bytes, data, &buffer) != napi_ok ||
+      napi_create_typedarray(env, type, size, buffer, 0, array) != napi_ok) {
+    return std::string("cannot allocate ") + name;
+  }
+  return {};
+}
+
+std::string output_doubles(
+  napi_env env, napi_value supplied, const char* name, std::size_t size, double** data, napi_value* array) {
+  void* raw = nullptr;
+  auto error = output_column(env, supplied, name, napi_float64_array, sizeof(double), size, &raw, array);
+  *data = static_cast<double*>(raw);
+  return error;
+}
+
+// The first N arguments; Node-API fills missing ones with undefined.
+template <std::size_t N>
+bool arguments(napi_env env, napi_callback_info info, napi_value (&args)[N]) {
+  std::size_t count = N;
+  return napi_get_cb_info(env, info, &count, args, nullptr, nullptr) == napi_ok;
+}
+
+napi_value price_batch(napi_env env, napi_callback_info info) {
+  napi_value args[2];
+  if (!arguments(env, info, args)) {
+    return nullptr;
+  }
+  OptionColumns columns{};
+  std::unique_ptr<bool[]> flags;
+  if (auto error = option_columns(env, args[0], true, columns, flags); !error.empty()) {
+    return throw_error(env, error);
+  }
+  double* prices = nullptr;
+  napi_value result = nullptr;
+  if (auto error = output_doubles(env, args[1], "prices", columns.size, &prices, &result); !error.empty()) {
+    return throw_error(env, error);
+  }
+  black_scholes_price_batch(columns, prices);
+  return result;
+}
+
+napi_value greeks_batch(napi_env env, napi_callback_info info) {
+  napi_value args[2];
+  if (!arguments(env, info, args)) {
+    return nullptr;
+  }
+  OptionColumns columns{};
+  std::unique_ptr<bool[]> flags;
+  if (auto error = option_columns(env, args[0], true, columns, flags); !error.empty()) {
+    return throw_error(env, error);
+  }
+  GreeksColumns greeks{};
+  napi_value result = nullptr;
+  napi_create_object(env, &result);
+  const std::pair<const char*, double**> outputs[] = {
+    {"price", &greeks.price},
+    {"delta", &greeks.delta},
+    {"gamma", &greeks.gamma},
+    {"vega", &greeks.vega},
+    {"theta", &greeks.theta},
+    {"rho", &greeks.rho},
+  };
+  for (const auto& [name, data] : outputs) {
+    napi_value array = nullptr;
+    if (auto error = output_doubles(env, property(env, args[1], name), name, columns.size, data, &array);
+        !error.empty()) {
+      return throw_error(env, error);
+    }
+    napi_set_named_property(env, result, name, array);
+  }
+  black_scholes_greeks_batch(columns, greeks);
+  return result;
+}
+
+napi_value implied_vol_batch(napi_env env, napi_callback_info info) {
+  napi_value args[3];
+  if (!arguments(env, info, args)) {
+    return nullptr;
+  }
+  OptionColumns columns{};
+  std::unique_ptr<bool[]> flags;
+  if (auto error = option_columns(env, args[0], false, columns, flags); !error.empty()) {
+    return throw_error(env, error);
+  }
+  void* targets = nullptr;
+  std::size_t target_count = 0;
+  if (auto error = typed_array(env, args[1], napi_float64_array, "targetPrices", &targets, &target_count);
+      !error.empty()) {
+    return throw_error(env, error);
+  }
+  if (target_count != columns.size) {
+    return throw_error(env, "targetPrices must have one value per option");
+  }
+
+  const std::size_t n = columns.size;
+  double* implied = nullptr;
+  void* converged = nullptr;
+  void* iterations = nullptr;
+  napi_value implied_array = nullptr;
+  napi_value converged_array = nullptr;
+  napi_value iterations_array = nullptr;
+  for (auto error : {
+         output_doubles(env, property(env, args[2], "impliedVolatility"), "impliedVolatility", n, &implied,
+                        &implied_array),
+         output_column(env, property(env, args[2], "converged"), "converged", napi_uint8_array, 1, n, &converged,
+                       &converged_array),
+         output_column(env, property(env, args[2], "iterations"), "iterations", napi_uint32_array,
+                       sizeof(std::uint32_t), n, &iterations, &iterations_array),
+       }) {
+    if (!error.empty()) {
+      return throw_error(env, error);
+    }
+  }
+  implied_volatility_batch(
+    columns,
+    static_cast<const double*>(targets),
+    implied,
+    static_cast<bool*>(converged),
+    static_cast<std::uint32_t*>(iterations));
+
+  napi_value result = nullptr;
+  napi_create_object(env, &result);
+  napi_set_named_property(env, result, "impliedVolatility", implied_array);
+  napi_set_named_property(env, result, "converged", converged_array);
+  napi_set_named_property(env, result, "iterations", iterations_array);
+  return result;
+}
+
+// `object[name]` as a number, or `fallback` when it is undefined.
+std::string number(napi_env env, napi_value object, const char* name, double fallback, double* value) {
+  const napi_value field = property(env, object, name);
+  if (is_undefined(env, field)) {
+    *value = fallback;
+    return {};
+  }
+  if (napi_get_value_double(env, field, value) != napi_ok) {
+    return std::string(name) + " must be a number";
+  }
+  return {};
+}
+
+struct MonteCarloJob {
+  OptionInput option;
+  std::uint32_t paths;
+  std::uint32_t seed;
+  bool greeks;
+  double target_standard_error;
+  std::uint64_t max_paths;
+  napi_deferred deferred;
+  MonteCarloGreeks result{};
+  std::string error;
+};
+
+std::string monte_carlo_job(napi_env env, napi_value option, napi_value config, MonteCarloJob& job) {
+  napi_valuetype type = napi_undefined;
+  if (napi_typeof(env, option, &type) != napi_ok || type != napi_object) {
+    return "option must be an object";
+  }
+  double spot = 0.0;
+  double strike = 0.0;
+  double rate = 0.0;
+  double volatility = 0.0;
+  double maturity = 0.0;
+  double dividend = 0.0;
+  double paths = 0.0;
+  double seed = 0.0;
+  double target = 0.0;
+  double max_paths = 0.0;
+  for (auto error : {
+         number(env, option, "spot", 0.0, &spot),
+         number(env, option, "strike", 0.0, &strike),
+         number(env, option, "rate", 0.0, &rate),
+         number(env, option, "volatility", 0.0, &volatility),
+         number(env, option, "timeToMaturity", 0.0, &maturity),
+         number(env, option, "dividendYield", 0.0, &dividend),
+         number(env, config, "paths", 10'000.0, &paths),
+         number(env, config, "seed", 0.0, &seed),
+         number(env, config, "targetStandardError", 0.0, &target),
+         number(env, config, "maxPaths", 10'000'000.0, &max_paths),
+       }) {
+    if (!error.empty()) {
+      return error;
+    }
+  }
+  if (!(paths >= 1.0 && paths <= UINT32_MAX) || !(seed >= 0.0 && seed <= UINT32_MAX) ||
+      !(max_paths >= 1.0 && max_paths <= 9.0e15)) {
+    return "paths, seed and maxPaths must be in range";
+  }
+  bool is_call = true;
+  if (const napi_value field = property(env, option, "isCall");
+      !is_undefined(env, field) && napi_get_value_bool(env, field, &is_call) != napi_ok) {
+    return "isCall must be a boolean";
+  }
+  bool greeks = false;
+  if (const napi_value field = property(env, config, "greeks");
+      !is_undefined(env, field) && napi_get_value_bool(env, field, &greeks) != napi_ok) {
+    return "greeks must be a boolean";
+  }
+  job.option = OptionInput{
+    .spot = std::max(spot, kInputFloor),
+    .strike = std::max(strike, kInputFloor),
+    .rate = rate,
+    .volatility = std::max(volatility, kInputFloor),
+    .time_to_maturity = std::max(maturity, kInputFloor),
+    .dividend_yield = dividend,
+    .is_call = is_call,
+  };
+  job.paths = static_cast<std::uint32_t>(paths);
+  job.seed = static_cast<std::uint32_t>(seed);
+  job.greeks = greeks;
+  job.target_standard_error = target;
+  job.max_paths = static_cast<std::uint64_t>(max_paths);
+  return {};
+}
+
+void run_monte_carlo(MonteCarloJob& job) {
+  try {
+    if (job.greeks) {
+      job.result = monte_carlo_greeks(job.option, job.paths, job.seed);
+      return;
+    }
+    const MonteCarloResult result = job.target_standard_error > 0.0
+      ? monte_carlo_price_adaptive(job.option, job.target_standard_error, job.max_paths, job.seed)
+      : monte_carlo_price(job.option, job.paths, job.seed);
+    job.result.price = MonteCarloEstimate{.value = result.price, .standard_error = result.standard_error};
+    job.result.paths = result.paths;
+  } catch (const std::exception& error) {
+    job.error = error.what();
+  }
+}
+
+void set_number(napi_env env, napi_value object, const char* name, double value) {
+  napi_value number = nullptr;
+  napi_create_double(env, value, &number);
+  napi_set_named_property(env, object, name, number);
+}
+
+// Runs on the event loop once the job is done. `env` is null if the
+// environment is shutting down, in which case the promise is abandoned.
+void settle_monte_carlo(napi_env env, napi_value, void*, void* data) {
+  const std::unique_ptr<MonteCarloJob> job(static_cast<MonteCarloJob*>(data));
+  if (env == nullptr) {
+    return;
+  }
+  if (!job->error.empty()) {
+    napi_value message = nullptr;
+    napi_value error = nullptr;
+    napi_create_string_utf8(env, job->error.c_str(), job->error.size(), &message);
+    napi_create_error(env, nullptr, message, &error);
+    napi_reject_deferred(env, job->deferred, error);
+    return;
+  }
+  const MonteCarloGreeks& result = job->result;
+  napi_value object = nullptr;
+  napi_create_object(env, &object);
+  set_number(env, object, "price", result.price.value);
+  set_number(env, object, "standardError", result.price.standard_error);
+  set_number(env, object, "paths", static_cast<double>(result.paths));
+  if (job->greeks) {
+    set_number(env, object, "delta", result.delta.value);
+    set_number(env, object, "deltaStandardError", result.delta.standard_error);
+    set_number(env, object, "gamma", result.gamma.value);
+    set_number(env, object, "gammaStandardError", result.gamma.standard_error);
+    set_number(env, object, "vega", result.vega.value);
+    set_number(env, object, "vegaStandardError", result.vega.standard_error);
+  }
+  napi_resolve_deferred(env, job->deferred, object);
+}
+
+napi_value monte_carlo(napi_env env, napi_callback_info info) {
+  napi_value args[2];
+  if (!arguments(env, info, args)) {
+    return nullptr;
+  }
+  auto job = std::make_unique<MonteCarloJob>();
+  if (auto error = monte_carlo_job(env, args[0], args[1], *job); !error.empty()) {
+    return throw_error(env, error);
+  }
+
+  // The thread-safe function keeps the event loop alive until the job has
+  // been handed back to it.
+  napi_value promise = nullptr;
+  napi_value name = nullptr;
+  napi_threadsafe_function done = nullptr;
+  napi_create_string_utf8(env, "quant.monteCarlo", NAPI_AUTO_LENGTH, &name);
+  if (napi_create_promise(env, &job->deferred, &promise) != napi_ok ||
+      napi_create_threadsafe_function(
+        env, nullptr, nullptr, name, 0, 1, nullptr, nullptr, nullptr, settle_monte_carlo, &done) != napi_ok) {
+    return throw_error(env, "cannot start the simulation");
+  }
+  TaskPool::shared().submit([job = job.release(), done] {
+    run_monte_carlo(*job);
+    if (napi_call_threadsafe_function(done, job, napi_tsfn_blocking) != napi_ok) {
+      delete job;
+    }
+    napi_release_threadsafe_function(done, napi_tsfn_release);
+  });
+  return promise;
+}
+
+napi_value configure_threads(napi_env env, napi_callback_info info) {
+  napi_value args[1];
+  if (!arguments(env, info, args)) {
+    return nullptr;
+  }
+  double threads = 0.0;
+  if (napi_get_value_double(env, args[0], &threads) != napi_ok || !(threads >= 0.0 && threads <= 4096.0)) {
+    return throw_error(env, "threads must be a number from 0 to 4096");
+  }
+  napi_value configured = nullptr;
+  napi_get_boolean(env, TaskPool::configure_shared(static_cast<std::size_t>(threads)), &configured);
+  return configured;
+}
+
+}  // namespace
+
+}  // namespace quant
+
+NAPI_MODULE_INIT() {
+  const napi_property_descriptor properties[] = {
+    {"priceBatch", nullptr, quant::price_batch, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+    {"greeksBatch", nullptr, quant::greeks_batch, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+    {"impliedVolBatch", nullptr, quant::implied_vol_batch, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+    {"monteCarlo", nullptr, quant::monte_carlo, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+    {"configureThreads", nullptr, quant::configure_threads, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+  };
+  if (napi_define_properties(env, exports, std::size(properties), properties) != napi_ok) {
+    return nullptr;
+  }
+  return exports;
+}
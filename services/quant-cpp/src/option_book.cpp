@@ -0,0 +1,103 @@
+#include "quant/option_book.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace quant {
+
+void BookChanges::clear() {
+  options.clear();
+  price.clear();
+  delta.clear();
+  gamma.clear();
+  vega.clear();
+  theta.clear();
+  rho.clear();
+}
+
+OptionBook::OptionBook(
+  const OptionColumns& options, const std::vector<std::uint32_t>& underlyings, double tolerance)
+  : size_(options.size),
+    floor_(std::max(options.input_floor, 1e-9)),
+    tolerance_(std::max(tolerance, 0.0)),
+    spot_(options.spot, options.spot + options.size),
+    strike_(options.strike, options.strike + options.size),
+    rate_(options.rate, options.rate + options.size),
+    volatility_(options.volatility, options.volatility + options.size),
+    maturity_(options.time_to_maturity, options.time_to_maturity + options.size),
+    dividend_(options.size, 0.0),
+    is_call_(std::make_unique<bool[]>(options.size)),
+    is_dirty_(options.size, true),
+    reported_price_(options.size, 0.0),
+    reported_(options.size, false) {
+  if (options.dividend_yield != nullptr) {
+    std::copy(options.dividend_yield, options.dividend_yield + size_, dividend_.begin());
+  }
+  std::copy(options.is_call, options.is_call + size_, is_call_.get());
+  dirty_.reserve(size_);
+  for (std::uint32_t i = 0; i < size_; ++i) {
+    by_underlying_[underlyings.empty() ? 0U : underlyings[i]].push_back(i);
+    dirty_.push_back(i);
+  }
+}
+
+bool OptionBook::set_spot(std::uint32_t underlying, double spot) {
+  const auto found = by_underlying_.find(underlying);
+  if (found == by_underlying_.end()) {
+    return false;
+  }
+  for (const std::uint32_t option : found->second) {
+    spot_[option] = spot;
+    if (!is_dirty_[option]) {
+      is_dirty_[option] = true;
+      dirty_.push_back(option);
+    }
+  }
+  return true;
+}
+
+bool OptionBook::set_volatility(std::uint32_t option, double volatility) {
+  if (option >= size_) {
+    return false;
+  }
+  volatility_[option] = volatility;
+  if (!is_dirty_[option]) {
+    is_dirty_[option] = true;
+    dirty_.push_back(option);
+  }
+  return true;
+}
+
+const BookChanges& OptionBook::reprice() {
+  changes_.clear();
+  // Report in book order regardless of update order.
+  std::sort(dirty_.begin(), dirty_.end());
+  for (const std::uint32_t i : dirty_) {
+    is_dirty_[i] = false;
+    const OptionGreeks greeks = black_scholes({
+      .spot = std::max(spot_[i], floor_),
+      .strike = std::max(strike_[i], floor_),
+      .rate = rate_[i],
+      .volatility = std::max(volatility_[i], floor_),
+      .time_to_maturity = std::max(maturity_[i], floor_),
+      .dividend_yield = dividend_[i],
+      .is_call = is_call_[i],
+    });
+    if (reported_[i] && !(std::abs(greeks.price - reported_price_[i]) > tolerance_)) {
+      continue;
+    }
+    reported_[i] = true;
+    reported_price_[i] = greeks.price;
+    changes_.options.push_back(i);
+    changes_.price.push_back(greeks.price);
+    changes_.delta.push_back(greeks.delta);
+    changes_.gamma.push_back(greeks.gamma);
+    changes_.vega.push_back(greeks.vega);
+    changes_.theta.push_back(greeks.theta);
+    changes_.rho.push_back(greeks.rho);
+  }
+  dirty_.clear();
+  return changes_;
+}
+
+}  // namespace quant
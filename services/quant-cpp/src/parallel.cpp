@@ -0,0 +1,42 @@
+#include "quant/parallel.hpp"
+
+#include <atomic>
+
+#include "quant/task_pool.hpp"
+
+namespace quant {
+
+void parallel_for(std::size_t count, const std::function<void(std::size_t)>& body) {
+  parallel_for(TaskPool::shared(), count, body);
+}
+
+void parallel_for(TaskPool& pool, std::size_t count, const std::function<void(std::size_t)>& body) {
+  if (count == 0U) {
+    return;
+  }
+  TaskGroup group(pool);
+  std::atomic<bool> failed{false};
+  // Forks the upper half of the range until one index is left, so thieves
+  // take the largest remaining ranges and a call nested inside another
+  // parallel_for shares the same workers.
+  std::function<void(std::size_t, std::size_t)> split = [&](std::size_t first, std::size_t last) {
+    while (last - first > 1U) {
+      const std::size_t middle = first + (last - first) / 2U;
+      group.run([&split, middle, last] { split(middle, last); });
+      last = middle;
+    }
+    if (failed.load(std::memory_order_relaxed)) {
+      return;
+    }
+    try {
+      body(first);
+    } catch (...) {
+      failed.store(true, std::memory_order_relaxed);
+      throw;
+    }
+  };
+  group.run([&split, count] { split(0, count); });
+  group.wait();
+}
+
+}  // namespace quant
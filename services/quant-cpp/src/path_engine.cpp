@@ -0,0 +1,340 @@
+#include "quant/path_engine.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "quant/parallel.hpp"
+
+namespace quant {
+
+TimeGrid TimeGrid::uniform(double maturity, std::size_t steps) {
+  TimeGrid grid;
+  const std::size_t count = std::max<std::size_t>(steps, 1U);
+  grid.times.reserve(count);
+  for (std::size_t i = 1; i <= count; ++i) {
+    grid.times.push_back(maturity * static_cast<double>(i) / static_cast<double>(count));
+  }
+  return grid;
+}
+
+GbmPathModel::GbmPathModel(const OptionInput& option)
+  : spot_(option.spot),
+    rate_(option.rate),
+    dividend_yield_(option.dividend_yield),
+    volatility_(option.volatility) {}
+
+std::unique_ptr<PathModel> GbmPathModel::clone() const {
+  return std::make_unique<GbmPathModel>(*this);
+}
+
+void GbmPathModel::begin(std::size_t) {}
+
+void GbmPathModel::advance(
+  const PathStep& step,
+  const double* previous,
+  double* next,
+  double* step_variance) {
+  const double variance = volatility_ * volatility_ * step.dt;
+  const double drift = (rate_ - dividend_yield_) * step.dt - 0.5 * variance;
+  const double diffusion = std::sqrt(variance);
+  const double* z = step.normals;
+  for (std::size_t i = 0; i < step.size; ++i) {
+    next[i] = previous[i] * std::exp(drift + diffusion * z[i]);
+    step_variance[i] = variance;
+  }
+}
+
+void PathBlockBuffers::resize(std::size_t size, std::size_t normals_per_step) {
+  previous.resize(size);
+  current.resize(size);
+  step_variance.resize(size);
+  normals.resize(size * normals_per_step);
+  payoffs.resize(size);
+}
+
+namespace {
+
+// Blocks handed to the pool at a time. Per-block results live only for
+// their chunk and are merged in block order, so memory stays bounded for any
+// path count without changing results.
+constexpr std::size_t kChunkBlocks = 256;
+
+// Runs `simulate(b, slot)` for every block b, reusing at most kChunkBlocks
+// slots, and passes each slot to `merge` in block order.
+template <typename Slot, typename Simulate, typename Merge>
+void run_block_chunks(std::size_t blocks, Simulate&& simulate, Merge&& merge) {
+  std::vector<Slot> slots(std::min(blocks, kChunkBlocks));
+  for (std::size_t first = 0; first < blocks; first += slots.size()) {
+    const std::size_t count = std::min(slots.size(), blocks - first);
+    parallel_for(count, [&](std::size_t j) { simulate(first + j, slots[j]); });
+    for (std::size_t j = 0; j < count; ++j) {
+      merge(slots[j]);
+    }
+  }
+}
+
+// Generates one block and hands every grid date to `observe`.
+template <typename Observe>
+void generate_path_block(
+  PathModel& model,
+  const TimeGrid& grid,
+  RandomStream& rng,
+  std::size_t size,
+  PathBlockBuffers& buffers,
+  Observe&& observe) {
+  const std::size_t normals_per_step = model.normals_per_step();
+  buffers.resize(size, normals_per_step);
+
+  const double spot = model.initial_spot();
+  std::fill(buffers.current.begin(), buffers.current.end(), spot);
+  model.begin(size);
+
+  double previous_time = 0.0;
+  for (std::size_t k = 0; k < grid.steps(); ++k) {
+    const double time = grid.times[k];
+    const double dt = time - previous_time;
+    buffers.previous.swap(buffers.current);
+    rng.fill_normals(buffers.normals.data(), size * normals_per_step);
+
+    const PathStep step{
+      .index = k,
+      .time = time,
+      .dt = dt,
+      .normals = buffers.normals.data(),
+      .size = size,
+      .rng = &rng,
+    };
+    model.advance(step, buffers.previous.data(), buffers.current.data(), buffers.step_variance.data());
+
+    observe(PathObservation{
+      .step = k,
+      .time = time,
+      .dt = dt,
+      .previous = buffers.previous.data(),
+      .current = buffers.current.data(),
+      .step_variance = buffers.step_variance.data(),
+      .size = size,
+    });
+    previous_time = time;
+  }
+}
+
+// Per-block means and co-moment matrix, merged with Chan's pairwise update.
+struct CoMoments {
+  std::uint64_t count = 0;
+  std::vector<double> mean;
+  std::vector<double> comoment;  // row-major, sum of (x_a - m_a)(x_b - m_b)
+
+  void assign(const std::vector<std::vector<double>>& values, std::size_t size) {
+    const std::size_t n = values.size();
+    count = size;
+    mean.assign(n, 0.0);
+    comoment.assign(n * n, 0.0);
+    for (std::size_t a = 0; a < n; ++a) {
+      double sum = 0.0;
+      for (std::size_t i = 0; i < size; ++i) {
+        sum += values[a][i];
+      }
+      mean[a] = sum / static_cast<double>(size);
+    }
+    for (std::size_t a = 0; a < n; ++a) {
+      for (std::size_t b = a; b < n; ++b) {
+        const double* x = values[a].data();
+        const double* y = values[b].data();
+        const double mx = mean[a];
+        const double my = mean[b];
+        double sum = 0.0;
+        for (std::size_t i = 0; i < size; ++i) {
+          sum += (x[i] - mx) * (y[i] - my);
+        }
+        comoment[a * n + b] = sum;
+        comoment[b * n + a] = sum;
+      }
+    }
+  }
+
+  void merge(const CoMoments& other) {
+    if (other.count == 0U) {
+      return;
+    }
+    if (count == 0U) {
+      *this = other;
+      return;
+    }
+    const std::size_t n = mean.size();
+    const double n_a = static_cast<double>(count);
+    const double n_b = static_cast<double>(other.count);
+    const double total = n_a + n_b;
+    std::vector<double> delta(n);
+    for (std::size_t a = 0; a < n; ++a) {
+      delta[a] = other.mean[a] - mean[a];
+    }
+    for (std::size_t a = 0; a < n; ++a) {
+      for (std::size_t b = 0; b < n; ++b) {
+        comoment[a * n + b] += other.comoment[a * n + b] + delta[a] * delta[b] * n_a * n_b / total;
+      }
+      mean[a] += delta[a] * n_b / total;
+    }
+    count += other.count;
+  }
+};
+
+}  // namespace
+
+void simulate_path_block(
+  PathModel& model,
+  const TimeGrid& grid,
+  PathPayoff& payoff,
+  RandomStream& rng,
+  std::size_t size,
+  PathBlockBuffers& buffers) {
+  payoff.begin(size, model.initial_spot());
+  generate_path_block(model, grid, rng, size, buffers, [&](const PathObservation& observation) {
+    payoff.observe(observation);
+  });
+  payoff.settle(buffers.payoffs.data(), size);
+}
+
+void simulate_path_block(
+  PathModel& model,
+  const TimeGrid& grid,
+  const std::vector<PathPayoff*>& payoffs,
+  RandomStream& rng,
+  std::size_t size,
+  PathBlockBuffers& buffers,
+  std::vector<std::vector<double>>& payoff_values) {
+  for (PathPayoff* payoff : payoffs) {
+    payoff->begin(size, model.initial_spot());
+  }
+  generate_path_block(model, grid, rng, size, buffers, [&](const PathObservation& observation) {
+    for (PathPayoff* payoff : payoffs) {
+      payoff->observe(observation);
+    }
+  });
+  payoff_values.resize(payoffs.size());
+  for (std::size_t p = 0; p < payoffs.size(); ++p) {
+    payoff_values[p].resize(size);
+    payoffs[p]->settle(payoff_values[p].data(), size);
+  }
+}
+
+MonteCarloResult path_monte_carlo_price(
+  const PathModel& model,
+  const TimeGrid& grid,
+  const PathPayoff& payoff,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  std::size_t block_paths) {
+  if (paths == 0U || grid.steps() == 0U) {
+    return MonteCarloResult{.price = 0.0, .standard_error = 0.0, .paths = 0U};
+  }
+
+  const std::uint64_t block = std::max<std::size_t>(block_paths, 1U);
+  const std::size_t blocks = static_cast<std::size_t>((paths + block - 1U) / block);
+  RunningStats stats;
+  run_block_chunks<RunningStats>(
+    blocks,
+    [&](std::size_t b, RunningStats& block_stats) {
+      const auto size = static_cast<std::size_t>(std::min(block, paths - b * block));
+      auto block_model = model.clone();
+      auto block_payoff = payoff.clone();
+      RandomStream rng(seed, b);
+      PathBlockBuffers buffers;
+      simulate_path_block(*block_model, grid, *block_payoff, rng, size, buffers);
+      block_stats = RunningStats{};
+      for (std::size_t i = 0; i < size; ++i) {
+        block_stats.add(buffers.payoffs[i]);
+      }
+    },
+    [&](const RunningStats& block_stats) { stats.merge(block_stats); });
+
+  const double discount = std::exp(-model.discount_rate() * grid.maturity());
+  return MonteCarloResult{
+    .price = discount * stats.mean,
+    .standard_error = discount * stats.standard_error(),
+    .paths = stats.count,
+  };
+}
+
+MultiPayoffResult path_monte_carlo_price_many(
+  const PathModel& model,
+  const TimeGrid& grid,
+  const std::vector<const PathPayoff*>& payoffs,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  bool covariance,
+  std::size_t block_paths) {
+  MultiPayoffResult result{.prices = {}, .covariance = {}, .paths = 0U};
+  const std::size_t count = payoffs.size();
+  if (paths == 0U || grid.steps() == 0U || count == 0U) {
+    result.prices.assign(count, MonteCarloResult{.price = 0.0, .standard_error = 0.0, .paths = 0U});
+    return result;
+  }
+
+  const std::uint64_t block = std::max<std::size_t>(block_paths, 1U);
+  const std::size_t blocks = static_cast<std::size_t>((paths + block - 1U) / block);
+  struct BlockResult {
+    std::vector<RunningStats> stats;
+    CoMoments moments;
+  };
+  std::vector<RunningStats> stats(count);
+  CoMoments moments;
+  run_block_chunks<BlockResult>(
+    blocks,
+    [&](std::size_t b, BlockResult& block_result) {
+      const auto size = static_cast<std::size_t>(std::min(block, paths - b * block));
+      auto block_model = model.clone();
+      std::vector<std::unique_ptr<PathPayoff>> owned;
+      std::vector<PathPayoff*> block_payoffs;
+      owned.reserve(count);
+      block_payoffs.reserve(count);
+      for (const PathPayoff* payoff : payoffs) {
+        owned.push_back(payoff->clone());
+        block_payoffs.push_back(owned.back().get());
+      }
+      RandomStream rng(seed, b);
+      PathBlockBuffers buffers;
+      std::vector<std::vector<double>> values;
+      simulate_path_block(*block_model, grid, block_payoffs, rng, size, buffers, values);
+      block_result.stats.assign(count, RunningStats{});
+      for (std::size_t p = 0; p < count; ++p) {
+        for (std::size_t i = 0; i < size; ++i) {
+          block_result.stats[p].add(values[p][i]);
+        }
+      }
+      if (covariance) {
+        block_result.moments.assign(values, size);
+      }
+    },
+    [&](const BlockResult& block_result) {
+      for (std::size_t p = 0; p < count; ++p) {
+        stats[p].merge(block_result.stats[p]);
+      }
+      if (covariance) {
+        moments.merge(block_result.moments);
+      }
+    });
+
+  const double discount = std::exp(-model.discount_rate() * grid.maturity());
+  result.prices.reserve(count);
+  for (const auto& payoff_stats : stats) {
+    result.prices.push_back(MonteCarloResult{
+      .price = discount * payoff_stats.mean,
+      .standard_error = discount * payoff_stats.standard_error(),
+      .paths = payoff_stats.count,
+    });
+  }
+  result.paths = stats.front().count;
+  if (covariance) {
+    // Population co-moments / n^2, consistent with RunningStats::standard_error.
+    const double n = static_cast<double>(moments.count);
+    const double scale = discount * discount / (n * n);
+    result.covariance.resize(count * count);
+    for (std::size_t j = 0; j < count * count; ++j) {
+      result.covariance[j] = scale * moments.comoment[j];
+    }
+  }
+  return result;
+}
+
+}  // namespace quant
@@ -0,0 +1,162 @@
+#include "quant/path_greeks.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "quant/parallel.hpp"
+#include "quant/random.hpp"
+
+namespace quant {
+
+namespace {
+
+constexpr std::size_t kDirections = 2;  // initial spot, volatility
+
+struct BlockGreeks {
+  RunningStats price;
+  RunningStats delta;
+  RunningStats gamma;
+  RunningStats vega;
+};
+
+}  // namespace
+
+MonteCarloGreeks path_monte_carlo_greeks(
+  const OptionInput& option,
+  const TimeGrid& grid,
+  const PathPayoff& payoff,
+  std::uint64_t paths,
+  std::uint64_t seed,
+  std::size_t block_paths) {
+  const MonteCarloEstimate zero{.value = 0.0, .standard_error = 0.0};
+  const bool pathwise = payoff.supports_tangents();
+  if (paths == 0U || grid.steps() == 0U) {
+    return MonteCarloGreeks{
+      .price = zero, .delta = zero, .gamma = zero, .vega = zero, .paths = 0U, .pathwise = pathwise,
+    };
+  }
+
+  const double S0 = option.spot;
+  const double sigma = option.volatility;
+  const double carry = option.rate - option.dividend_yield;
+  const std::uint64_t block = std::max<std::size_t>(block_paths, 1U);
+  const std::size_t blocks = static_cast<std::size_t>((paths + block - 1U) / block);
+  std::vector<BlockGreeks> partials(blocks);
+
+  parallel_for(blocks, [&](std::size_t b) {
+    const auto size = static_cast<std::size_t>(std::min(block, paths - b * block));
+    auto block_payoff = payoff.clone();
+    RandomStream rng(seed, b);
+
+    std::vector<double> previous(size);
+    std::vector<double> current(size, S0);
+    std::vector<double> variance(size);
+    std::vector<double> normals(size);
+    // Tangent rows: [direction][previous/current/variance][path].
+    std::vector<double> tangent_storage(kDirections * 3U * size, 0.0);
+    auto row = [&](std::size_t direction, std::size_t kind) {
+      return tangent_storage.data() + (direction * 3U + kind) * size;
+    };
+    std::fill(row(0, 1), row(0, 1) + size, 1.0);  // dS_0/dS_0
+
+    std::vector<double> lr_delta(size);
+    std::vector<double> lr_gamma(size);
+    std::vector<double> lr_vega(size, 0.0);
+
+    block_payoff->begin(size, S0);
+    double previous_time = 0.0;
+    for (std::size_t k = 0; k < grid.steps(); ++k) {
+      const double time = grid.times[k];
+      const double dt = time - previous_time;
+      const double step_var = sigma * sigma * dt;
+      const double drift = carry * dt - 0.5 * step_var;
+      const double diffusion = std::sqrt(step_var);
+      const double sqrt_dt = std::sqrt(dt);
+      previous.swap(current);
+      for (std::size_t d = 0; d < kDirections; ++d) {
+        std::swap_ranges(row(d, 0), row(d, 0) + size, row(d, 1));
+      }
+      rng.fill_normals(normals.data(), size);
+
+      double* delta_current = row(0, 1);
+      double* vega_current = row(1, 1);
+      double* vega_variance = row(1, 2);
+      const double vega_drift = (carry + 0.5 * sigma * sigma) * time;
+      for (std::size_t i = 0; i < size; ++i) {
+        const double z = normals[i];
+        current[i] = previous[i] * std::exp(drift + diffusion * z);
+        variance[i] = step_var;
+        // GBM tangents in closed form from the simulated spot.
+        delta_current[i] = current[i] / S0;
+        vega_current[i] = current[i] * (std::log(current[i] / S0) - vega_drift) / sigma;
+        vega_variance[i] = 2.0 * sigma * dt;
+        lr_vega[i] += (z * z - 1.0) / sigma - z * sqrt_dt;
+        if (k == 0U) {
+          lr_delta[i] = z / (S0 * sigma * sqrt_dt);
+          lr_gamma[i] = ((z * z - 1.0) / (sigma * sqrt_dt) - z) / (S0 * S0 * sigma * sqrt_dt);
+        }
+      }
+
+      const PathTangent tangents[kDirections] = {
+        {.previous = row(0, 0), .current = row(0, 1), .step_variance = row(0, 2)},
+        {.previous = row(1, 0), .current = row(1, 1), .step_variance = row(1, 2)},
+      };
+      block_payoff->observe(PathObservation{
+        .step = k,
+        .time = time,
+        .dt = dt,
+        .previous = previous.data(),
+        .current = current.data(),
+        .step_variance = variance.data(),
+        .size = size,
+        .tangents = pathwise ? tangents : nullptr,
+        .tangent_count = pathwise ? kDirections : 0U,
+      });
+      previous_time = time;
+    }
+
+    std::vector<double> payoffs(size);
+    block_payoff->settle(payoffs.data(), size);
+    std::vector<double> d_spot(size);
+    std::vector<double> d_vol(size);
+    if (pathwise) {
+      double* derivatives[kDirections] = {d_spot.data(), d_vol.data()};
+      block_payoff->settle_tangents(derivatives, kDirections, size);
+    }
+
+    BlockGreeks& out = partials[b];
+    for (std::size_t i = 0; i < size; ++i) {
+      out.price.add(payoffs[i]);
+      out.delta.add(pathwise ? d_spot[i] : payoffs[i] * lr_delta[i]);
+      out.vega.add(pathwise ? d_vol[i] : payoffs[i] * lr_vega[i]);
+      out.gamma.add(payoffs[i] * lr_gamma[i]);
+    }
+  });
+
+  BlockGreeks total;
+  for (const auto& partial : partials) {
+    total.price.merge(partial.price);
+    total.delta.merge(partial.delta);
+    total.gamma.merge(partial.gamma);
+    total.vega.merge(partial.vega);
+  }
+
+  const double discount = std::exp(-option.rate * grid.maturity());
+  auto estimate = [discount](const RunningStats& stats) {
+    return MonteCarloEstimate{
+      .value = discount * stats.mean,
+      .standard_error = discount * stats.standard_error(),
+    };
+  };
+  return MonteCarloGreeks{
+    .price = estimate(total.price),
+    .delta = estimate(total.delta),
+    .gamma = estimate(total.gamma),
+    .vega = estimate(total.vega),
+    .paths = total.price.count,
+    .pathwise = pathwise,
+  };
+}
+
+}  // namespace quant
@@ -0,0 +1,291 @@
+#include "quant/path_payoffs.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace quant {
+
+namespace {
+
+double vanilla(double underlying, double strike, bool is_call) {
+  return is_call ? std::max(underlying - strike, 0.0) : std::max(strike - underlying, 0.0);
+}
+
+// d(vanilla)/d(underlying); zero out of the money.
+double vanilla_slope(double underlying, double strike, bool is_call) {
+  if (is_call) {
+    return underlying > strike ? 1.0 : 0.0;
+  }
+  return underlying < strike ? -1.0 : 0.0;
+}
+
+void copy_tangents(const PathObservation& observation, std::vector<double>& state) {
+  const std::size_t size = observation.size;
+  state.resize(observation.tangent_count * size);
+  for (std::size_t d = 0; d < observation.tangent_count; ++d) {
+    const double* current = observation.tangents[d].current;
+    std::copy(current, current + size, state.begin() + static_cast<std::ptrdiff_t>(d * size));
+  }
+}
+
+}  // namespace
+
+EuropeanPathPayoff::EuropeanPathPayoff(double strike, bool is_call)
+  : strike_(strike), is_call_(is_call) {}
+
+std::unique_ptr<PathPayoff> EuropeanPathPayoff::clone() const {
+  return std::make_unique<EuropeanPathPayoff>(strike_, is_call_);
+}
+
+void EuropeanPathPayoff::begin(std::size_t size, double initial_spot) {
+  terminal_.assign(size, initial_spot);
+  terminal_tangent_.clear();
+}
+
+void EuropeanPathPayoff::observe(const PathObservation& observation) {
+  std::copy(observation.current, observation.current + observation.size, terminal_.begin());
+  if (observation.tangent_count > 0U) {
+    copy_tangents(observation, terminal_tangent_);
+  }
+}
+
+void EuropeanPathPayoff::settle(double* payoffs, std::size_t size) {
+  for (std::size_t i = 0; i < size; ++i) {
+    payoffs[i] = vanilla(terminal_[i], strike_, is_call_);
+  }
+}
+
+void EuropeanPathPayoff::settle_tangents(double* const* derivatives, std::size_t directions, std::size_t size) {
+  for (std::size_t d = 0; d < directions; ++d) {
+    const double* tangent = terminal_tangent_.data() + d * size;
+    for (std::size_t i = 0; i < size; ++i) {
+      derivatives[d][i] = vanilla_slope(terminal_[i], strike_, is_call_) * tangent[i];
+    }
+  }
+}
+
+AsianPayoff::AsianPayoff(double strike, bool is_call, AverageType average)
+  : strike_(strike), is_call_(is_call), average_(average) {}
+
+std::unique_ptr<PathPayoff> AsianPayoff::clone() const {
+  return std::make_unique<AsianPayoff>(strike_, is_call_, average_);
+}
+
+void AsianPayoff::begin(std::size_t size, double) {
+  observations_ = 0;
+  sum_.assign(size, 0.0);
+  sum_tangent_.clear();
+}
+
+void AsianPayoff::observe(const PathObservation& observation) {
+  const double* spot = observation.current;
+  const std::size_t size = observation.size;
+  if (average_ == AverageType::arithmetic) {
+    for (std::size_t i = 0; i < size; ++i) {
+      sum_[i] += spot[i];
+    }
+  } else {
+    for (std::size_t i = 0; i < size; ++i) {
+      sum_[i] += std::log(spot[i]);
+    }
+  }
+
+  if (observation.tangent_count > 0U) {
+    sum_tangent_.resize(observation.tangent_count * size, 0.0);
+    for (std::size_t d = 0; d < observation.tangent_count; ++d) {
+      const double* tangent = observation.tangents[d].current;
+      double* accumulated = sum_tangent_.data() + d * size;
+      for (std::size_t i = 0; i < size; ++i) {
+        accumulated[i] += average_ == AverageType::arithmetic ? tangent[i] : tangent[i] / spot[i];
+      }
+    }
+  }
+  ++observations_;
+}
+
+void AsianPayoff::settle(double* payoffs, std::size_t size) {
+  const double inv_n = observations_ == 0U ? 0.0 : 1.0 / static_cast<double>(observations_);
+  for (std::size_t i = 0; i < size; ++i) {
+    const double average = average_ == AverageType::arithmetic
+      ? sum_[i] * inv_n
+      : std::exp(sum_[i] * inv_n);
+    payoffs[i] = vanilla(average, strike_, is_call_);
+  }
+}
+
+void AsianPayoff::settle_tangents(double* const* derivatives, std::size_t directions, std::size_t size) {
+  const double inv_n = observations_ == 0U ? 0.0 : 1.0 / static_cast<double>(observations_);
+  for (std::size_t d = 0; d < directions; ++d) {
+    const double* tangent = sum_tangent_.data() + d * size;
+    for (std::size_t i = 0; i < size; ++i) {
+      const double average = average_ == AverageType::arithmetic
+        ? sum_[i] * inv_n
+        : std::exp(sum_[i] * inv_n);
+      // Geometric: d(exp(mean log S)) = G * mean(dS / S).
+      const double d_average = average_ == AverageType::arithmetic
+        ? tangent[i] * inv_n
+        : average * tangent[i] * inv_n;
+      derivatives[d][i] = vanilla_slope(average, strike_, is_call_) * d_average;
+    }
+  }
+}
+
+BarrierPayoff::BarrierPayoff(double strike, bool is_call, double barrier, BarrierType type)
+  : strike_(strike), is_call_(is_call), barrier_(barrier), type_(type) {}
+
+std::unique_ptr<PathPayoff> BarrierPayoff::clone() const {
+  return std::make_unique<BarrierPayoff>(strike_, is_call_, barrier_, type_);
+}
+
+void BarrierPayoff::begin(std::size_t size, double initial_spot) {
+  terminal_.assign(size, initial_spot);
+  survival_.assign(size, 1.0);
+  terminal_tangent_.clear();
+  survival_tangent_.clear();
+}
+
+void BarrierPayoff::observe(const PathObservation& observation) {
+  const bool up = type_ == BarrierType::up_and_out || type_ == BarrierType::up_and_in;
+  const double sign = up ? -1.0 : 1.0;
+  const double log_barrier = std::log(barrier_);
+  const std::size_t size = observation.size;
+  const std::size_t directions = observation.tangent_count;
+  if (directions > 0U) {
+    survival_tangent_.resize(directions * size, 0.0);
+  }
+
+  for (std::size_t i = 0; i < size; ++i) {
+    // Distances to the barrier are positive while the path is on the live side.
+    const double a = sign * (std::log(observation.previous[i]) - log_barrier);
+    const double b = sign * (std::log(observation.current[i]) - log_barrier);
+    const double variance = observation.step_variance[i];
+    double survive = 0.0;
+    double crossing = 0.0;
+    if (a > 0.0 && b > 0.0) {
+      crossing = variance > 0.0 ? std::exp(-2.0 * a * b / variance) : 0.0;
+      survive = 1.0 - crossing;
+    }
+
+    for (std::size_t d = 0; d < directions; ++d) {
+      const PathTangent& t = observation.tangents[d];
+      double d_survive = 0.0;
+      if (crossing > 0.0) {
+        const double da = sign * t.previous[i] / observation.previous[i];
+        const double db = sign * t.current[i] / observation.current[i];
+        const double dv = t.step_variance[i];
+        d_survive = crossing * (2.0 * (da * b + a * db) / variance - 2.0 * a * b * dv / (variance * variance));
+      }
+      double& ds = survival_tangent_[d * size + i];
+      ds = ds * survive + survival_[i] * d_survive;
+    }
+    survival_[i] *= survive;
+    terminal_[i] = observation.current[i];
+  }
+
+  if (directions > 0U) {
+    copy_tangents(observation, terminal_tangent_);
+  }
+}
+
+void BarrierPayoff::settle(double* payoffs, std::size_t size) {
+  const bool knock_out = type_ == BarrierType::up_and_out || type_ == BarrierType::down_and_out;
+  for (std::size_t i = 0; i < size; ++i) {
+    const double weight = knock_out ? survival_[i] : 1.0 - survival_[i];
+    payoffs[i] = weight * vanilla(terminal_[i], strike_, is_call_);
+  }
+}
+
+void BarrierPayoff::settle_tangents(double* const* derivatives, std::size_t directions, std::size_t size) {
+  const bool knock_out = type_ == BarrierType::up_and_out || type_ == BarrierType::down_and_out;
+  for (std::size_t d = 0; d < directions; ++d) {
+    const double* d_terminal = terminal_tangent_.data() + d * size;
+    const double* d_survival = survival_tangent_.data() + d * size;
+    for (std::size_t i = 0; i < size; ++i) {
+      const double weight = knock_out ? survival_[i] : 1.0 - survival_[i];
+      const double d_weight = knock_out ? d_survival[i] : -d_survival[i];
+      derivatives[d][i] = d_weight * vanilla(terminal_[i], strike_, is_call_)
+        + weight * vanilla_slope(terminal_[i], strike_, is_call_) * d_terminal[i];
+    }
+  }
+}
+
+LookbackPayoff::LookbackPayoff(double strike, bool is_call, bool floating_strike)
+  : strike_(strike), is_call_(is_call), floating_strike_(floating_strike) {}
+
+std::unique_ptr<PathPayoff> LookbackPayoff::clone() const {
+  return std::make_unique<LookbackPayoff>(strike_, is_call_, floating_strike_);
+}
+
+void LookbackPayoff::begin(std::size_t size, double initial_spot) {
+  terminal_.assign(size, initial_spot);
+  minimum_.assign(size, initial_spot);
+  maximum_.assign(size, initial_spot);
+  terminal_tangent_.clear();
+  minimum_tangent_.clear();
+  maximum_tangent_.clear();
+}
+
+void LookbackPayoff::observe(const PathObservation& observation) {
+  const double* spot = observation.current;
+  const std::size_t size = observation.size;
+  const std::size_t directions = observation.tangent_count;
+  if (directions > 0U && minimum_tangent_.empty()) {
+    // Extremes start at t_0, whose tangent is the first step's `previous`.
+    minimum_tangent_.resize(directions * size);
+    for (std::size_t d = 0; d < directions; ++d) {
+      const double* initial = observation.tangents[d].previous;
+      std::copy(initial, initial + size, minimum_tangent_.begin() + static_cast<std::ptrdiff_t>(d * size));
+    }
+    maximum_tangent_ = minimum_tangent_;
+  }
+
+  for (std::size_t i = 0; i < size; ++i) {
+    if (spot[i] < minimum_[i]) {
+      minimum_[i] = spot[i];
+      for (std::size_t d = 0; d < directions; ++d) {
+        minimum_tangent_[d * size + i] = observation.tangents[d].current[i];
+      }
+    }
+    if (spot[i] > maximum_[i]) {
+      maximum_[i] = spot[i];
+      for (std::size_t d = 0; d < directions; ++d) {
+        maximum_tangent_[d * size + i] = observation.tangents[d].current[i];
+      }
+    }
+    terminal_[i] = spot[i];
+  }
+
+  if (directions > 0U) {
+    copy_tangents(observation, terminal_tangent_);
+  }
+}
+
+void LookbackPayoff::settle(double* payoffs, std::size_t size) {
+  for (std::size_t i = 0; i < size; ++i) {
+    if (floating_strike_) {
+      payoffs[i] = is_call_ ? terminal_[i] - minimum_[i] : maximum_[i] - terminal_[i];
+    } else {
+      payoffs[i] = is_call_ ? std::max(maximum_[i] - strike_, 0.0)
+                            : std::max(strike_ - minimum_[i], 0.0);
+    }
+  }
+}
+
+void LookbackPayoff::settle_tangents(double* const* derivatives, std::size_t directions, std::size_t size) {
+  for (std::size_t d = 0; d < directions; ++d) {
+    const double* d_terminal = terminal_tangent_.data() + d * size;
+    const double* d_minimum = minimum_tangent_.data() + d * size;
+    const double* d_maximum = maximum_tangent_.data() + d * size;
+    for (std::size_t i = 0; i < size; ++i) {
+      if (floating_strike_) {
+        derivatives[d][i] = is_call_ ? d_terminal[i] - d_minimum[i] : d_maximum[i] - d_terminal[i];
+      } else if (is_call_) {
+        derivatives[d][i] = maximum_[i] > strike_ ? d_maximum[i] : 0.0;
+      } else {
+        derivatives[d][i] = minimum_[i] < strike_ ? -d_minimum[i] : 0.0;
+      }
+    }
+  }
+}
+
+}  // namespace quant
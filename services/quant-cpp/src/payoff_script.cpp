@@ -0,0 +1,673 @@
+#include "quant/payoff_script.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <optional>
+
+namespace quant {
+
+namespace {
+
+// Fixed register layout; constants, variables and temporaries follow.
+enum Builtin : std::uint16_t {
+  kSpot,
+  kPreviousSpot,
+  kInitialSpot,
+  kTime,
+  kStepLength,
+  kMaturity,
+  kStepIndex,
+  kIsLast,
+  kAlive,
+  kBuiltinCount,
+};
+
+constexpr std::uint16_t kTempFlag = 0x8000;
+// Each register is a block-sized buffer in every worker's payoff clone.
+constexpr std::size_t kMaxRegisters = 1024;
+// Nested statements plus nested expressions; bounds the parser's recursion.
+constexpr std::size_t kMaxNesting = 256;
+
+struct Token {
+  enum class Kind { number, identifier, symbol, end };
+  Kind kind;
+  std::string text;
+  double value = 0.0;
+  std::size_t line = 1;
+};
+
+std::optional<std::string> tokenize(std::string_view source, std::vector<Token>& tokens) {
+  std::size_t line = 1;
+  std::size_t i = 0;
+  while (i < source.size()) {
+    const char c = source[i];
+    if (c == '\n') {
+      ++line;
+      ++i;
+    } else if (std::isspace(static_cast<unsigned char>(c)) != 0) {
+      ++i;
+    } else if (c == '#' || (c == '/' && i + 1 < source.size() && source[i + 1] == '/')) {
+      while (i < source.size() && source[i] != '\n') {
+        ++i;
+      }
+    } else if (std::isdigit(static_cast<unsigned char>(c)) != 0 || c == '.') {
+      const std::string rest(source.substr(i, std::min<std::size_t>(source.size() - i, 64U)));
+      char* end = nullptr;
+      const double value = std::strtod(rest.c_str(), &end);
+      if (end == rest.c_str()) {
+        return "line " + std::to_string(line) + ": malformed number";
+      }
+      const auto length = static_cast<std::size_t>(end - rest.c_str());
+      tokens.push_back(Token{Token::Kind::number, rest.substr(0, length), value, line});
+      i += length;
+    } else if (std::isalpha(static_cast<unsigned char>(c)) != 0 || c == '_') {
+      std::size_t j = i;
+      while (j < source.size() && (std::isalnum(static_cast<unsigned char>(source[j])) != 0 || source[j] == '_')) {
+        ++j;
+      }
+      tokens.push_back(Token{Token::Kind::identifier, std::string(source.substr(i, j - i)), 0.0, line});
+      i = j;
+    } else {
+      static constexpr std::string_view kTwoChar[] = {"==", "!=", "<=", ">=", "&&", "||"};
+      std::string text(1, c);
+      for (const auto op : kTwoChar) {
+        if (source.substr(i, 2) == op) {
+          text = std::string(op);
+        }
+      }
+      if (text.size() == 1U && std::string_view("+-*/%()<>!?:,;={}").find(c) == std::string_view::npos) {
+        return "line " + std::to_string(line) + ": unexpected character '" + text + "'";
+      }
+      tokens.push_back(Token{Token::Kind::symbol, text, 0.0, line});
+      i += text.size();
+    }
+  }
+  tokens.push_back(Token{Token::Kind::end, "", 0.0, line});
+  return std::nullopt;
+}
+
+// Recursive-descent parser that emits bytecode directly. Temporaries are
+// numbered in their own space (flagged with kTempFlag) and relocated once the
+// constant and variable counts are known. Expression temporaries form a stack:
+// an instruction consumes the topmost ones, so its result reuses the register
+// of its lowest operand.
+class Compiler {
+ public:
+  explicit Compiler(std::vector<Token> tokens) : tokens_(std::move(tokens)) {
+    symbols_ = {
+      {"S", kSpot},
+      {"S_prev", kPreviousSpot},
+      {"S0", kInitialSpot},
+      {"t", kTime},
+      {"dt", kStepLength},
+      {"T", kMaturity},
+      {"step", kStepIndex},
+      {"is_last", kIsLast},
+    };
+  }
+
+  bool compile(PayoffProgram& program) {
+    while (!at_end()) {
+      if (!statement(kAlive, true)) {
+        return false;
+      }
+    }
+    return finish(program);
+  }
+
+  const std::string& error() const { return error_; }
+
+ private:
+  // ---- token helpers ----
+  const Token& peek() const { return tokens_[position_]; }
+  bool at_end() const { return peek().kind == Token::Kind::end; }
+  bool check(std::string_view symbol) const {
+    return peek().kind == Token::Kind::symbol && peek().text == symbol;
+  }
+  bool accept(std::string_view symbol) {
+    if (check(symbol)) {
+      ++position_;
+      return true;
+    }
+    return false;
+  }
+  bool accept_keyword(std::string_view keyword) {
+    if (peek().kind == Token::Kind::identifier && peek().text == keyword) {
+      ++position_;
+      return true;
+    }
+    return false;
+  }
+  bool fail(const std::string& message) {
+    if (error_.empty()) {
+      error_ = "line " + std::to_string(peek().line) + ": " + message;
+    }
+    return false;
+  }
+  bool expect(std::string_view symbol) {
+    return accept(symbol) || fail("expected '" + std::string(symbol) + "'");
+  }
+
+  // Counts one level of statement or expression nesting for its lifetime.
+  class Nesting {
+   public:
+    explicit Nesting(std::size_t& depth) : depth_(++depth) {}
+    ~Nesting() { --depth_; }
+    Nesting(const Nesting&) = delete;
+    Nesting& operator=(const Nesting&) = delete;
+
+   private:
+    std::size_t& depth_;
+  };
+  bool too_deep() {
+    if (depth_ <= kMaxNesting) {
+      return false;
+    }
+    fail("nested more than " + std::to_string(kMaxNesting) + " levels deep");
+    return true;
+  }
+
+  // ---- registers ----
+  std::uint16_t temp() {
+    const auto reg = static_cast<std::uint16_t>(kTempFlag | next_temp_);
+    ++next_temp_;
+    max_temp_ = std::max(max_temp_, next_temp_);
+    check_registers();
+    return reg;
+  }
+  // Checked as registers are handed out, so the error names the line.
+  void check_registers() {
+    if (kBuiltinCount + constants_.size() + variables_.size() + max_temp_ > kMaxRegisters) {
+      fail("script needs more than " + std::to_string(kMaxRegisters) + " registers");
+    }
+  }
+  std::uint16_t constant(double value) {
+    const auto found = constants_.find(value);
+    if (found != constants_.end()) {
+      return found->second;
+    }
+    const auto reg = static_cast<std::uint16_t>(kBuiltinCount + constants_.size() + variables_.size());
+    constants_.emplace(value, reg);
+    check_registers();
+    return reg;
+  }
+  void emit(ScriptOp op, std::uint16_t dst, std::uint16_t a, std::uint16_t b = 0, std::uint16_t c = 0) {
+    (in_init_ ? init_ : step_).push_back(ScriptInstruction{op, dst, a, b, c});
+  }
+  // An expression value; temporaries among the operands are released.
+  std::uint16_t emit_value(ScriptOp op, std::uint16_t a, std::uint16_t b = 0, std::uint16_t c = 0) {
+    for (const std::uint16_t operand : {a, b, c}) {
+      if ((operand & kTempFlag) != 0U) {
+        next_temp_ = std::min(next_temp_, static_cast<std::uint16_t>(operand & ~kTempFlag));
+      }
+    }
+    return emit_mask(op, a, b, c);
+  }
+  // A mask. Its operands stay put: the enclosing mask is still live.
+  std::uint16_t emit_mask(ScriptOp op, std::uint16_t a, std::uint16_t b = 0, std::uint16_t c = 0) {
+    const std::uint16_t dst = temp();
+    emit(op, dst, a, b, c);
+    return dst;
+  }
+
+  // ---- statements ----
+  bool statement(std::uint16_t mask, bool top_level) {
+    const Nesting nesting(depth_);
+    if (too_deep()) {
+      return false;
+    }
+    const std::uint16_t mark = next_temp_;
+    const bool ok = statement_body(mask, top_level) && error_.empty();
+    next_temp_ = mark;
+    return ok;
+  }
+
+  bool statement_body(std::uint16_t mask, bool top_level) {
+    if (accept_keyword("var")) {
+      if (!top_level) {
+        return fail("'var' is only allowed at top level");
+      }
+      if (peek().kind != Token::Kind::identifier) {
+        return fail("expected variable name");
+      }
+      const std::string name = peek().text;
+      ++position_;
+      if (symbols_.contains(name)) {
+        return fail("'" + name + "' is already defined");
+      }
+      if (!expect("=")) {
+        return false;
+      }
+      in_init_ = true;
+      std::uint16_t value = 0;
+      bool ok = expression(value);
+      if (ok) {
+        // Constants and variables share one dense index space. The register
+        // is counted before ';' so an overflow reports this line.
+        const auto reg = static_cast<std::uint16_t>(kBuiltinCount + constants_.size() + variables_.size());
+        symbols_[name] = reg;
+        variables_.push_back(name);
+        check_registers();
+        emit(ScriptOp::assign, reg, kAlive, value);
+        ok = expect(";");
+      }
+      in_init_ = false;
+      return ok;
+    }
+    if (accept_keyword("if")) {
+      std::uint16_t condition = 0;
+      if (!expression(condition)) {
+        return false;
+      }
+      const std::uint16_t then_mask = emit_mask(ScriptOp::logical_and, mask, condition);
+      if (!block(then_mask)) {
+        return false;
+      }
+      if (accept_keyword("else")) {
+        // The then-block may have reassigned the condition's variables, so
+        // negate the mask it ran under instead.
+        const std::uint16_t negated = emit_mask(ScriptOp::logical_not, then_mask);
+        const std::uint16_t else_mask = emit_mask(ScriptOp::logical_and, mask, negated);
+        if (check("{")) {
+          return block(else_mask);
+        }
+        if (peek().kind == Token::Kind::identifier && peek().text == "if") {
+          return statement(else_mask, false);
+        }
+        return fail("expected '{' or 'if' after 'else'");
+      }
+      return true;
+    }
+    if (accept_keyword("pay")) {
+      std::uint16_t value = 0;
+      if (!expression(value) || !expect(";")) {
+        return false;
+      }
+      emit(ScriptOp::pay, 0, mask, value);
+      return true;
+    }
+    if (accept_keyword("stop")) {
+      emit(ScriptOp::stop, 0, mask);
+      return expect(";");
+    }
+    if (peek().kind == Token::Kind::identifier) {
+      const std::string name = peek().text;
+      ++position_;
+      const auto found = symbols_.find(name);
+      if (found == symbols_.end()) {
+        return fail("unknown variable '" + name + "'");
+      }
+      if (found->second < kBuiltinCount) {
+        return fail("cannot assign to builtin '" + name + "'");
+      }
+      std::uint16_t value = 0;
+      if (!expect("=") || !expression(value) || !expect(";")) {
+        return false;
+      }
+      emit(ScriptOp::assign, found->second, mask, value);
+      return true;
+    }
+    return fail("expected a statement");
+  }
+
+  bool block(std::uint16_t mask) {
+    if (!expect("{")) {
+      return false;
+    }
+    while (!check("}")) {
+      if (at_end()) {
+        return fail("unterminated block");
+      }
+      if (!statement(mask, false)) {
+        return false;
+      }
+    }
+    ++position_;
+    return true;
+  }
+
+  // ---- expressions ----
+  bool expression(std::uint16_t& out) {
+    const Nesting nesting(depth_);
+    if (too_deep()) {
+      return false;
+    }
+    if (!logical_or(out)) {
+      return false;
+    }
+    if (accept("?")) {
+      std::uint16_t when_true = 0;
+      std::uint16_t when_false = 0;
+      if (!expression(when_true) || !expect(":") || !expression(when_false)) {
+        return false;
+      }
+      out = emit_value(ScriptOp::select, out, when_true, when_false);
+    }
+    return true;
+  }
+
+  bool logical_or(std::uint16_t& out) {
+    if (!logical_and(out)) {
+      return false;
+    }
+    while (accept("||")) {
+      std::uint16_t rhs = 0;
+      if (!logical_and(rhs)) {
+        return false;
+      }
+      out = emit_value(ScriptOp::logical_or, out, rhs);
+    }
+    return true;
+  }
+
+  bool logical_and(std::uint16_t& out) {
+    if (!comparison(out)) {
+      return false;
+    }
+    while (accept("&&")) {
+      std::uint16_t rhs = 0;
+      if (!comparison(rhs)) {
+        return false;
+      }
+      out = emit_value(ScriptOp::logical_and, out, rhs);
+    }
+    return true;
+  }
+
+  bool comparison(std::uint16_t& out) {
+    if (!additive(out)) {
+      return false;
+    }
+    static const std::pair<std::string_view, ScriptOp> kOps[] = {
+      {"<", ScriptOp::lt}, {"<=", ScriptOp::le}, {">", ScriptOp::gt},
+      {">=", ScriptOp::ge}, {"==", ScriptOp::eq}, {"!=", ScriptOp::ne},
+    };
+    for (const auto& [symbol, op] : kOps) {
+      if (accept(symbol)) {
+        std::uint16_t rhs = 0;
+        if (!additive(rhs)) {
+          return false;
+        }
+        out = emit_value(op, out, rhs);
+        return true;
+      }
+    }
+    return true;
+  }
+
+  bool additive(std::uint16_t& out) {
+    if (!multiplicative(out)) {
+      return false;
+    }
+    for (;;) {
+      const ScriptOp op = check("+") ? ScriptOp::add : ScriptOp::sub;
+      if (!accept("+") && !accept("-")) {
+        return true;
+      }
+      std::uint16_t rhs = 0;
+      if (!multiplicative(rhs)) {
+        return false;
+      }
+      out = emit_value(op, out, rhs);
+    }
+  }
+
+  bool multiplicative(std::uint16_t& out) {
+    if (!unary(out)) {
+      return false;
+    }
+    for (;;) {
+      const ScriptOp op = check("*") ? ScriptOp::mul : check("/") ? ScriptOp::div : ScriptOp::mod;
+      if (!accept("*") && !accept("/") && !accept("%")) {
+        return true;
+      }
+      std::uint16_t rhs = 0;
+      if (!unary(rhs)) {
+        return false;
+      }
+      out = emit_value(op, out, rhs);
+    }
+  }
+
+  bool unary(std::uint16_t& out) {
+    // Prefix operators are collected iteratively and applied innermost first.
+    std::vector<ScriptOp> prefixes;
+    while (check("-") || check("!")) {
+      prefixes.push_back(check("-") ? ScriptOp::neg : ScriptOp::logical_not);
+      ++position_;
+    }
+    if (!primary(out)) {
+      return false;
+    }
+    for (auto op = prefixes.rbegin(); op != prefixes.rend(); ++op) {
+      out = emit_value(*op, out);
+    }
+    return true;
+  }
+
+  bool primary(std::uint16_t& out) {
+    const Token token = peek();
+    if (token.kind == Token::Kind::number) {
+      ++position_;
+      out = constant(token.value);
+      return true;
+    }
+    if (accept("(")) {
+      return expression(out) && expect(")");
+    }
+    if (token.kind != Token::Kind::identifier) {
+      return fail("expected an expression");
+    }
+    ++position_;
+    if (accept("(")) {
+      return call(token.text, out);
+    }
+    const auto found = symbols_.find(token.text);
+    if (found == symbols_.end()) {
+      return fail("unknown variable '" + token.text + "'");
+    }
+    if (in_init_ && (found->second == kSpot || found->second == kPreviousSpot)) {
+      // S and S_prev read S0 during initialisation.
+      out = kInitialSpot;
+      return true;
+    }
+    out = found->second;
+    return true;
+  }
+
+  bool call(const std::string& name, std::uint16_t& out) {
+    const bool fold = name == "min" || name == "max";
+    const ScriptOp fold_op = name == "min" ? ScriptOp::min : ScriptOp::max;
+    std::size_t count = 0;
+    if (!check(")")) {
+      do {
+        std::uint16_t arg = 0;
+        if (!expression(arg)) {
+          return false;
+        }
+        // min and max fold each argument in as it is parsed, keeping the
+        // operands on top of the temporary stack.
+        out = fold && count > 0U ? emit_value(fold_op, out, arg) : arg;
+        ++count;
+      } while (accept(","));
+    }
+    if (!expect(")")) {
+      return false;
+    }
+    if (fold) {
+      if (count < 2U) {
+        return fail(name + " needs at least two arguments");
+      }
+      return true;
+    }
+    static const std::pair<std::string_view, ScriptOp> kUnary[] = {
+      {"abs", ScriptOp::abs}, {"exp", ScriptOp::exp}, {"log", ScriptOp::log}, {"sqrt", ScriptOp::sqrt},
+    };
+    for (const auto& [function, op] : kUnary) {
+      if (name == function) {
+        if (count != 1U) {
+          return fail(name + " takes one argument");
+        }
+        out = emit_value(op, out);
+        return true;
+      }
+    }
+    return fail("unknown function '" + name + "'");
+  }
+
+  bool finish(PayoffProgram& program) {
+    const std::size_t fixed = kBuiltinCount + constants_.size() + variables_.size();
+    const auto relocate = [fixed](std::uint16_t reg) {
+      return (reg & kTempFlag) != 0U ? static_cast<std::uint16_t>(fixed + (reg & ~kTempFlag)) : reg;
+    };
+    const auto relocate_all = [&](std::vector<ScriptInstruction>& code) {
+      for (auto& instruction : code) {
+        instruction.dst = relocate(instruction.dst);
+        instruction.a = relocate(instruction.a);
+        instruction.b = relocate(instruction.b);
+        instruction.c = relocate(instruction.c);
+      }
+    };
+    relocate_all(init_);
+    relocate_all(step_);
+    program.init = std::move(init_);
+    program.step = std::move(step_);
+    program.constants.clear();
+    for (const auto& [value, reg] : constants_) {
+      program.constants.emplace_back(reg, value);
+    }
+    program.variables = variables_;
+    program.registers = fixed + max_temp_;
+    return true;
+  }
+
+  std::vector<Token> tokens_;
+  std::size_t position_ = 0;
+  std::size_t depth_ = 0;
+  std::string error_;
+  std::map<std::string, std::uint16_t> symbols_;
+  std::map<double, std::uint16_t> constants_;
+  std::vector<std::string> variables_;
+  std::vector<ScriptInstruction> init_;
+  std::vector<ScriptInstruction> step_;
+  bool in_init_ = false;
+  std::uint16_t next_temp_ = 0;
+  std::uint16_t max_temp_ = 0;
+};
+
+}  // namespace
+
+PayoffScriptCompilation compile_payoff_script(std::string_view source) {
+  std::vector<Token> tokens;
+  if (auto error = tokenize(source, tokens)) {
+    return PayoffScriptCompilation{.program = nullptr, .error = std::move(*error)};
+  }
+  Compiler compiler(std::move(tokens));
+  auto program = std::make_shared<PayoffProgram>();
+  if (!compiler.compile(*program)) {
+    return PayoffScriptCompilation{.program = nullptr, .error = compiler.error()};
+  }
+  return PayoffScriptCompilation{.program = std::move(program), .error = {}};
+}
+
+ScriptPayoff::ScriptPayoff(std::shared_ptr<const PayoffProgram> program, double rate, double maturity)
+  : program_(std::move(program)), rate_(rate), maturity_(maturity) {}
+
+std::unique_ptr<PathPayoff> ScriptPayoff::clone() const {
+  return std::make_unique<ScriptPayoff>(program_, rate_, maturity_);
+}
+
+void ScriptPayoff::begin(std::size_t size, double initial_spot) {
+  size_ = size;
+  steps_ = 0;
+  const std::size_t count = std::max<std::size_t>(program_->registers, kBuiltinCount);
+  storage_.assign(count * size, 0.0);
+  registers_.resize(count);
+  for (std::size_t r = 0; r < count; ++r) {
+    registers_[r] = storage_.data() + r * size;
+  }
+  const auto fill = [&](std::size_t reg, double value) {
+    std::fill(registers_[reg], registers_[reg] + size, value);
+  };
+  fill(kInitialSpot, initial_spot);
+  fill(kMaturity, maturity_);
+  fill(kAlive, 1.0);
+  for (const auto& [reg, value] : program_->constants) {
+    fill(reg, value);
+  }
+  cash_.assign(size, 0.0);
+  run(program_->init, 1.0);
+}
+
+void ScriptPayoff::observe(const PathObservation& observation) {
+  ++steps_;
+  const std::size_t size = observation.size;
+  // The interpreter never writes builtins, so the spot registers can alias
+  // the engine's buffers instead of being copied.
+  registers_[kSpot] = const_cast<double*>(observation.current);
+  registers_[kPreviousSpot] = const_cast<double*>(observation.previous);
+  const bool last = observation.time >= maturity_ * (1.0 - 1e-12);
+  std::fill(registers_[kTime], registers_[kTime] + size, observation.time);
+  std::fill(registers_[kStepLength], registers_[kStepLength] + size, observation.dt);
+  std::fill(registers_[kStepIndex], registers_[kStepIndex] + size, static_cast<double>(steps_));
+  std::fill(registers_[kIsLast], registers_[kIsLast] + size, last ? 1.0 : 0.0);
+  run(program_->step, std::exp(rate_ * (maturity_ - observation.time)));
+}
+
+void ScriptPayoff::settle(double* payoffs, std::size_t size) {
+  std::copy_n(cash_.data(), std::min(size, cash_.size()), payoffs);
+}
+
+void ScriptPayoff::run(const std::vector<ScriptInstruction>& code, double growth) {
+  const std::size_t n = size_;
+  double* alive = registers_[kAlive];
+  double* cash = cash_.data();
+  for (const auto& instruction : code) {
+    double* d = registers_[instruction.dst];
+    const double* a = registers_[instruction.a];
+    const double* b = registers_[instruction.b];
+    const double* c = registers_[instruction.c];
+    switch (instruction.op) {
+      case ScriptOp::add: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] + b[i]; break;
+      case ScriptOp::sub: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] - b[i]; break;
+      case ScriptOp::mul: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] * b[i]; break;
+      case ScriptOp::div: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] / b[i]; break;
+      case ScriptOp::mod: for (std::size_t i = 0; i < n; ++i) d[i] = std::fmod(a[i], b[i]); break;
+      case ScriptOp::neg: for (std::size_t i = 0; i < n; ++i) d[i] = -a[i]; break;
+      case ScriptOp::min: for (std::size_t i = 0; i < n; ++i) d[i] = std::min(a[i], b[i]); break;
+      case ScriptOp::max: for (std::size_t i = 0; i < n; ++i) d[i] = std::max(a[i], b[i]); break;
+      case ScriptOp::abs: for (std::size_t i = 0; i < n; ++i) d[i] = std::abs(a[i]); break;
+      case ScriptOp::exp: for (std::size_t i = 0; i < n; ++i) d[i] = std::exp(a[i]); break;
+      case ScriptOp::log: for (std::size_t i = 0; i < n; ++i) d[i] = std::log(a[i]); break;
+      case ScriptOp::sqrt: for (std::size_t i = 0; i < n; ++i) d[i] = std::sqrt(a[i]); break;
+      case ScriptOp::lt: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] < b[i] ? 1.0 : 0.0; break;
+      case ScriptOp::le: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] <= b[i] ? 1.0 : 0.0; break;
+      case ScriptOp::gt: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] > b[i] ? 1.0 : 0.0; break;
+      case ScriptOp::ge: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] >= b[i] ? 1.0 : 0.0; break;
+      case ScriptOp::eq: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] == b[i] ? 1.0 : 0.0; break;
+      case ScriptOp::ne: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] != b[i] ? 1.0 : 0.0; break;
+      case ScriptOp::logical_and:
+        for (std::size_t i = 0; i < n; ++i) d[i] = (a[i] != 0.0 && b[i] != 0.0) ? 1.0 : 0.0;
+        break;
+      case ScriptOp::logical_or:
+        for (std::size_t i = 0; i < n; ++i) d[i] = (a[i] != 0.0 || b[i] != 0.0) ? 1.0 : 0.0;
+        break;
+      case ScriptOp::logical_not: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] == 0.0 ? 1.0 : 0.0; break;
+      case ScriptOp::select: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] != 0.0 ? b[i] : c[i]; break;
+      case ScriptOp::assign:
+        for (std::size_t i = 0; i < n; ++i) d[i] = (a[i] != 0.0 && alive[i] != 0.0) ? b[i] : d[i];
+        break;
+      case ScriptOp::pay:
+        for (std::size_t i = 0; i < n; ++i) cash[i] += (a[i] != 0.0 && alive[i] != 0.0) ? b[i] * growth : 0.0;
+        break;
+      case ScriptOp::stop:
+        for (std::size_t i = 0; i < n; ++i) alive[i] = a[i] != 0.0 ? 0.0 : alive[i];
+        break;
+    }
+  }
+}
+
+}  // namespace quant
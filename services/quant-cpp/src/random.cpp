@@ -0,0 +1,64 @@
+#include "quant/random.hpp"
+
+#include <cmath>
+
+namespace quant {
+
+namespace {
+
+constexpr double kTwoPi = 6.28318530717958647692;
+
+std::uint64_t splitmix64(std::uint64_t& state) {
+  std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31U);
+}
+
+std::uint64_t rotl(std::uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+}  // namespace
+
+RandomStream::RandomStream(std::uint64_t seed, std::uint64_t stream) {
+  std::uint64_t mix = seed;
+  const std::uint64_t key = splitmix64(mix) ^ (stream * 0xD1B54A32D192ED03ULL);
+  std::uint64_t state = key;
+  for (auto& word : state_) {
+    word = splitmix64(state);
+  }
+}
+
+std::uint64_t RandomStream::next_u64() {
+  const std::uint64_t result = rotl(state_[1] * 5U, 7) * 9U;
+  const std::uint64_t t = state_[1] << 17U;
+  state_[2] ^= state_[0];
+  state_[3] ^= state_[1];
+  state_[1] ^= state_[2];
+  state_[0] ^= state_[3];
+  state_[2] ^= t;
+  state_[3] = rotl(state_[3], 45);
+  return result;
+}
+
+double RandomStream::next_uniform() {
+  // 53 random mantissa bits, shifted by half an ulp to exclude 0 and 1.
+  return (static_cast<double>(next_u64() >> 11U) + 0.5) * 0x1.0p-53;
+}
+
+void RandomStream::fill_normals(double* out, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + 1 < count; i += 2) {
+    const double radius = std::sqrt(-2.0 * std::log(next_uniform()));
+    const double angle = kTwoPi * next_uniform();
+    out[i] = radius * std::cos(angle);
+    out[i + 1] = radius * std::sin(angle);
+  }
+  if (i < count) {
+    const double radius = std::sqrt(-2.0 * std::log(next_uniform()));
+    out[i] = radius * std::cos(kTwoPi * next_uniform());
+  }
+}
+
+}  // namespace quant
@@ -0,0 +1,54 @@
+#include "quant/request_coalescer.hpp"
+
+#include <exception>
+
+namespace quant {
+
+std::string RequestCoalescer::run(const CacheKey& key, const std::function<std::string()>& compute) {
+  std::shared_ptr<Flight> flight;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (const auto found = flights_.find(key.bytes()); found != flights_.end()) {
+      ++followers_;
+      flight = found->second;
+      lock.unlock();
+      flight->done.wait();
+      if (flight->error) {
+        std::rethrow_exception(flight->error);
+      }
+      return flight->result;
+    }
+    ++leaders_;
+    flight = std::make_shared<Flight>();
+    flights_.emplace(key.bytes(), flight);
+  }
+  // Retire the flight before publishing, so a caller that sees it finished
+  // never attaches to it afterwards; current followers hold their own
+  // reference to it.
+  const auto retire = [&] {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flights_.erase(key.bytes());
+  };
+  try {
+    flight->result = compute();
+    retire();
+    flight->done.set();
+    return flight->result;
+  } catch (...) {
+    retire();
+    flight->error = std::current_exception();
+    flight->done.set();
+    throw;
+  }
+}
+
+RequestCoalescerStats RequestCoalescer::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return RequestCoalescerStats{
+    .leaders = leaders_,
+    .followers = followers_,
+    .in_flight = flights_.size(),
+  };
+}
+
+}  // namespace quant
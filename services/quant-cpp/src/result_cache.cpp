@@ -0,0 +1,273 @@
+#include "quant/result_cache.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+namespace quant {
+
+namespace {
+
+constexpr char kMagic[8] = {'Q', 'M', 'C', 'C', 'A', 'C', 'H', '1'};
+constexpr std::size_t kHeaderBytes = 16;        // magic, used bytes
+constexpr std::size_t kRecordHeaderBytes = 16;  // key length, value length, checksum
+constexpr std::size_t kEntryOverhead = 96;      // list node, index slot, string headers
+
+std::size_t entry_cost(std::size_t key_size, std::size_t value_size) {
+  return key_size + value_size + kEntryOverhead;
+}
+
+std::uint64_t fnv1a(std::uint64_t hash, const void* data, std::size_t size) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+std::uint64_t record_checksum(std::uint32_t key_size, std::uint32_t value_size, const void* key, const void* value) {
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  hash = fnv1a(hash, &key_size, sizeof(key_size));
+  hash = fnv1a(hash, &value_size, sizeof(value_size));
+  hash = fnv1a(hash, key, key_size);
+  return fnv1a(hash, value, value_size);
+}
+
+std::uint64_t load_u64(const unsigned char* at) {
+  std::uint64_t value = 0;
+  std::memcpy(&value, at, sizeof(value));
+  return value;
+}
+
+std::uint32_t load_u32(const unsigned char* at) {
+  std::uint32_t value = 0;
+  std::memcpy(&value, at, sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+CacheKey::CacheKey(std::string_view tag) { add(tag); }
+
+void CacheKey::append(std::uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    bytes_.push_back(static_cast<char>((value >> (8 * i)) & 0xFFU));
+  }
+}
+
+CacheKey& CacheKey::add(double value) {
+  if (std::isnan(value)) {
+    value = std::numeric_limits<double>::quiet_NaN();
+  } else if (value == 0.0) {
+    value = 0.0;
+  }
+  append(std::bit_cast<std::uint64_t>(value));
+  return *this;
+}
+
+CacheKey& CacheKey::add(std::uint64_t value) {
+  append(value);
+  return *this;
+}
+
+CacheKey& CacheKey::add(bool value) {
+  bytes_.push_back(value ? '\1' : '\0');
+  return *this;
+}
+
+CacheKey& CacheKey::add(std::string_view value) {
+  append(value.size());
+  bytes_.append(value);
+  return *this;
+}
+
+ResultCache::ResultCache(ResultCacheConfig config) : memory_budget_(config.memory_budget) {
+  if (!config.persist_path.empty()) {
+    const std::size_t size = config.persist_bytes == 0U ? 2U * config.memory_budget : config.persist_bytes;
+    open_backing_file(config.persist_path, size);
+  }
+}
+
+ResultCache::~ResultCache() {
+  if (mapping_ != nullptr) {
+    msync(mapping_, mapping_size_, MS_ASYNC);
+    munmap(mapping_, mapping_size_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+std::optional<std::string> ResultCache::find(const CacheKey& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto found = index_.find(key.bytes());
+  if (found == index_.end()) {
+    ++misses_;
+    return std::nullopt;
+  }
+  ++hits_;
+  lru_.splice(lru_.begin(), lru_, found->second);
+  return found->second->value;
+}
+
+void ResultCache::insert(const CacheKey& key, std::string value) {
+  if (entry_cost(key.bytes().size(), value.size()) > memory_budget_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  store(key.bytes(), std::move(value), true);
+}
+
+ResultCacheStats ResultCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return ResultCacheStats{
+    .hits = hits_,
+    .misses = misses_,
+    .insertions = insertions_,
+    .evictions = evictions_,
+    .entries = lru_.size(),
+    .bytes = bytes_,
+    .persisted_bytes = mapping_ == nullptr ? 0U : mapping_used_,
+  };
+}
+
+void ResultCache::store(std::string key, std::string value, bool persist) {
+  if (const auto found = index_.find(key); found != index_.end()) {
+    bytes_ -= found->second->value.size();
+    bytes_ += value.size();
+    found->second->value = std::move(value);
+    lru_.splice(lru_.begin(), lru_, found->second);
+  } else {
+    bytes_ += entry_cost(key.size(), value.size());
+    lru_.push_front(Entry{std::move(key), std::move(value)});
+    index_.emplace(lru_.front().key, lru_.begin());
+  }
+  ++insertions_;
+  evict_to_budget();
+  if (persist && mapping_ != nullptr && !append_record(lru_.front())) {
+    compact();
+  }
+}
+
+void ResultCache::evict_to_budget() {
+  while (bytes_ > memory_budget_ && !lru_.empty()) {
+    const Entry& oldest = lru_.back();
+    bytes_ -= entry_cost(oldest.key.size(), oldest.value.size());
+    index_.erase(oldest.key);
+    lru_.pop_back();
+    ++evictions_;
+  }
+}
+
+void ResultCache::open_backing_file(const std::string& path, std::size_t size) {
+  if (size < kHeaderBytes) {
+    return;
+  }
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    return;
+  }
+  struct stat info {};
+  if (fstat(fd_, &info) != 0 || (static_cast<std::size_t>(info.st_size) != size && ftruncate(fd_, size) != 0)) {
+    close(fd_);
+    fd_ = -1;
+    return;
+  }
+  void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (mapping == MAP_FAILED) {
+    close(fd_);
+    fd_ = -1;
+    return;
+  }
+  mapping_ = static_cast<unsigned char*>(mapping);
+  mapping_size_ = size;
+  load_records();
+}
+
+void ResultCache::load_records() {
+  std::size_t end = 0;
+  if (std::memcmp(mapping_, kMagic, sizeof(kMagic)) == 0) {
+    end = static_cast<std::size_t>(std::min<std::uint64_t>(load_u64(mapping_ + 8), mapping_size_));
+  } else {
+    std::memcpy(mapping_, kMagic, sizeof(kMagic));
+  }
+  std::size_t offset = kHeaderBytes;
+  while (offset + kRecordHeaderBytes <= end) {
+    const std::uint32_t key_size = load_u32(mapping_ + offset);
+    const std::uint32_t value_size = load_u32(mapping_ + offset + 4);
+    const std::size_t next = offset + kRecordHeaderBytes + key_size + value_size;
+    if (next > end) {
+      break;
+    }
+    const unsigned char* key = mapping_ + offset + kRecordHeaderBytes;
+    const unsigned char* value = key + key_size;
+    if (load_u64(mapping_ + offset + 8) != record_checksum(key_size, value_size, key, value)) {
+      break;
+    }
+    if (entry_cost(key_size, value_size) <= memory_budget_) {
+      store(std::string(reinterpret_cast<const char*>(key), key_size),
+            std::string(reinterpret_cast<const char*>(value), value_size),
+            false);
+    }
+    offset = next;
+  }
+  // Reloading is not new work; count only what this process computes.
+  insertions_ = 0;
+  evictions_ = 0;
+  mapping_used_ = offset;
+  const std::uint64_t used = mapping_used_;
+  std::memcpy(mapping_ + 8, &used, sizeof(used));
+}
+
+bool ResultCache::append_record(const Entry& entry) {
+  const std::size_t size = kRecordHeaderBytes + entry.key.size() + entry.value.size();
+  if (size > mapping_size_ - mapping_used_) {
+    return false;
+  }
+  const auto key_size = static_cast<std::uint32_t>(entry.key.size());
+  const auto value_size = static_cast<std::uint32_t>(entry.value.size());
+  const std::uint64_t checksum = record_checksum(key_size, value_size, entry.key.data(), entry.value.data());
+  unsigned char* at = mapping_ + mapping_used_;
+  std::memcpy(at, &key_size, sizeof(key_size));
+  std::memcpy(at + 4, &value_size, sizeof(value_size));
+  std::memcpy(at + 8, &checksum, sizeof(checksum));
+  std::memcpy(at + kRecordHeaderBytes, entry.key.data(), entry.key.size());
+  std::memcpy(at + kRecordHeaderBytes + entry.key.size(), entry.value.data(), entry.value.size());
+  // Publish the record only once it is fully written.
+  mapping_used_ += size;
+  const std::uint64_t used = mapping_used_;
+  std::memcpy(mapping_ + 8, &used, sizeof(used));
+  return true;
+}
+
+void ResultCache::compact() {
+  // Keep the most recent entries that fit, written oldest first so a reload
+  // rebuilds the same recency order.
+  std::size_t room = mapping_size_ - kHeaderBytes;
+  auto last = lru_.begin();
+  for (; last != lru_.end(); ++last) {
+    const std::size_t size = kRecordHeaderBytes + last->key.size() + last->value.size();
+    if (size > room) {
+      break;
+    }
+    room -= size;
+  }
+  mapping_used_ = kHeaderBytes;
+  const std::uint64_t used = mapping_used_;
+  std::memcpy(mapping_ + 8, &used, sizeof(used));
+  for (auto it = std::make_reverse_iterator(last); it != lru_.rend(); ++it) {
+    append_record(*it);
+  }
+}
+
+}  // namespace quant
@@ -0,0 +1,119 @@
+#include "quant/scheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+namespace quant {
+
+namespace {
+
+constexpr double kServiceTimeSmoothing = 0.2;
+
+}  // namespace
+
+WorkloadScheduler::WorkloadScheduler(SchedulerConfig config, TaskPool& pool) : pool_(pool) {
+  lanes_[static_cast<std::size_t>(WorkloadClass::analytic)].config = config.analytic;
+  lanes_[static_cast<std::size_t>(WorkloadClass::heavy)].config = config.heavy;
+  std::size_t total = 0;
+  for (auto& lane : lanes_) {
+    lane.config.concurrency = std::max<std::size_t>(lane.config.concurrency, 1U);
+    lane.service_time_us = static_cast<double>(lane.config.expected_service_time.count());
+    total += lane.config.concurrency;
+  }
+  std::iota(by_priority_.begin(), by_priority_.end(), 0U);
+  std::stable_sort(by_priority_.begin(), by_priority_.end(), [this](std::size_t a, std::size_t b) {
+    return lanes_[a].config.priority > lanes_[b].config.priority;
+  });
+  max_running_ = config.max_running == 0U ? total : config.max_running;
+}
+
+WorkloadScheduler::~WorkloadScheduler() {
+  // Every slot frees itself by dispatching the next task, so nothing is
+  // left queued once nothing runs.
+  std::unique_lock<std::mutex> lock(mutex_);
+  drained_.wait(lock, [this] { return running_ == 0U; });
+}
+
+Admission WorkloadScheduler::submit(WorkloadClass workload, std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Lane& lane = lanes_[static_cast<std::size_t>(workload)];
+    // Tasks ahead of this one, drained `concurrency` at a time. A free slot
+    // means no wait at all.
+    const double ahead = static_cast<double>(lane.queue.size() + lane.running) + 1.0;
+    const double slots = static_cast<double>(lane.config.concurrency);
+    const double waves = std::max(0.0, std::ceil(ahead / slots) - 1.0);
+    const double predicted_us = waves * lane.service_time_us;
+    const double budget_us = static_cast<double>(lane.config.latency_budget.count()) * 1000.0;
+    if (predicted_us > budget_us) {
+      ++lane.rejected;
+      const auto retry_ms = static_cast<std::int64_t>(std::ceil((predicted_us - budget_us) / 1000.0));
+      return Admission{
+        .admitted = false,
+        .retry_after = std::chrono::milliseconds(std::max<std::int64_t>(retry_ms, 1)),
+      };
+    }
+    ++lane.admitted;
+    lane.queue.push_back(std::move(task));
+    dispatch();
+  }
+  return Admission{.admitted = true, .retry_after = std::chrono::milliseconds(0)};
+}
+
+WorkloadStats WorkloadScheduler::stats(WorkloadClass workload) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Lane& lane = lanes_[static_cast<std::size_t>(workload)];
+  return WorkloadStats{
+    .admitted = lane.admitted,
+    .rejected = lane.rejected,
+    .completed = lane.completed,
+    .queued = lane.queue.size(),
+    .running = lane.running,
+    .service_time_us = lane.service_time_us,
+  };
+}
+
+WorkloadScheduler::Lane* WorkloadScheduler::next_lane() {
+  for (const std::size_t index : by_priority_) {
+    Lane& lane = lanes_[index];
+    if (!lane.queue.empty() && lane.running < lane.config.concurrency) {
+      return &lane;
+    }
+  }
+  return nullptr;
+}
+
+void WorkloadScheduler::dispatch() {
+  while (running_ < max_running_) {
+    Lane* lane = next_lane();
+    if (lane == nullptr) {
+      return;
+    }
+    ++lane->running;
+    ++running_;
+    pool_.submit([this, lane, task = std::move(lane->queue.front())] {
+      const auto started = std::chrono::steady_clock::now();
+      task();
+      finish(*lane, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count());
+    });
+    lane->queue.pop_front();
+  }
+}
+
+void WorkloadScheduler::finish(Lane& lane, double elapsed_us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  --lane.running;
+  --running_;
+  ++lane.completed;
+  lane.service_time_us += kServiceTimeSmoothing * (elapsed_us - lane.service_time_us);
+  dispatch();
+  if (running_ == 0U) {
+    // Notified under the lock: the destructor may free this object as soon
+    // as it can reacquire it.
+    drained_.notify_all();
+  }
+}
+
+}  // namespace quant
@@ -1,31 +1,78 @@
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
-#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 
-#include <grpcpp/grpcpp.h>
-
+#include "quant/async_server.hpp"
 #include "quant/grpc_service.hpp"
+#include "quant/task_pool.hpp"
 
-int main(int argc, char** argv) {
-  std::string address = "0.0.0.0:50051";
-  if (argc > 1) {
-    address = argv[1];
+namespace {
+
+// Matches `--name=value` and returns the value.
+std::optional<std::string_view> flag_value(std::string_view arg, std::string_view name) {
+  if (arg.size() > name.size() + 3 && arg.starts_with("--") && arg.substr(2, name.size()) == name &&
+      arg[name.size() + 2] == '=') {
+    return arg.substr(name.size() + 3);
   }
+  return std::nullopt;
+}
 
-  quant::QuantGrpcService service;
+}  // namespace
 
-  grpc::ServerBuilder builder;
-  builder.AddListeningPort(address, grpc::InsecureServerCredentials());
-  builder.RegisterService(&service);
+int main(int argc, char** argv) {
+  std::string address = "0.0.0.0:50051";
+  quant::QuantServiceConfig config;
+  quant::ServerThreading threading;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (const auto value = flag_value(arg, "cache-bytes")) {
+      config.result_cache.memory_budget = std::stoull(std::string(*value));
+    } else if (const auto value = flag_value(arg, "cache-file")) {
+      config.result_cache.persist_path = std::string(*value);
+    } else if (const auto value = flag_value(arg, "batch-window-us")) {
+      config.micro_batch.window = std::chrono::microseconds(std::stoll(std::string(*value)));
+    } else if (const auto value = flag_value(arg, "batch-max")) {
+      config.micro_batch.max_batch = std::stoull(std::string(*value));
+    } else if (const auto value = flag_value(arg, "completion-queues")) {
+      threading.completion_queues = std::stoull(std::string(*value));
+    } else if (const auto value = flag_value(arg, "handler-threads")) {
+      threading.handler_threads = std::stoull(std::string(*value));
+    } else if (const auto value = flag_value(arg, "cores")) {
+      quant::TaskPool::configure_shared(std::stoull(std::string(*value)));
+    } else if (const auto value = flag_value(arg, "analytic-concurrency")) {
+      threading.scheduler.analytic.concurrency = std::stoull(std::string(*value));
+    } else if (const auto value = flag_value(arg, "heavy-concurrency")) {
+      threading.scheduler.heavy.concurrency = std::stoull(std::string(*value));
+    } else if (const auto value = flag_value(arg, "analytic-budget-ms")) {
+      threading.scheduler.analytic.latency_budget = std::chrono::milliseconds(std::stoll(std::string(*value)));
+    } else if (const auto value = flag_value(arg, "heavy-budget-ms")) {
+      threading.scheduler.heavy.latency_budget = std::chrono::milliseconds(std::stoll(std::string(*value)));
+    } else if (const auto value = flag_value(arg, "max-running-jobs")) {
+      config.max_running_jobs = std::stoull(std::string(*value));
+    } else if (arg == "--shared-memory") {
+      config.shared_memory = true;
+    } else if (!arg.starts_with("--")) {
+      address = std::string(arg);
+    } else {
+      std::cerr << "Unknown flag " << arg << '\n';
+      return EXIT_FAILURE;
+    }
+  }
 
-  std::unique_ptr<grpc::Server> server(builder.BuildAndStart());
-  if (!server) {
+  quant::QuantGrpcService service(config);
+  quant::QuantAsyncServer server(service, threading);
+  if (!server.start(address)) {
     std::cerr << "Failed to start gRPC server on " << address << '\n';
     return EXIT_FAILURE;
   }
 
-  std::cout << "quant gRPC server listening on " << address << std::endl;
-  server->Wait();
+  std::cout << "quant gRPC server listening on " << address << " (" << threading.completion_queues
+            << " completion queues x " << threading.handler_threads << " handler threads, "
+            << threading.scheduler.analytic.concurrency << " analytic + " << threading.scheduler.heavy.concurrency
+            << " heavy workers)" << std::endl;
+  server.wait();
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,252 @@
+#include "quant/shared_batch.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+
+#include "quant/black_scholes.hpp"
+
+namespace quant {
+
+namespace {
+
+constexpr std::uint64_t kRegionMagic = 0x6d6873746e617571ULL;  // "quantshm" little-endian
+constexpr std::uint32_t kRegionVersion = 1;
+constexpr std::size_t kRingAlignment = 64;
+
+struct RegionHeader {
+  std::uint64_t magic;
+  std::uint32_t version;
+  std::uint32_t reserved;
+  std::uint64_t capacity;
+};
+static_assert(sizeof(RegionHeader) <= kSharedRegionHeaderBytes);
+
+bool valid_name(const std::string& name) {
+  const std::string_view prefix = kSharedRegionPrefix;
+  return name.size() > prefix.size() && name.starts_with(prefix) &&
+         name.find('/', prefix.size()) == std::string::npos;
+}
+
+void set_error(std::string* error, std::string message) {
+  if (error != nullptr) {
+    *error = std::move(message);
+  }
+}
+
+std::string system_error(const std::string& what, const std::string& name) {
+  return what + " " + name + ": " + std::strerror(errno);
+}
+
+// Null if `count` elements of T at `offset` do not fit the region or are
+// misaligned.
+template <typename T>
+T* column(SharedRegion& region, std::uint64_t offset, std::uint64_t count) {
+  const std::uint64_t capacity = region.capacity();
+  if (offset % alignof(T) != 0U || offset > capacity || count > (capacity - offset) / sizeof(T)) {
+    return nullptr;
+  }
+  return region.at<T>(offset);
+}
+
+}  // namespace
+
+SharedRegion::SharedRegion(std::string name, unsigned char* mapping, std::size_t mapping_size, bool owner)
+  : name_(std::move(name)),
+    mapping_(mapping),
+    mapping_size_(mapping_size),
+    capacity_(mapping_size - kSharedRegionHeaderBytes),
+    owner_(owner) {}
+
+SharedRegion::~SharedRegion() {
+  munmap(mapping_, mapping_size_);
+  if (owner_) {
+    shm_unlink(name_.c_str());
+  }
+}
+
+std::unique_ptr<SharedRegion> SharedRegion::create(
+  const std::string& name, std::size_t capacity, std::string* error) {
+  if (!valid_name(name)) {
+    set_error(error, std::string("shared-memory names must start with ") + kSharedRegionPrefix);
+    return nullptr;
+  }
+  const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    set_error(error, system_error("cannot create", name));
+    return nullptr;
+  }
+  const std::size_t size = kSharedRegionHeaderBytes + capacity;
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    set_error(error, system_error("cannot size", name));
+    close(fd);
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+  void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    set_error(error, system_error("cannot map", name));
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+  const RegionHeader header{.magic = kRegionMagic, .version = kRegionVersion, .reserved = 0, .capacity = capacity};
+  std::memcpy(mapping, &header, sizeof(header));
+  return std::unique_ptr<SharedRegion>(new SharedRegion(name, static_cast<unsigned char*>(mapping), size, true));
+}
+
+std::unique_ptr<SharedRegion> SharedRegion::open(const std::string& name, std::string* error) {
+  if (!valid_name(name)) {
+    set_error(error, std::string("shared-memory names must start with ") + kSharedRegionPrefix);
+    return nullptr;
+  }
+  const int fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+  if (fd < 0) {
+    set_error(error, system_error("cannot open", name));
+    return nullptr;
+  }
+  struct stat info {};
+  if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < kSharedRegionHeaderBytes) {
+    set_error(error, name + " is not a quant shared-memory region");
+    close(fd);
+    return nullptr;
+  }
+  const auto size = static_cast<std::size_t>(info.st_size);
+  void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    set_error(error, system_error("cannot map", name));
+    return nullptr;
+  }
+  RegionHeader header{};
+  std::memcpy(&header, mapping, sizeof(header));
+  if (header.magic != kRegionMagic || header.version != kRegionVersion ||
+      header.capacity != size - kSharedRegionHeaderBytes) {
+    set_error(error, name + " is not a quant shared-memory region");
+    munmap(mapping, size);
+    return nullptr;
+  }
+  return std::unique_ptr<SharedRegion>(new SharedRegion(name, static_cast<unsigned char*>(mapping), size, false));
+}
+
+std::optional<std::uint64_t> SharedRing::allocate(std::size_t bytes) {
+  bytes = (std::max<std::size_t>(bytes, 1U) + kRingAlignment - 1U) / kRingAlignment * kRingAlignment;
+  if (live_.empty()) {
+    head_ = 0;
+  }
+  std::size_t start = head_;
+  if (!live_.empty()) {
+    // head_ ends the newest allocation; it meets the oldest one's start only
+    // once the ring has wrapped and filled up.
+    const std::size_t tail = live_.front().first;
+    if (head_ > tail) {
+      // Free space is [head_, capacity_) and then [0, tail).
+      if (head_ + bytes > capacity_) {
+        start = 0;
+        if (bytes > tail) {
+          return std::nullopt;
+        }
+      }
+    } else if (head_ == tail || head_ + bytes > tail) {
+      return std::nullopt;
+    }
+  }
+  if (start + bytes > capacity_) {
+    return std::nullopt;
+  }
+  live_.emplace_back(start, start + bytes);
+  head_ = start + bytes;
+  in_use_ += bytes;
+  return start;
+}
+
+void SharedRing::release() {
+  if (live_.empty()) {
+    return;
+  }
+  in_use_ -= live_.front().second - live_.front().first;
+  live_.pop_front();
+}
+
+std::string run_shared_batch(SharedRegion& region, const SharedBatch& batch) {
+  const std::uint64_t n = batch.count;
+  if (n == 0U) {
+    return {};
+  }
+  const bool needs_volatility = batch.kind != SharedBatchKind::implied_volatility;
+  const double* spot = column<const double>(region, batch.spot, n);
+  const double* strike = column<const double>(region, batch.strike, n);
+  const double* rate = column<const double>(region, batch.rate, n);
+  const double* volatility = needs_volatility ? column<const double>(region, batch.volatility, n) : nullptr;
+  const double* maturity = column<const double>(region, batch.time_to_maturity, n);
+  const double* dividend =
+    batch.dividend_yield.has_value() ? column<const double>(region, *batch.dividend_yield, n) : nullptr;
+  const unsigned char* is_call = column<const unsigned char>(region, batch.is_call, n);
+  if (spot == nullptr || strike == nullptr || rate == nullptr || maturity == nullptr || is_call == nullptr ||
+      (needs_volatility && volatility == nullptr) || (batch.dividend_yield.has_value() && dividend == nullptr)) {
+    return "an input column is out of bounds or misaligned";
+  }
+
+  auto flags = std::make_unique<bool[]>(n);
+  for (std::uint64_t i = 0; i < n; ++i) {
+    flags[i] = is_call[i] != 0U;
+  }
+  const OptionColumns options{
+    .spot = spot,
+    .strike = strike,
+    .rate = rate,
+    .volatility = volatility,
+    .time_to_maturity = maturity,
+    .dividend_yield = dividend,
+    .is_call = flags.get(),
+    .size = n,
+    .input_floor = 1e-6,
+  };
+
+  switch (batch.kind) {
+    case SharedBatchKind::price: {
+      double* price = column<double>(region, batch.price, n);
+      if (price == nullptr) {
+        return "the prices column is out of bounds or misaligned";
+      }
+      black_scholes_price_batch(options, price);
+      return {};
+    }
+    case SharedBatchKind::greeks: {
+      const GreeksColumns greeks{
+        .price = column<double>(region, batch.price, n),
+        .delta = column<double>(region, batch.delta, n),
+        .gamma = column<double>(region, batch.gamma, n),
+        .vega = column<double>(region, batch.vega, n),
+        .theta = column<double>(region, batch.theta, n),
+        .rho = column<double>(region, batch.rho, n),
+      };
+      if (greeks.price == nullptr || greeks.delta == nullptr || greeks.gamma == nullptr || greeks.vega == nullptr ||
+          greeks.theta == nullptr || greeks.rho == nullptr) {
+        return "a greeks column is out of bounds or misaligned";
+      }
+      black_scholes_greeks_batch(options, greeks);
+      return {};
+    }
+    case SharedBatchKind::implied_volatility: {
+      const double* target = column<const double>(region, batch.target_price, n);
+      double* implied = column<double>(region, batch.implied_volatility, n);
+      bool* converged = column<bool>(region, batch.converged, n);
+      auto* iterations = column<std::uint32_t>(region, batch.iterations, n);
+      if (target == nullptr || implied == nullptr || converged == nullptr || iterations == nullptr) {
+        return "an implied-vol column is out of bounds or misaligned";
+      }
+      implied_volatility_batch(options, target, implied, converged, iterations);
+      return {};
+    }
+  }
+  return "unknown batch kind";
+}
+
+}  // namespace quant
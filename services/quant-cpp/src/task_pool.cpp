@@ -0,0 +1,234 @@
+#include "quant/task_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace quant {
+
+namespace {
+
+struct LocalWorker {
+  const TaskPool* pool = nullptr;
+  std::size_t index = 0;
+};
+
+thread_local LocalWorker local;
+// Rotates the first steal victim so thieves do not all hit worker 0.
+thread_local std::size_t steal_cursor = 0;
+
+std::mutex shared_mutex;
+std::size_t shared_threads = 0;
+bool shared_started = false;
+
+}  // namespace
+
+TaskPool::TaskPool(std::size_t threads) {
+  if (threads == 0U) {
+    threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  workers_.reserve(threads);
+  for (std::size_t i = 0; i < threads; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  // Every deque exists before any thread can try to steal from it.
+  for (std::size_t i = 0; i < threads; ++i) {
+    workers_[i]->thread = std::thread([this, i] {
+      local = LocalWorker{.pool = this, .index = i};
+      steal_cursor = i + 1U;
+      work(workers_[i].get());
+    });
+  }
+}
+
+TaskPool::~TaskPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+TaskPool& TaskPool::shared() {
+  static TaskPool pool([] {
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    shared_started = true;
+    return shared_threads;
+  }());
+  return pool;
+}
+
+bool TaskPool::configure_shared(std::size_t threads) {
+  std::lock_guard<std::mutex> lock(shared_mutex);
+  if (shared_started) {
+    return false;
+  }
+  shared_threads = threads;
+  return true;
+}
+
+TaskPool::Worker* TaskPool::local_worker() const {
+  return local.pool == this ? workers_[local.index].get() : nullptr;
+}
+
+void TaskPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    submitted_.push_back(std::move(task));
+  }
+  wake_.notify_all();
+}
+
+void TaskPool::fork(std::function<void()> task) {
+  Worker* self = local_worker();
+  if (self == nullptr) {
+    submit(std::move(task));
+    return;
+  }
+  // Counted before it is visible so a sleeper that misses the count cannot
+  // also miss the task; sleepers_ is read after, pairing with the sleeper
+  // raising sleepers_ before it reads forked_.
+  forked_.fetch_add(1);
+  {
+    std::lock_guard<std::mutex> lock(self->mutex);
+    self->tasks.push_back(std::move(task));
+  }
+  if (sleepers_.load() > 0U) {
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    wake_.notify_all();
+  }
+}
+
+void TaskPool::join(const std::atomic<std::size_t>& pending) {
+  Worker* self = local_worker();
+  if (self == nullptr) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleepers_.fetch_add(1);
+    wake_.wait(lock, [&] { return pending.load() == 0U; });
+    sleepers_.fetch_sub(1);
+    return;
+  }
+  while (pending.load() != 0U) {
+    if (run_one(self, false)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleepers_.fetch_add(1);
+    wake_.wait(lock, [&] { return pending.load() == 0U || forked_.load() > 0U; });
+    sleepers_.fetch_sub(1);
+  }
+}
+
+void TaskPool::joined() {
+  if (sleepers_.load() > 0U) {
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    wake_.notify_all();
+  }
+}
+
+bool TaskPool::steal(Worker* self, std::function<void()>& task) {
+  const std::size_t count = workers_.size();
+  const std::size_t start = steal_cursor++;
+  for (std::size_t i = 0; i < count; ++i) {
+    Worker* victim = workers_[(start + i) % count].get();
+    if (victim == self) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(victim->mutex);
+    if (!victim->tasks.empty()) {
+      task = std::move(victim->tasks.front());
+      victim->tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TaskPool::run_one(Worker* self, bool include_submitted) {
+  std::function<void()> task;
+  bool found = false;
+  {
+    std::lock_guard<std::mutex> lock(self->mutex);
+    if (!self->tasks.empty()) {
+      task = std::move(self->tasks.back());
+      self->tasks.pop_back();
+      found = true;
+    }
+  }
+  if (!found) {
+    found = steal(self, task);
+  }
+  if (found) {
+    forked_.fetch_sub(1);
+  } else if (include_submitted) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!submitted_.empty()) {
+      task = std::move(submitted_.front());
+      submitted_.pop_front();
+      found = true;
+    }
+  }
+  if (found) {
+    task();
+  }
+  return found;
+}
+
+void TaskPool::work(Worker* self) {
+  for (;;) {
+    if (run_one(self, true)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleepers_.fetch_add(1);
+    wake_.wait(lock, [&] { return stopping_ || forked_.load() > 0U || !submitted_.empty(); });
+    sleepers_.fetch_sub(1);
+    if (stopping_ && forked_.load() == 0U && submitted_.empty()) {
+      return;
+    }
+  }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+  pending_.fetch_add(1);
+  pool_.fork([this, pool = &pool_, task = std::move(task)] {
+    try {
+      task();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(failure_mutex_);
+      if (!failure_) {
+        failure_ = std::current_exception();
+      }
+    }
+    // The group may be gone as soon as the count reaches zero.
+    if (pending_.fetch_sub(1) == 1U) {
+      pool->joined();
+    }
+  });
+}
+
+void TaskGroup::wait() {
+  pool_.join(pending_);
+  std::exception_ptr failure;
+  {
+    std::lock_guard<std::mutex> lock(failure_mutex_);
+    failure = std::exchange(failure_, nullptr);
+  }
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+}
+
+void TaskEvent::set() {
+  // A waiter may destroy the event as soon as it sees the count drop.
+  TaskPool& pool = pool_;
+  if (pending_.exchange(0U) == 1U) {
+    pool.joined();
+  }
+}
+
+void TaskEvent::wait() const { pool_.join(pending_); }
+
+}  // namespace quant
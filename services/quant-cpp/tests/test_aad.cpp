@@ -0,0 +1,188 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "quant/aad.hpp"
+#include "quant/adjoint.hpp"
+#include "quant/black_scholes.hpp"
+#include "quant/heston.hpp"
+#include "quant/multi_asset.hpp"
+#include "quant/path_greeks.hpp"
+#include "quant/path_payoffs.hpp"
+
+namespace {
+
+void assert_near(const char* label, double actual, double expected, double tolerance) {
+  if (std::abs(actual - expected) > tolerance) {
+    std::cerr << label << " expected " << expected << " but got " << actual << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+}  // namespace
+
+int main() {
+  using quant::aad::Real;
+
+  // f(x, y) = x * y + exp(x) / y at (1, 2).
+  {
+    quant::aad::Tape tape;
+    quant::aad::TapeScope scope(tape);
+    const Real x = Real::input(1.0);
+    const Real y = Real::input(2.0);
+    const Real f = x * y + quant::aad::exp(x) / y;
+    tape.adjoint(f.index()) = 1.0;
+    tape.propagate();
+    assert_near("df/dx", tape.adjoint(x.index()), 2.0 + std::exp(1.0) / 2.0, 1e-12);
+    assert_near("df/dy", tape.adjoint(y.index()), 1.0 - std::exp(1.0) / 4.0, 1e-12);
+  }
+
+  quant::OptionInput option{
+    .spot = 100.0,
+    .strike = 95.0,
+    .rate = 0.03,
+    .volatility = 0.25,
+    .time_to_maturity = 0.75,
+    .dividend_yield = 0.01,
+    .is_call = true,
+  };
+  for (bool is_call : {true, false}) {
+    option.is_call = is_call;
+    const auto analytic = quant::black_scholes(option);
+    const auto adjoint = quant::black_scholes_adjoint(option);
+    assert_near("adjoint price", adjoint.price, analytic.price, 1e-10);
+    assert_near("adjoint delta", adjoint.d_spot, analytic.delta, 1e-10);
+    assert_near("adjoint vega", adjoint.d_volatility, analytic.vega, 1e-8);
+    assert_near("adjoint rho", adjoint.d_rate, analytic.rho, 1e-8);
+    assert_near("adjoint theta", -adjoint.d_maturity, analytic.theta, 1e-8);
+  }
+  option.is_call = true;
+
+  const auto mc = quant::monte_carlo_adjoint(option, 100'000U, 42U);
+  const auto pathwise = quant::monte_carlo_greeks(option, 100'000U, 42U);
+  assert_near("MC adjoint price", mc.price, quant::monte_carlo_price(option, 100'000U, 42U).price, 1e-10);
+  assert_near("MC adjoint delta", mc.d_spot, pathwise.delta.value, 1e-10);
+  assert_near("MC adjoint vega", mc.d_volatility, pathwise.vega.value, 1e-8);
+  assert_near("MC adjoint rho", mc.d_rate, quant::black_scholes(option).rho, 0.5);
+
+  // Path payoff written once over Real: geometric Asian.
+  const auto grid = quant::TimeGrid::uniform(option.time_to_maturity, 12);
+  auto geometric_asian = [](const std::vector<Real>& path, const Real& strike) {
+    Real log_sum(0.0);
+    for (const Real& s : path) {
+      log_sum += quant::aad::log(s);
+    }
+    const Real average = quant::aad::exp(log_sum / static_cast<double>(path.size()));
+    return quant::aad::max(average - strike, 0.0);
+  };
+  const auto asian = quant::path_monte_carlo_adjoint(option, grid, geometric_asian, 50'000U, 7U);
+  const quant::AsianPayoff asian_payoff(option.strike, true, quant::AverageType::geometric);
+  const auto asian_pathwise = quant::path_monte_carlo_greeks(option, grid, asian_payoff, 50'000U, 7U);
+  assert_near("asian adjoint price", asian.price, asian_pathwise.price.value, 1e-9);
+  assert_near("asian adjoint delta", asian.d_spot, asian_pathwise.delta.value, 1e-9);
+  assert_near("asian adjoint vega", asian.d_volatility, asian_pathwise.vega.value, 1e-7);
+
+  // Multi-asset: every spot, vol and correlation entry against bumping with
+  // common random numbers.
+  const quant::MultiAssetInput basket{
+    .spots = {100.0, 90.0, 110.0},
+    .volatilities = {0.2, 0.3, 0.25},
+    .dividend_yields = {0.0, 0.01, 0.02},
+    .correlation = {1.0, 0.5, 0.2, 0.5, 1.0, 0.3, 0.2, 0.3, 1.0},
+    .rate = 0.02,
+    .time_to_maturity = 1.0,
+  };
+  const quant::MultiAssetPayoff call{
+    .type = quant::MultiAssetPayoffType::basket, .strike = 100.0, .is_call = true, .weights = {},
+  };
+  const std::uint64_t paths = 20'000U;
+  const auto adjoint = quant::multi_asset_adjoint(basket, call, paths, 3U);
+  assert_near(
+    "basket adjoint price", adjoint.price,
+    quant::multi_asset_monte_carlo_price(basket, call, paths, 3U).price, 1e-9);
+
+  const double h = 1e-4;
+  auto bumped = [&](auto mutate) {
+    quant::MultiAssetInput up = basket;
+    quant::MultiAssetInput down = basket;
+    mutate(up, h);
+    mutate(down, -h);
+    return (quant::multi_asset_monte_carlo_price(up, call, paths, 3U).price
+            - quant::multi_asset_monte_carlo_price(down, call, paths, 3U).price) / (2.0 * h);
+  };
+  for (std::size_t i = 0; i < 3; ++i) {
+    assert_near("basket d_spot", adjoint.d_spots[i],
+                bumped([i](quant::MultiAssetInput& in, double e) { in.spots[i] += e; }), 1e-4);
+    assert_near("basket d_vol", adjoint.d_volatilities[i],
+                bumped([i](quant::MultiAssetInput& in, double e) { in.volatilities[i] += e; }), 1e-3);
+  }
+  assert_near("basket d_corr(0,1)", adjoint.d_correlation[1],
+              bumped([](quant::MultiAssetInput& in, double e) {
+                in.correlation[1] += e;
+                in.correlation[3] += e;
+              }), 1e-3);
+  assert_near("basket d_rate", adjoint.d_rate,
+              bumped([](quant::MultiAssetInput& in, double e) { in.rate += e; }), 1e-2);
+
+  // Heston: the adjoint walks the model's own QE paths, so its price matches
+  // the engine and each model sensitivity matches bumping with common random
+  // numbers. The high vol-of-vol case runs through the exponential branch and
+  // zero variances, where only finiteness is checked (see the header).
+  for (const double vol_of_vol : {0.4, 1.5}) {
+    const quant::HestonParameters heston{
+      .initial_variance = 0.04,
+      .mean_reversion = 1.5,
+      .long_run_variance = 0.05,
+      .vol_of_vol = vol_of_vol,
+      .correlation = -0.7,
+    };
+    const auto heston_grid = quant::TimeGrid::uniform(option.time_to_maturity, 24);
+    const std::uint64_t heston_paths = 20'000U;
+    auto european = [](const std::vector<Real>& path, const Real& strike) {
+      return quant::aad::max(path.back() - strike, 0.0);
+    };
+    const auto greeks =
+      quant::heston_path_monte_carlo_adjoint(option, heston, heston_grid, european, heston_paths, 11U);
+    auto price = [&](const quant::OptionInput& o, const quant::HestonParameters& p) {
+      const quant::EuropeanPathPayoff payoff(o.strike, o.is_call);
+      return quant::path_monte_carlo_price(quant::HestonPathModel(o, p), heston_grid, payoff, heston_paths, 11U).price;
+    };
+    assert_near("heston adjoint price", greeks.price, price(option, heston), 1e-9);
+    if (!std::isfinite(greeks.d_initial_variance) || !std::isfinite(greeks.d_vol_of_vol)) {
+      std::cerr << "heston adjoints should stay finite\n";
+      return EXIT_FAILURE;
+    }
+    if (vol_of_vol > 1.0) {
+      continue;
+    }
+
+    auto bumped_heston = [&](auto mutate) {
+      quant::OptionInput up_option = option;
+      quant::OptionInput down_option = option;
+      quant::HestonParameters up = heston;
+      quant::HestonParameters down = heston;
+      mutate(up_option, up, h);
+      mutate(down_option, down, -h);
+      return (price(up_option, up) - price(down_option, down)) / (2.0 * h);
+    };
+    using Option = quant::OptionInput;
+    using Model = quant::HestonParameters;
+    assert_near("heston d_spot", greeks.d_spot,
+                bumped_heston([](Option& o, Model&, double e) { o.spot += e; }), 1e-3);
+    assert_near("heston d_rate", greeks.d_rate,
+                bumped_heston([](Option& o, Model&, double e) { o.rate += e; }), 1e-2);
+    assert_near("heston d_v0", greeks.d_initial_variance,
+                bumped_heston([](Option&, Model& m, double e) { m.initial_variance += e; }), 1e-2);
+    assert_near("heston d_kappa", greeks.d_mean_reversion,
+                bumped_heston([](Option&, Model& m, double e) { m.mean_reversion += e; }), 1e-3);
+    assert_near("heston d_theta", greeks.d_long_run_variance,
+                bumped_heston([](Option&, Model& m, double e) { m.long_run_variance += e; }), 2e-2);
+    assert_near("heston d_xi", greeks.d_vol_of_vol,
+                bumped_heston([](Option&, Model& m, double e) { m.vol_of_vol += e; }), 1e-3);
+    assert_near("heston d_rho", greeks.d_correlation,
+                bumped_heston([](Option&, Model& m, double e) { m.correlation += e; }), 1e-3);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include <google/protobuf/arena.h>
+
+#include "quant/batch_messages.hpp"
+
+// Counts global heap allocations while `counting` is set.
+namespace {
+
+std::atomic<bool> counting{false};
+std::atomic<long> heap_allocations{0};
+std::atomic<long> arena_blocks{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (counting.load(std::memory_order_relaxed)) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (void* memory = std::malloc(size == 0U ? 1U : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+namespace {
+
+using crucible::quant::GreeksBatchResponse;
+using crucible::quant::ImpliedVolBatchRequest;
+using crucible::quant::ImpliedVolBatchResponse;
+using crucible::quant::PriceBatchRequest;
+using crucible::quant::PriceBatchResponse;
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+void assert_near(const char* label, double actual, double expected, double tolerance) {
+  if (std::abs(actual - expected) > tolerance) {
+    std::cerr << label << " expected " << expected << " but got " << actual << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+void* counted_block(std::size_t size) {
+  arena_blocks.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size);
+}
+
+void free_block(void* block, std::size_t) {
+  std::free(block);
+}
+
+google::protobuf::ArenaOptions tracked_arena_options() {
+  google::protobuf::ArenaOptions options = quant::batch_arena_options();
+  options.block_alloc = counted_block;
+  options.block_dealloc = free_block;
+  return options;
+}
+
+quant::OptionInput option_at(int i) {
+  return quant::OptionInput{
+    .spot = 80.0 + static_cast<double>(i % 41),
+    .strike = 100.0,
+    .rate = 0.01,
+    .volatility = 0.1 + 0.01 * static_cast<double>(i % 30),
+    .time_to_maturity = 0.25 + 0.05 * static_cast<double>(i % 20),
+    .dividend_yield = 0.0,
+    .is_call = i % 2 == 0,
+  };
+}
+
+void fill_options(int size, crucible::quant::OptionColumns* columns) {
+  for (int i = 0; i < size; ++i) {
+    const quant::OptionInput option = option_at(i);
+    columns->add_spots(option.spot);
+    columns->add_strikes(option.strike);
+    columns->add_rates(option.rate);
+    columns->add_volatilities(option.volatility);
+    columns->add_maturities(option.time_to_maturity);
+    columns->add_is_call(option.is_call);
+  }
+}
+
+// Heap allocations made by `body`.
+template <typename Body>
+long heap_allocations_in(Body&& body) {
+  heap_allocations = 0;
+  counting = true;
+  body();
+  counting = false;
+  return heap_allocations.load();
+}
+
+}  // namespace
+
+int main() {
+  constexpr int kOptions = 100'000;
+  google::protobuf::Arena request_arena(tracked_arena_options());
+  auto* request = google::protobuf::Arena::CreateMessage<PriceBatchRequest>(&request_arena);
+  fill_options(kOptions, request->mutable_options());
+
+  // Without an arena each output column is exactly one allocation: no
+  // per-element growth and no intermediate buffers.
+  {
+    PriceBatchResponse prices;
+    const long price_allocations = heap_allocations_in([&] {
+      assert_condition(quant::price_batch(*request, &prices).empty(), "price batch should succeed");
+    });
+    assert_condition(price_allocations == 1, "price batch should allocate its one column once");
+
+    GreeksBatchResponse greeks;
+    const long greeks_allocations = heap_allocations_in([&] {
+      assert_condition(quant::greeks_batch(*request, &greeks).empty(), "greeks batch should succeed");
+    });
+    assert_condition(greeks_allocations == 6, "greeks batch should allocate each of its six columns once");
+
+    for (const int i : {0, 1, 777, kOptions - 1}) {
+      const quant::OptionGreeks expected = quant::black_scholes(option_at(i));
+      assert_near("price", prices.prices(i), expected.price, 1e-12);
+      assert_near("greeks price", greeks.prices(i), expected.price, 1e-12);
+      assert_near("delta", greeks.deltas(i), expected.delta, 1e-12);
+      assert_near("gamma", greeks.gammas(i), expected.gamma, 1e-12);
+      assert_near("vega", greeks.vegas(i), expected.vega, 1e-12);
+      assert_near("theta", greeks.thetas(i), expected.theta, 1e-12);
+      assert_near("rho", greeks.rhos(i), expected.rho, 1e-12);
+    }
+  }
+
+  // On an arena the response takes no heap allocations at all, a handful of
+  // blocks, and about as much memory as its columns need.
+  {
+    arena_blocks = 0;
+    google::protobuf::Arena arena(tracked_arena_options());
+    GreeksBatchResponse* greeks = nullptr;
+    const long allocations = heap_allocations_in([&] {
+      greeks = google::protobuf::Arena::CreateMessage<GreeksBatchResponse>(&arena);
+      assert_condition(quant::greeks_batch(*request, greeks).empty(), "arena greeks batch should succeed");
+    });
+    const double payload = 6.0 * kOptions * sizeof(double);
+    assert_condition(allocations == 0, "arena response should not touch the heap");
+    assert_condition(arena_blocks.load() <= 8, "arena response should take a handful of blocks");
+    assert_condition(
+      static_cast<double>(arena.SpaceAllocated()) < payload + 1024.0 * 1024.0,
+      "arena response should not grow its columns");
+    const double expected_delta = quant::black_scholes(option_at(kOptions - 1)).delta;
+    assert_near("arena delta", greeks->deltas(kOptions - 1), expected_delta, 1e-12);
+  }
+
+  // Implied vols come back through reserved columns too.
+  {
+    constexpr int kTargets = 2'000;
+    google::protobuf::Arena arena(tracked_arena_options());
+    auto* iv_request = google::protobuf::Arena::CreateMessage<ImpliedVolBatchRequest>(&arena);
+    fill_options(kTargets, iv_request->mutable_options());
+    for (int i = 0; i < kTargets; ++i) {
+      iv_request->add_target_prices(quant::black_scholes(option_at(i)).price);
+    }
+    auto* iv_response = google::protobuf::Arena::CreateMessage<ImpliedVolBatchResponse>(&arena);
+    const long allocations = heap_allocations_in([&] {
+      assert_condition(quant::implied_vol_batch(*iv_request, iv_response).empty(), "iv batch should succeed");
+    });
+    assert_condition(allocations == 0, "arena iv response should not touch the heap");
+    assert_condition(iv_response->implied_volatilities_size() == kTargets, "one implied vol per option");
+    assert_near("implied vol", iv_response->implied_volatilities(123), option_at(123).volatility, 1e-4);
+    assert_condition(iv_response->converged(123) && iv_response->iterations(123) > 0U, "iv should converge");
+
+    iv_request->mutable_target_prices()->RemoveLast();
+    assert_condition(
+      quant::implied_vol_batch(*iv_request, iv_response) == "target_prices must have one value per option",
+      "mismatched targets should be rejected");
+  }
+
+  // Ragged columns are rejected before anything is written.
+  {
+    PriceBatchRequest ragged;
+    fill_options(3, ragged.mutable_options());
+    ragged.mutable_options()->add_spots(100.0);
+    PriceBatchResponse response;
+    assert_condition(
+      quant::price_batch(ragged, &response) == "option columns must have the same length", "ragged columns rejected");
+    assert_condition(response.prices_size() == 0, "rejected batch should leave the response empty");
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -1,6 +1,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
+#include <vector>
 
 #include "quant/black_scholes.hpp"
 
@@ -67,5 +68,60 @@ int main() {
     return EXIT_FAILURE;
   }
 
+  // Batch kernels agree with the scalar pricer element by element.
+  const std::vector<double> spots{90.0, 100.0, 110.0, 100.0};
+  const std::vector<double> strikes{100.0, 100.0, 100.0, 120.0};
+  const std::vector<double> rates{0.01, 0.02, 0.03, 0.0};
+  const std::vector<double> vols{0.2, 0.25, 0.3, 0.4};
+  const std::vector<double> maturities{0.5, 1.0, 2.0, 0.25};
+  const std::vector<double> dividends{0.0, 0.01, 0.02, 0.0};
+  const bool is_call[] = {true, false, true, false};
+  const quant::OptionColumns columns{
+    .spot = spots.data(),
+    .strike = strikes.data(),
+    .rate = rates.data(),
+    .volatility = vols.data(),
+    .time_to_maturity = maturities.data(),
+    .dividend_yield = dividends.data(),
+    .is_call = is_call,
+    .size = spots.size(),
+  };
+  std::vector<double> prices(spots.size());
+  std::vector<double> price(spots.size()), delta(spots.size()), gamma(spots.size());
+  std::vector<double> vega(spots.size()), theta(spots.size()), rho(spots.size());
+  quant::black_scholes_price_batch(columns, prices.data());
+  quant::black_scholes_greeks_batch(
+    columns, {price.data(), delta.data(), gamma.data(), vega.data(), theta.data(), rho.data()});
+  for (std::size_t i = 0; i < spots.size(); ++i) {
+    const auto scalar = quant::black_scholes({
+      .spot = spots[i],
+      .strike = strikes[i],
+      .rate = rates[i],
+      .volatility = vols[i],
+      .time_to_maturity = maturities[i],
+      .dividend_yield = dividends[i],
+      .is_call = is_call[i],
+    });
+    assert_near("batch price", prices[i], scalar.price, 1e-12);
+    assert_near("batch greeks price", price[i], scalar.price, 1e-12);
+    assert_near("batch delta", delta[i], scalar.delta, 1e-12);
+    assert_near("batch gamma", gamma[i], scalar.gamma, 1e-12);
+    assert_near("batch vega", vega[i], scalar.vega, 1e-12);
+    assert_near("batch theta", theta[i], scalar.theta, 1e-12);
+    assert_near("batch rho", rho[i], scalar.rho, 1e-12);
+  }
+
+  std::vector<double> implied(spots.size());
+  std::vector<std::uint32_t> iterations(spots.size());
+  bool converged[4] = {};
+  quant::implied_volatility_batch(columns, prices.data(), implied.data(), converged, iterations.data());
+  for (std::size_t i = 0; i < spots.size(); ++i) {
+    assert_near("batch implied volatility", implied[i], vols[i], 1e-4);
+    if (!converged[i] || iterations[i] == 0U) {
+      std::cerr << "batch implied volatility failed to converge\n";
+      return EXIT_FAILURE;
+    }
+  }
+
   return EXIT_SUCCESS;
 }
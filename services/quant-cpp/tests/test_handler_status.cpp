@@ -0,0 +1,116 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include <grpcpp/server_context.h>
+
+#include "quant/handler_status.hpp"
+#include "quant/task.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+using namespace std::chrono_literals;
+
+// A handler class reached through a member pointer, as serve_unary reaches
+// QuantGrpcService.
+struct Handlers {
+  grpc::Status Price(grpc::ServerContext*, const double* spot, double* price) {
+    if (*spot < 0.0) {
+      throw std::domain_error("negative spot");
+    }
+    *price = *spot;
+    return grpc::Status::OK;
+  }
+};
+
+using Handler = grpc::Status (Handlers::*)(grpc::ServerContext*, const double*, double*);
+
+// The shape of serve_unary: wait for a scheduler slot, then run the handler
+// on the pool worker that resumed the coroutine.
+quant::Task<void> serve(
+  quant::WorkloadScheduler& scheduler, Handlers& handlers, Handler handler, double spot, grpc::Status* out) {
+  const quant::Admission admission = co_await quant::scheduled(scheduler, quant::WorkloadClass::heavy);
+  if (!admission.admitted) {
+    *out = grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "rejected");
+    co_return;
+  }
+  double price = 0.0;
+  *out = quant::handler_status([&] { return (handlers.*handler)(nullptr, &spot, &price); });
+}
+
+}  // namespace
+
+int main() {
+  // A handler's own status passes through untouched.
+  assert_condition(quant::handler_status([] { return grpc::Status::OK; }).ok(), "OK should pass through");
+  const grpc::Status rejected = quant::handler_status(
+    [] { return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "bad spot"); });
+  assert_condition(
+    rejected.error_code() == grpc::StatusCode::INVALID_ARGUMENT && rejected.error_message() == "bad spot",
+    "handler errors should pass through");
+
+  // Exceptions become INTERNAL carrying their message.
+  const grpc::Status thrown = quant::handler_status([]() -> grpc::Status { throw std::runtime_error("book corrupt"); });
+  assert_condition(thrown.error_code() == grpc::StatusCode::INTERNAL, "exceptions should map to INTERNAL");
+  assert_condition(thrown.error_message() == "book corrupt", "INTERNAL should carry the exception message");
+
+  const grpc::Status exhausted = quant::handler_status([]() -> grpc::Status { throw std::bad_alloc(); });
+  assert_condition(exhausted.error_code() == grpc::StatusCode::INTERNAL, "bad_alloc should map to INTERNAL");
+
+  const grpc::Status odd = quant::handler_status([]() -> grpc::Status { throw 42; });
+  assert_condition(
+    odd.error_code() == grpc::StatusCode::INTERNAL && odd.error_message() == "unknown error",
+    "non-standard exceptions should map to INTERNAL");
+
+  // Out-parameters written before the throw are left to the caller.
+  bool respond = true;
+  const grpc::Status partial = quant::handler_status([&respond]() -> grpc::Status {
+    respond = false;
+    throw std::length_error("too many books");
+  });
+  assert_condition(!partial.ok() && !respond, "the body should run up to the throw");
+
+  // A handler throwing inside a detached call coroutine on the pool fails
+  // that call and leaves the others running.
+  {
+    quant::TaskPool pool(2);
+    quant::WorkloadScheduler scheduler(
+      {
+        .analytic = {.concurrency = 1, .priority = 1, .latency_budget = 1s, .expected_service_time = 10us},
+        .heavy = {.concurrency = 2, .priority = 0, .latency_budget = 1s, .expected_service_time = 10us},
+      },
+      pool);
+    Handlers handlers;
+    grpc::Status failed;
+    grpc::Status served;
+    std::atomic<int> done{0};
+    const auto call = [&](double spot, grpc::Status* out) -> quant::Task<void> {
+      co_await serve(scheduler, handlers, &Handlers::Price, spot, out);
+      done.fetch_add(1);
+    };
+    quant::spawn(call(-1.0, &failed));
+    quant::spawn(call(100.0, &served));
+    const auto give_up = std::chrono::steady_clock::now() + 10s;
+    while (done.load() < 2 && std::chrono::steady_clock::now() < give_up) {
+      std::this_thread::sleep_for(1ms);
+    }
+    assert_condition(done.load() == 2, "both calls should finish");
+    assert_condition(
+      failed.error_code() == grpc::StatusCode::INTERNAL && failed.error_message() == "negative spot",
+      "the throwing call should answer INTERNAL");
+    assert_condition(served.ok(), "the other call should succeed");
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "quant/black_scholes.hpp"
+#include "quant/heston.hpp"
+#include "quant/path_engine.hpp"
+#include "quant/path_payoffs.hpp"
+
+namespace {
+
+void assert_near(const char* label, double actual, double expected, double tolerance) {
+  if (std::abs(actual - expected) > tolerance) {
+    std::cerr << label << " expected " << expected << " but got " << actual << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+}  // namespace
+
+int main() {
+  quant::OptionInput option{
+    .spot = 100.0,
+    .strike = 100.0,
+    .rate = 0.02,
+    .volatility = 0.2,
+    .time_to_maturity = 1.0,
+    .dividend_yield = 0.01,
+    .is_call = true,
+  };
+
+  // Vanishing vol-of-vol with v0 = theta collapses to Black-Scholes.
+  const quant::HestonParameters flat{
+    .initial_variance = 0.04,
+    .mean_reversion = 1.0,
+    .long_run_variance = 0.04,
+    .vol_of_vol = 1e-4,
+    .correlation = 0.0,
+  };
+  assert_near("flat heston call", quant::heston_price(option, flat), quant::black_scholes(option).price, 1e-4);
+  option.is_call = false;
+  assert_near("flat heston put", quant::heston_price(option, flat), quant::black_scholes(option).price, 1e-4);
+  option.is_call = true;
+
+  // Andersen (2008) style test case with a Feller-violating variance process.
+  const quant::HestonParameters heston{
+    .initial_variance = 0.04,
+    .mean_reversion = 0.5,
+    .long_run_variance = 0.04,
+    .vol_of_vol = 1.0,
+    .correlation = -0.9,
+  };
+  const double analytic = quant::heston_price(option, heston);
+  assert_condition(analytic > 0.0 && analytic < option.spot, "heston analytic price out of range");
+
+  const quant::HestonPathModel model(option, heston);
+  const auto grid = quant::TimeGrid::uniform(option.time_to_maturity, 32);
+  const quant::EuropeanPathPayoff call(option.strike, true);
+  const auto mc = quant::path_monte_carlo_price(model, grid, call, 200'000U, 21U);
+  if (std::abs(mc.price - analytic) > 4.0 * mc.standard_error + 0.02) {
+    std::cerr << "heston QE call expected " << analytic << " but got " << mc.price
+              << " (se " << mc.standard_error << ")\n";
+    return EXIT_FAILURE;
+  }
+
+  // Martingale correction: a zero-strike call is the discounted forward.
+  const quant::EuropeanPathPayoff forward(0.0, true);
+  const auto fwd = quant::path_monte_carlo_price(model, grid, forward, 200'000U, 23U);
+  const double expected_forward = option.spot * std::exp(-option.dividend_yield * option.time_to_maturity);
+  assert_condition(
+    std::abs(fwd.price - expected_forward) < 4.0 * fwd.standard_error,
+    "discounted heston spot should be a martingale");
+
+  // Path payoffs plug in unchanged.
+  const quant::AsianPayoff asian(option.strike, true, quant::AverageType::arithmetic);
+  const auto asian_mc = quant::path_monte_carlo_price(model, grid, asian, 100'000U, 25U);
+  assert_condition(asian_mc.price > 0.0 && asian_mc.price < mc.price, "heston asian should be below european");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,139 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "quant/job_manager.hpp"
+#include "quant/monte_carlo.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+using namespace std::chrono_literals;
+
+quant::JobSnapshot wait_until_finished(const quant::JobManager& jobs, std::uint64_t id) {
+  const auto give_up = std::chrono::steady_clock::now() + 30s;
+  std::uint64_t seen = 0;
+  while (std::chrono::steady_clock::now() < give_up) {
+    const auto snapshot = jobs.wait_for_update(id, seen, 100ms);
+    assert_condition(snapshot.has_value(), "job should exist");
+    if (snapshot->state != quant::JobState::running) {
+      return *snapshot;
+    }
+    seen = snapshot->version;
+  }
+  std::cerr << "job did not finish\n";
+  std::exit(EXIT_FAILURE);
+}
+
+quant::JobManager::Work pricing_work(const quant::OptionInput& option, std::uint64_t paths) {
+  return [option, paths](std::stop_token stop, const quant::JobManager::Report& report) {
+    quant::MonteCarloRunConfig config{.block_paths = 4096U, .checkpoint_blocks = 2U, .stop = stop};
+    config.checkpoint = [&report](const quant::MonteCarloResult& running) {
+      report(running);
+      return true;
+    };
+    return quant::monte_carlo_price_checkpointed(option, paths, 9U, config);
+  };
+}
+
+}  // namespace
+
+int main() {
+  const quant::OptionInput option{
+    .spot = 100.0,
+    .strike = 100.0,
+    .rate = 0.02,
+    .volatility = 0.2,
+    .time_to_maturity = 1.0,
+    .dividend_yield = 0.0,
+    .is_call = true,
+  };
+
+  quant::JobManager jobs(2U);
+
+  // A job streams progress and finishes with the same result as a direct run.
+  const auto id = *jobs.submit({.target_paths = 100'000U}, pricing_work(option, 100'000U));
+  const auto done = wait_until_finished(jobs, id);
+  const auto direct = quant::monte_carlo_price_checkpointed(
+    option, 100'000U, 9U, {.block_paths = 4096U, .checkpoint_blocks = 2U});
+  assert_condition(done.state == quant::JobState::completed, "job should complete");
+  assert_condition(done.progress.price == direct.price, "job result should match a direct run");
+  assert_condition(done.version > 2U, "job should publish intermediate checkpoints");
+
+  // Cancellation stops the workers well before the (effectively endless) target.
+  const std::uint64_t endless = 1'000'000'000'000U;
+  const auto long_job = *jobs.submit({.target_paths = endless}, pricing_work(option, endless));
+  const auto first = jobs.wait_for_update(long_job, 0U, 5s);
+  assert_condition(first && first->state == quant::JobState::running, "long job should report progress");
+  assert_condition(jobs.cancel(long_job), "cancel should reach a running job");
+  const auto cancelled = wait_until_finished(jobs, long_job);
+  assert_condition(cancelled.state == quant::JobState::cancelled, "cancelled job should say so");
+  assert_condition(cancelled.progress.paths < endless, "cancelled job should stop early");
+  assert_condition(!jobs.cancel(long_job), "finished jobs cannot be cancelled");
+
+  // Deadlines stop jobs the same way.
+  const auto deadline_job = *jobs.submit(
+    {.target_paths = endless, .deadline = std::chrono::steady_clock::now() + 100ms}, pricing_work(option, endless));
+  const auto expired = wait_until_finished(jobs, deadline_job);
+  assert_condition(expired.state == quant::JobState::deadline_exceeded, "job should hit its deadline");
+
+  // A job nobody polls is cancelled once abandoned; polling keeps it alive.
+  const auto abandoned = *jobs.submit(
+    {.target_paths = endless, .abandon_after = 50ms}, pricing_work(option, endless));
+  std::this_thread::sleep_for(300ms);
+  const auto orphaned = wait_until_finished(jobs, abandoned);
+  assert_condition(orphaned.state == quant::JobState::cancelled, "an unpolled job should be cancelled");
+  const auto watched = *jobs.submit(
+    {.target_paths = endless, .abandon_after = 200ms}, pricing_work(option, endless));
+  for (int i = 0; i < 10; ++i) {
+    std::this_thread::sleep_for(50ms);
+    assert_condition(jobs.snapshot(watched)->state == quant::JobState::running, "a polled job should keep running");
+  }
+  jobs.cancel(watched);
+  wait_until_finished(jobs, watched);
+
+  const auto failing =
+    *jobs.submit({}, [](std::stop_token, const quant::JobManager::Report&) -> quant::MonteCarloResult {
+      throw std::runtime_error("boom");
+    });
+  const auto failed = wait_until_finished(jobs, failing);
+  assert_condition(
+    failed.state == quant::JobState::failed && failed.error == "boom", "failures should be reported");
+
+  // Only the two most recent finished jobs are retained.
+  const auto last = *jobs.submit({}, pricing_work(option, 4096U));
+  wait_until_finished(jobs, last);
+  assert_condition(!jobs.snapshot(id).has_value(), "oldest finished job should be evicted");
+  assert_condition(jobs.snapshot(failing).has_value(), "recent jobs should be retained");
+  assert_condition(!jobs.snapshot(999U).has_value(), "unknown ids have no snapshot");
+
+  // Jobs beyond max_running are refused, not queued, until one finishes.
+  {
+    quant::JobManager limited(2U, 2U);
+    const auto a = limited.submit({.target_paths = endless}, pricing_work(option, endless));
+    const auto b = limited.submit({.target_paths = endless}, pricing_work(option, endless));
+    assert_condition(a && b, "jobs within the limit should start");
+    assert_condition(!limited.submit({}, pricing_work(option, 4096U)), "a third running job should be refused");
+    limited.cancel(*a);
+    wait_until_finished(limited, *a);
+    const auto c = limited.submit({}, pricing_work(option, 4096U));
+    assert_condition(c.has_value(), "a finished job should free its slot");
+  }
+
+  // Destruction stops running jobs promptly.
+  {
+    quant::JobManager scoped;
+    scoped.submit({.target_paths = endless}, pricing_work(option, endless));
+    std::this_thread::sleep_for(20ms);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "quant/black_scholes.hpp"
+#include "quant/fourier.hpp"
+#include "quant/jump_diffusion.hpp"
+#include "quant/mlmc.hpp"
+#include "quant/path_engine.hpp"
+#include "quant/path_payoffs.hpp"
+
+namespace {
+
+void assert_near(const char* label, double actual, double expected, double tolerance) {
+  if (std::abs(actual - expected) > tolerance) {
+    std::cerr << label << " expected " << expected << " but got " << actual << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+}  // namespace
+
+int main() {
+  quant::OptionInput option{
+    .spot = 100.0,
+    .strike = 100.0,
+    .rate = 0.05,
+    .volatility = 0.2,
+    .time_to_maturity = 1.0,
+    .dividend_yield = 0.01,
+    .is_call = true,
+  };
+
+  // No jumps: both models collapse to Black-Scholes.
+  const double bs_call = quant::black_scholes(option).price;
+  const quant::MertonJumpParameters no_merton{.intensity = 0.0, .mean_jump = -0.1, .jump_volatility = 0.2};
+  const quant::KouJumpParameters no_kou{.intensity = 0.0, .up_probability = 0.4, .up_rate = 10.0, .down_rate = 5.0};
+  assert_near("merton no jumps", quant::merton_price(option, no_merton), bs_call, 1e-10);
+  assert_near("kou no jumps", quant::kou_price(option, no_kou), bs_call, 1e-4);
+
+  // Series against characteristic-function inversion of the same model.
+  const quant::MertonJumpParameters merton{.intensity = 1.0, .mean_jump = -0.1, .jump_volatility = 0.15};
+  const double merton_call = quant::merton_price(option, merton);
+  const double merton_fourier = quant::characteristic_function_price(
+    [&](std::complex<double> u) { return quant::merton_characteristic_function(option, merton, u); }, option);
+  assert_near("merton series vs fourier", merton_call, merton_fourier, 1e-4);
+
+  option.is_call = false;
+  const double merton_put = quant::merton_price(option, merton);
+  option.is_call = true;
+  const double parity = option.spot * std::exp(-option.dividend_yield * option.time_to_maturity)
+    - option.strike * std::exp(-option.rate * option.time_to_maturity);
+  assert_near("merton parity", merton_call - merton_put, parity, 1e-10);
+
+  // Compound-Poisson paths against the analytic prices.
+  const quant::TimeGrid grid = quant::TimeGrid::uniform(option.time_to_maturity, 4);
+  const quant::EuropeanPathPayoff call(option.strike, true);
+  const auto merton_mc =
+    quant::path_monte_carlo_price(quant::JumpDiffusionPathModel(option, merton), grid, call, 200'000U, 7U);
+  assert_near("merton monte carlo", merton_mc.price, merton_call, 4.0 * merton_mc.standard_error);
+
+  const quant::KouJumpParameters kou{.intensity = 1.0, .up_probability = 0.3, .up_rate = 8.0, .down_rate = 4.0};
+  const double kou_call = quant::kou_price(option, kou);
+  const auto kou_mc =
+    quant::path_monte_carlo_price(quant::JumpDiffusionPathModel(option, kou), grid, call, 200'000U, 9U);
+  assert_near("kou monte carlo", kou_mc.price, kou_call, 4.0 * kou_mc.standard_error);
+
+  // Multilevel: fine and coarse paths share their jumps, and GBM steps are
+  // exact, so a European's level corrections vanish. With independent jumps
+  // they would carry the full jump variance.
+  for (const bool use_kou : {false, true}) {
+    const auto model =
+      use_kou ? quant::JumpDiffusionPathModel(option, kou) : quant::JumpDiffusionPathModel(option, merton);
+    const auto mlmc = quant::mlmc_price(model, option.time_to_maturity, call, {.target_rmse = 0.02, .seed = 13U});
+    assert_near("jump mlmc", mlmc.price, use_kou ? kou_call : merton_call, 3.0 * 0.02);
+    for (std::size_t l = 1; l < mlmc.levels.size(); ++l) {
+      assert_near("jump mlmc correction variance", mlmc.levels[l].variance, 0.0, 1e-12);
+    }
+  }
+
+  // Downward jumps fatten the left tail: OTM puts gain over Black-Scholes.
+  option.is_call = false;
+  option.strike = 80.0;
+  if (quant::kou_price(option, kou) <= quant::black_scholes(option).price) {
+    std::cerr << "kou OTM put should exceed black-scholes\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "quant/black_scholes.hpp"
+#include "quant/lsm.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+// Cox-Ross-Rubinstein tree with early exercise at every node.
+double binomial_american(const quant::OptionInput& o, std::size_t steps) {
+  const double dt = o.time_to_maturity / static_cast<double>(steps);
+  const double up = std::exp(o.volatility * std::sqrt(dt));
+  const double down = 1.0 / up;
+  const double growth = std::exp((o.rate - o.dividend_yield) * dt);
+  const double p = (growth - down) / (up - down);
+  const double discount = std::exp(-o.rate * dt);
+  std::vector<double> values(steps + 1);
+  for (std::size_t i = 0; i <= steps; ++i) {
+    const double spot = o.spot * std::pow(up, static_cast<double>(i)) * std::pow(down, static_cast<double>(steps - i));
+    values[i] = o.is_call ? std::max(spot - o.strike, 0.0) : std::max(o.strike - spot, 0.0);
+  }
+  for (std::size_t n = steps; n-- > 0;) {
+    for (std::size_t i = 0; i <= n; ++i) {
+      const double spot = o.spot * std::pow(up, static_cast<double>(i)) * std::pow(down, static_cast<double>(n - i));
+      const double hold = discount * (p * values[i + 1] + (1.0 - p) * values[i]);
+      const double exercise = o.is_call ? spot - o.strike : o.strike - spot;
+      values[i] = std::max(hold, exercise);
+    }
+  }
+  return values[0];
+}
+
+}  // namespace
+
+int main() {
+  // Longstaff & Schwartz (2001), table 1: S=36, K=40, r=6%, sigma=20%, T=1.
+  const quant::OptionInput put{
+    .spot = 36.0,
+    .strike = 40.0,
+    .rate = 0.06,
+    .volatility = 0.2,
+    .time_to_maturity = 1.0,
+    .dividend_yield = 0.0,
+    .is_call = false,
+  };
+  const quant::GbmPathModel model(put);
+  const auto grid = quant::TimeGrid::uniform(put.time_to_maturity, 50);
+  const quant::LsmConfig config{
+    .regression_paths = 50'000U,
+    .pricing_paths = 100'000U,
+    .seed = 3U,
+  };
+
+  const auto american = quant::lsm_price(
+    model, grid, quant::exercise_steps(grid.steps(), 0U), put.strike, put.is_call, config);
+  const double reference = binomial_american(put, 2000);
+  assert_condition(american.paths == config.pricing_paths, "LSM should report out-of-sample paths");
+  assert_condition(american.standard_error > 0.0, "LSM standard error should be positive");
+  // The out-of-sample estimate is a lower bound; 50 dates also trails the
+  // continuously exercisable tree slightly.
+  assert_condition(american.price < reference + 4.0 * american.standard_error, "LSM price above tree value");
+  assert_condition(american.price > reference - 0.05, "LSM price too far below tree value");
+  assert_condition(
+    american.price > quant::black_scholes(put).price + 0.4, "American put should carry early exercise premium");
+
+  const auto repeat = quant::lsm_price(
+    model, grid, quant::exercise_steps(grid.steps(), 0U), put.strike, put.is_call, config);
+  assert_condition(repeat.price == american.price, "LSM must be deterministic for a seed");
+
+  const auto european = quant::lsm_price(
+    model, grid, quant::exercise_steps(grid.steps(), 1U), put.strike, put.is_call, config);
+  assert_condition(
+    std::abs(european.price - quant::black_scholes(put).price) < 4.0 * european.standard_error,
+    "single-date Bermudan should price as European");
+
+  const auto bermudan = quant::lsm_price(
+    model, grid, quant::exercise_steps(grid.steps(), 4U), put.strike, put.is_call, config);
+  assert_condition(bermudan.price > european.price, "Bermudan should exceed European");
+  assert_condition(
+    bermudan.price < american.price + 4.0 * american.standard_error, "Bermudan should not exceed American");
+
+  // A regression set too large to hold is refused before anything is allocated.
+  quant::LsmConfig oversized = config;
+  oversized.regression_paths = quant::kMaxRegressionValues / 50U + 1U;
+  const auto refused = quant::lsm_price(
+    model, grid, quant::exercise_steps(grid.steps(), 0U), put.strike, put.is_call, oversized);
+  assert_condition(refused.paths == 0U, "oversized regression set should be refused");
+  oversized.regression_paths = UINT64_MAX / 2U;
+  assert_condition(
+    quant::lsm_price(model, grid, quant::exercise_steps(grid.steps(), 0U), put.strike, put.is_call, oversized).paths ==
+      0U,
+    "overflowing regression set should be refused");
+
+  const auto steps = quant::exercise_steps(50, 4);
+  assert_condition(steps.size() == 4U && steps.back() == 49U, "exercise dates must end at maturity");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "quant/micro_batcher.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+using namespace std::chrono_literals;
+
+quant::OptionInput option_for(int i) {
+  return quant::OptionInput{
+    .spot = 90.0 + i,
+    .strike = 100.0,
+    .rate = 0.01,
+    .volatility = 0.15 + 0.001 * i,
+    .time_to_maturity = 0.5,
+    .dividend_yield = 0.0,
+    .is_call = i % 2 == 0,
+  };
+}
+
+}  // namespace
+
+int main() {
+  // Concurrent calls are batched, each completed with its own greeks.
+  {
+    constexpr int calls = 64;
+    std::vector<quant::OptionGreeks> results(calls);
+    std::atomic<int> completed{0};
+    quant::MicroBatcher batcher({.window = 20ms, .max_batch = 16U});
+    {
+      std::vector<std::jthread> threads;
+      for (int i = 0; i < calls; ++i) {
+        threads.emplace_back([&, i] {
+          batcher.submit(option_for(i), [&, i](const quant::OptionGreeks& greeks) {
+            results[i] = greeks;
+            completed.fetch_add(1);
+          });
+        });
+      }
+    }
+    const auto give_up = std::chrono::steady_clock::now() + 10s;
+    while (completed.load() < calls && std::chrono::steady_clock::now() < give_up) {
+      std::this_thread::sleep_for(1ms);
+    }
+    assert_condition(completed.load() == calls, "every call should complete");
+    for (int i = 0; i < calls; ++i) {
+      const auto expected = quant::black_scholes(option_for(i));
+      assert_condition(results[i].price == expected.price, "batched price should match the scalar pricer");
+      assert_condition(results[i].vega == expected.vega, "batched greeks should match the scalar pricer");
+    }
+    const auto stats = batcher.stats();
+    assert_condition(stats.calls == calls, "every call should be counted");
+    assert_condition(stats.batches < static_cast<std::uint64_t>(calls), "calls should share batches");
+    assert_condition(stats.max_batch_size <= 16U, "batches should respect max_batch");
+    std::uint64_t histogram_batches = 0;
+    for (const auto count : stats.batch_size_histogram) {
+      histogram_batches += count;
+    }
+    assert_condition(histogram_batches == stats.batches, "histogram should cover every batch");
+    assert_condition(stats.max_queue_delay_ns <= stats.total_queue_delay_ns, "delay totals should be consistent");
+  }
+
+  // A lone call is flushed when its window closes.
+  {
+    quant::MicroBatcher batcher({.window = 1ms, .max_batch = 1024U});
+    std::promise<double> price;
+    batcher.submit(option_for(3), [&price](const quant::OptionGreeks& greeks) { price.set_value(greeks.price); });
+    auto future = price.get_future();
+    assert_condition(future.wait_for(5s) == std::future_status::ready, "window should flush a partial batch");
+    const auto stats = batcher.stats();
+    assert_condition(stats.batches == 1U && stats.batch_size_histogram[0] == 1U, "one batch of size one");
+    assert_condition(stats.max_queue_delay_ns >= 500'000U, "a lone call should wait for the window");
+  }
+
+  // The queue holds max_pending_batches x max_batch calls; beyond that calls
+  // are refused with a retry hint and never completed.
+  {
+    std::atomic<bool> release{false};
+    std::atomic<int> completed{0};
+    const auto slow = [&](const quant::OptionGreeks&) {
+      while (!release.load()) {
+        std::this_thread::sleep_for(1ms);
+      }
+      completed.fetch_add(1);
+    };
+    {
+      quant::MicroBatcher batcher({.window = 10s, .max_batch = 4U, .max_pending_batches = 2U});
+      // The first full batch is flushed at once and parks the batcher thread.
+      for (int i = 0; i < 4; ++i) {
+        assert_condition(batcher.submit(option_for(i), slow).admitted, "the first batch should be queued");
+      }
+      const auto give_up = std::chrono::steady_clock::now() + 10s;
+      while (batcher.stats().batches == 0U && std::chrono::steady_clock::now() < give_up) {
+        std::this_thread::sleep_for(1ms);
+      }
+      for (int i = 0; i < 8; ++i) {
+        assert_condition(batcher.submit(option_for(i), slow).admitted, "calls within the bound should be queued");
+      }
+      const auto refused = batcher.submit(option_for(8), slow);
+      assert_condition(!refused.admitted, "a full queue should refuse calls");
+      assert_condition(refused.retry_after.count() >= 1, "a refused call should carry a retry hint");
+      release.store(true);
+    }
+    assert_condition(completed.load() == 12, "only admitted calls should complete");
+  }
+
+  // Destruction flushes calls still waiting out a long window.
+  {
+    std::atomic<int> completed{0};
+    {
+      quant::MicroBatcher batcher({.window = 10s, .max_batch = 1024U});
+      for (int i = 0; i < 5; ++i) {
+        batcher.submit(option_for(i), [&completed](const quant::OptionGreeks&) { completed.fetch_add(1); });
+      }
+    }
+    assert_condition(completed.load() == 5, "pending calls should be flushed on destruction");
+  }
+
+  return EXIT_SUCCESS;
+}
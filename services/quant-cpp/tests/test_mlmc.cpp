@@ -0,0 +1,112 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "quant/heston.hpp"
+#include "quant/mlmc.hpp"
+#include "quant/path_engine.hpp"
+#include "quant/path_payoffs.hpp"
+
+namespace {
+
+void assert_near(const char* label, double actual, double expected, double tolerance) {
+  if (std::abs(actual - expected) > tolerance) {
+    std::cerr << label << " expected " << expected << " but got " << actual << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+double normal_cdf(double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); }
+
+// Continuously monitored geometric-average call: ln G ~ N(m, s^2).
+double continuous_geometric_call(const quant::OptionInput& option) {
+  const double t = option.time_to_maturity;
+  const double sigma = option.volatility;
+  const double m =
+    std::log(option.spot) + 0.5 * (option.rate - option.dividend_yield - 0.5 * sigma * sigma) * t;
+  const double s = sigma * std::sqrt(t / 3.0);
+  const double d2 = (m - std::log(option.strike)) / s;
+  return std::exp(-option.rate * t) * (std::exp(m + 0.5 * s * s) * normal_cdf(d2 + s) - option.strike * normal_cdf(d2));
+}
+
+}  // namespace
+
+int main() {
+  const quant::OptionInput option{
+    .spot = 100.0,
+    .strike = 100.0,
+    .rate = 0.05,
+    .volatility = 0.2,
+    .time_to_maturity = 1.0,
+    .dividend_yield = 0.0,
+    .is_call = true,
+  };
+
+  const quant::GbmPathModel gbm(option);
+  const quant::AsianPayoff geometric(option.strike, true, quant::AverageType::geometric);
+  const quant::MlmcConfig config{.target_rmse = 0.02, .seed = 11U};
+  const auto result = quant::mlmc_price(gbm, option.time_to_maturity, geometric, config);
+  const double exact = continuous_geometric_call(option);
+
+  assert_condition(result.converged, "mlmc should converge within max_levels");
+  assert_condition(result.levels.size() >= config.min_levels, "mlmc should run at least min_levels");
+  assert_condition(result.standard_error < config.target_rmse, "mlmc standard error should meet the target");
+  assert_near("mlmc geometric asian", result.price, exact, 3.0 * config.target_rmse);
+
+  // Coupling: correction variances fall with the level.
+  const auto& levels = result.levels;
+  assert_condition(levels[2].variance < 0.5 * levels[1].variance, "level variance should decay");
+  assert_condition(levels.back().paths < levels.front().paths, "fine levels should get fewer paths");
+
+  const auto again = quant::mlmc_price(gbm, option.time_to_maturity, geometric, config);
+  assert_condition(again.price == result.price && again.paths == result.paths, "mlmc should be deterministic");
+
+  // A tighter target costs more but lands on the same value.
+  const auto tight = quant::mlmc_price(gbm, option.time_to_maturity, geometric, {.target_rmse = 0.01, .seed = 3U});
+  assert_condition(tight.simulated_steps > result.simulated_steps, "tighter target should cost more");
+  assert_near("mlmc tight geometric asian", tight.price, exact, 3.0 * 0.01);
+
+  // Heston arithmetic Asian: compare with a fine-grid single-level estimate.
+  const quant::HestonParameters heston{
+    .initial_variance = 0.04,
+    .mean_reversion = 1.5,
+    .long_run_variance = 0.04,
+    .vol_of_vol = 0.5,
+    .correlation = -0.7,
+  };
+  const quant::HestonPathModel heston_model(option, heston);
+  const quant::AsianPayoff arithmetic(option.strike, true, quant::AverageType::arithmetic);
+  const auto heston_result =
+    quant::mlmc_price(heston_model, option.time_to_maturity, arithmetic, {.target_rmse = 0.03, .seed = 5U});
+  const auto reference = quant::path_monte_carlo_price(
+    heston_model, quant::TimeGrid::uniform(option.time_to_maturity, 256), arithmetic, 100'000U, 17U);
+  assert_condition(heston_result.converged, "heston mlmc should converge");
+  assert_near(
+    "heston mlmc asian",
+    heston_result.price,
+    reference.price,
+    3.0 * std::hypot(heston_result.standard_error, reference.standard_error) + 0.03);
+
+  const auto rejected = quant::mlmc_price(gbm, option.time_to_maturity, geometric, {.target_rmse = 0.0, .seed = 1U});
+  assert_condition(rejected.paths == 0U && rejected.levels.empty(), "non-positive target should return empty");
+
+  // A target the budget cannot reach stops early instead of running on; the
+  // vanishing target would otherwise ask for more paths than fit in 64 bits.
+  const quant::MlmcConfig capped{.target_rmse = 0.002, .seed = 3U, .max_simulated_steps = 10'000'000U};
+  const auto exhausted = quant::mlmc_price(gbm, option.time_to_maturity, geometric, capped);
+  assert_condition(exhausted.budget_exhausted && !exhausted.converged, "an unreachable target should hit the budget");
+  assert_condition(exhausted.levels.empty(), "an exhausted run should return an empty result");
+  const auto vanishing =
+    quant::mlmc_price(gbm, option.time_to_maturity, geometric, {.target_rmse = 1e-200, .seed = 3U});
+  assert_condition(vanishing.budget_exhausted, "a vanishing target should hit the default budget");
+  assert_condition(!result.budget_exhausted && !tight.budget_exhausted, "reachable targets fit the default budget");
+
+  return EXIT_SUCCESS;
+}
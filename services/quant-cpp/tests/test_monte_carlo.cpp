@@ -35,6 +35,60 @@ int main() {
   assert_condition(diff < tolerance, "Monte Carlo price deviates beyond tolerance");
   assert_condition(mc.standard_error > 0.0, "Monte Carlo standard error should be positive");
   assert_condition(mc.standard_error < tolerance, "Monte Carlo standard error too large");
+  assert_condition(mc.paths == 100'000U, "Monte Carlo should report the simulated path count");
+
+  quant::RunningStats left;
+  quant::RunningStats right;
+  quant::RunningStats whole;
+  for (int i = 0; i < 10; ++i) {
+    const double value = static_cast<double>(i * i);
+    (i < 4 ? left : right).add(value);
+    whole.add(value);
+  }
+  left.merge(right);
+  assert_condition(left.count == whole.count, "merged count mismatch");
+  assert_condition(std::abs(left.mean - whole.mean) < 1e-12, "merged mean mismatch");
+  assert_condition(std::abs(left.variance() - whole.variance()) < 1e-9, "merged variance mismatch");
+
+  const double target = 0.05;
+  const auto adaptive = quant::monte_carlo_price_adaptive(option, target, 5'000'000U, 42U);
+  assert_condition(adaptive.standard_error <= target, "adaptive run should meet the target error");
+  assert_condition(adaptive.paths < 5'000'000U, "adaptive run should stop before max_paths");
+  assert_condition(
+    std::abs(adaptive.price - analytic.price) < 4.0 * adaptive.standard_error,
+    "adaptive price deviates beyond 4 standard errors");
+
+  const auto capped = quant::monte_carlo_price_adaptive(option, 1e-9, 10'000U, 42U);
+  assert_condition(capped.paths == 10'000U, "adaptive run should stop at max_paths");
+
+  // Checkpointed runs report a growing prefix and can be stopped early.
+  std::uint64_t checkpoints = 0;
+  std::uint64_t last_paths = 0;
+  quant::MonteCarloRunConfig run_config{.block_paths = 4096U, .checkpoint_blocks = 4U};
+  run_config.checkpoint = [&](const quant::MonteCarloResult& running) {
+    assert_condition(running.paths > last_paths, "checkpoints should make progress");
+    last_paths = running.paths;
+    ++checkpoints;
+    return true;
+  };
+  const auto checkpointed = quant::monte_carlo_price_checkpointed(option, 200'000U, 5U, run_config);
+  assert_condition(checkpointed.paths == 200'000U && checkpoints == 13U, "checkpointed run should cover all paths");
+  assert_condition(
+    std::abs(checkpointed.price - analytic.price) < 4.0 * checkpointed.standard_error,
+    "checkpointed price deviates beyond 4 standard errors");
+
+  run_config.checkpoint = [](const quant::MonteCarloResult& running) { return running.paths < 50'000U; };
+  const auto stopped = quant::monte_carlo_price_checkpointed(option, 200'000U, 5U, run_config);
+  assert_condition(stopped.paths == 65'536U, "returning false should stop at the checkpoint");
+  const auto prefix = quant::monte_carlo_price_checkpointed(
+    option, 65'536U, 5U, {.block_paths = 4096U, .checkpoint_blocks = 4U});
+  assert_condition(stopped.price == prefix.price, "a stopped run should equal the matching shorter run");
+
+  std::stop_source stop;
+  stop.request_stop();
+  const auto cancelled = quant::monte_carlo_price_checkpointed(
+    option, 200'000U, 5U, {.block_paths = 4096U, .checkpoint_blocks = 4U, .stop = stop.get_token()});
+  assert_condition(cancelled.paths == 0U, "a pre-stopped run should simulate nothing");
 
   return EXIT_SUCCESS;
 }
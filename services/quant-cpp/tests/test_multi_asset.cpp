@@ -0,0 +1,140 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "quant/black_scholes.hpp"
+#include "quant/multi_asset.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+double normal_cdf(double x) {
+  return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+std::vector<double> reconstruct(const quant::CorrelationFactor& factor) {
+  const std::size_t n = factor.dimension;
+  std::vector<double> c(n * n, 0.0);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      for (std::size_t k = 0; k < n; ++k) {
+        c[i * n + j] += factor.matrix[i * n + k] * factor.matrix[j * n + k];
+      }
+    }
+  }
+  return c;
+}
+
+}  // namespace
+
+int main() {
+  const std::vector<double> valid{1.0, 0.5, 0.2, 0.5, 1.0, 0.3, 0.2, 0.3, 1.0};
+  const auto chol = quant::factor_correlation(valid, 3);
+  assert_condition(chol.cholesky, "positive-definite correlation should use Cholesky");
+  const auto rebuilt = reconstruct(chol);
+  for (std::size_t i = 0; i < valid.size(); ++i) {
+    assert_condition(std::abs(rebuilt[i] - valid[i]) < 1e-12, "Cholesky factor should reproduce the matrix");
+  }
+
+  // Pairwise-consistent but jointly impossible correlations.
+  const std::vector<double> invalid{1.0, 0.9, -0.9, 0.9, 1.0, 0.9, -0.9, 0.9, 1.0};
+  const auto eigen = quant::factor_correlation(invalid, 3);
+  assert_condition(!eigen.cholesky, "non-PD correlation should fall back to eigen factor");
+  const auto repaired = reconstruct(eigen);
+  for (std::size_t i = 0; i < 3; ++i) {
+    assert_condition(std::abs(repaired[i * 3 + i] - 1.0) < 1e-12, "repaired matrix should have unit diagonal");
+  }
+  assert_condition(repaired[1] > 0.0 && repaired[2] < 0.0, "repair should keep correlation signs");
+
+  // Pricing only accepts genuine correlation matrices; singular ones such as
+  // perfect correlation are valid.
+  assert_condition(quant::validate_correlation(valid, 3).empty(), "valid correlation should pass");
+  assert_condition(
+    quant::validate_correlation({1.0, 1.0, 1.0, 1.0}, 2).empty(), "perfect correlation should pass");
+  assert_condition(
+    quant::validate_correlation(invalid, 3) == "correlation must be positive semi-definite",
+    "jointly impossible correlation should be rejected");
+  assert_condition(
+    quant::validate_correlation({1.0, 0.5, 0.4, 1.0}, 2) == "correlation must be symmetric",
+    "asymmetric correlation should be rejected");
+  assert_condition(
+    quant::validate_correlation({2.0, 0.0, 0.0, 1.0}, 2) == "correlation entries must be in [-1, 1]",
+    "out-of-range correlation should be rejected");
+  assert_condition(
+    quant::validate_correlation({0.5, 0.0, 0.0, 1.0}, 2) == "correlation must have a unit diagonal",
+    "non-unit diagonal should be rejected");
+  assert_condition(
+    quant::validate_correlation({1.0, NAN, NAN, 1.0}, 2) == "correlation entries must be in [-1, 1]",
+    "NaN correlation should be rejected");
+
+  // Exchange option: Margrabe closed form for max(S_0 - S_1, 0).
+  const double rho = 0.4;
+  const quant::MultiAssetInput pair{
+    .spots = {100.0, 95.0},
+    .volatilities = {0.3, 0.2},
+    .dividend_yields = {0.01, 0.02},
+    .correlation = {1.0, rho, rho, 1.0},
+    .rate = 0.03,
+    .time_to_maturity = 1.0,
+  };
+  const double sigma = std::sqrt(0.3 * 0.3 + 0.2 * 0.2 - 2.0 * rho * 0.3 * 0.2);
+  const double d1 = (std::log(100.0 / 95.0) + (0.02 - 0.01 + 0.5 * sigma * sigma)) / sigma;
+  const double margrabe = 100.0 * std::exp(-0.01) * normal_cdf(d1) - 95.0 * std::exp(-0.02) * normal_cdf(d1 - sigma);
+  const quant::MultiAssetPayoff exchange{
+    .type = quant::MultiAssetPayoffType::spread,
+    .strike = 0.0,
+    .is_call = true,
+    .weights = {},
+  };
+  const auto spread = quant::multi_asset_monte_carlo_price(pair, exchange, 200'000U, 5U);
+  assert_condition(spread.paths == 200'000U, "multi-asset run should report path count");
+  assert_condition(
+    std::abs(spread.price - margrabe) < 4.0 * spread.standard_error, "spread price deviates from Margrabe");
+
+  // A one-asset basket is a vanilla.
+  const quant::OptionInput vanilla{
+    .spot = 100.0, .strike = 105.0, .rate = 0.03, .volatility = 0.25,
+    .time_to_maturity = 0.5, .dividend_yield = 0.0, .is_call = false,
+  };
+  const quant::MultiAssetInput single{
+    .spots = {100.0}, .volatilities = {0.25}, .dividend_yields = {},
+    .correlation = {1.0}, .rate = 0.03, .time_to_maturity = 0.5,
+  };
+  const quant::MultiAssetPayoff put{
+    .type = quant::MultiAssetPayoffType::basket, .strike = 105.0, .is_call = false, .weights = {},
+  };
+  const auto basket = quant::multi_asset_monte_carlo_price(single, put, 200'000U, 9U);
+  assert_condition(
+    std::abs(basket.price - quant::black_scholes(vanilla).price) < 4.0 * basket.standard_error,
+    "single-asset basket should match Black-Scholes");
+
+  quant::MultiAssetPayoff rainbow{
+    .type = quant::MultiAssetPayoffType::best_of, .strike = 100.0, .is_call = true, .weights = {},
+  };
+  const auto best = quant::multi_asset_monte_carlo_price(pair, rainbow, 100'000U, 3U);
+  rainbow.type = quant::MultiAssetPayoffType::worst_of;
+  const auto worst = quant::multi_asset_monte_carlo_price(pair, rainbow, 100'000U, 3U);
+  assert_condition(best.price > worst.price, "best-of call should exceed worst-of call");
+
+  const quant::MultiAssetInput mismatched{
+    .spots = {100.0, 100.0}, .volatilities = {0.2}, .dividend_yields = {},
+    .correlation = {1.0}, .rate = 0.0, .time_to_maturity = 1.0,
+  };
+  assert_condition(
+    quant::multi_asset_monte_carlo_price(mismatched, put, 1000U, 1U).paths == 0U,
+    "inconsistent inputs should produce an empty result");
+  quant::MultiAssetInput impossible = pair;
+  impossible.correlation = {1.0, 0.3, -0.3, 1.0};
+  assert_condition(
+    quant::multi_asset_monte_carlo_price(impossible, rainbow, 1000U, 1U).paths == 0U,
+    "an invalid correlation should produce an empty result");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+// Loads the addon built by the quant_node target (path passed by ctest) and
+// checks it against Black-Scholes values and the shared-pool Monte Carlo.
+
+import test from "node:test";
+import assert from "node:assert/strict";
+import { createRequire } from "node:module";
+
+const quant = createRequire(import.meta.url)(process.argv[2]);
+
+const size = 1000;
+
+function columns() {
+  const options = {
+    spot: new Float64Array(size),
+    strike: new Float64Array(size),
+    rate: new Float64Array(size),
+    volatility: new Float64Array(size),
+    timeToMaturity: new Float64Array(size),
+    isCall: new Uint8Array(size),
+  };
+  for (let i = 0; i < size; ++i) {
+    options.spot[i] = 80 + (i % 41);
+    options.strike[i] = 100;
+    options.rate[i] = 0.01;
+    options.volatility[i] = 0.1 + 0.01 * (i % 30);
+    options.timeToMaturity[i] = 0.25 + 0.05 * (i % 20);
+    options.isCall[i] = i % 2 === 0 ? 1 + (i % 5) : 0;
+  }
+  return options;
+}
+
+function near(actual, expected, tolerance, label) {
+  assert.ok(Math.abs(actual - expected) <= tolerance, `${label}: expected ${expected} but got ${actual}`);
+}
+
+test("priceBatch matches the reference price and writes into a supplied array", () => {
+  const options = columns();
+  const prices = quant.priceBatch(options);
+  assert.ok(prices instanceof Float64Array && prices.length === size);
+  // At the money, one year, 20% vol, 1% rate.
+  const atm = quant.priceBatch({
+    spot: new Float64Array([100]),
+    strike: new Float64Array([100]),
+    rate: new Float64Array([0.01]),
+    volatility: new Float64Array([0.2]),
+    timeToMaturity: new Float64Array([1]),
+    isCall: new Uint8Array([1]),
+  });
+  near(atm[0], 8.4333186, 1e-6, "atm call");
+
+  const out = new Float64Array(size);
+  assert.equal(quant.priceBatch(options, out), out);
+  assert.deepEqual(out, prices);
+});
+
+test("greeksBatch and impliedVolBatch share columns with the caller", () => {
+  const options = columns();
+  const greeks = quant.greeksBatch(options, { delta: new Float64Array(size) });
+  assert.deepEqual(greeks.price, quant.priceBatch(options));
+  assert.ok(greeks.delta[0] > 0 && greeks.delta[1] < 0, "calls and puts should have opposite deltas");
+
+  const iv = quant.impliedVolBatch(options, greeks.price);
+  for (const i of [0, 1, 123, size - 1]) {
+    near(iv.impliedVolatility[i], options.volatility[i], 1e-4, `implied vol ${i}`);
+    assert.equal(iv.converged[i], 1);
+  }
+  assert.ok(iv.iterations instanceof Uint32Array);
+});
+
+test("batch inputs are validated", () => {
+  const options = columns();
+  assert.throws(() => quant.priceBatch({ ...options, spot: [100] }), /spot must be a Float64Array/);
+  assert.throws(
+    () => quant.priceBatch({ ...options, strike: new Float64Array(size - 1) }),
+    /strike must have one value per option/,
+  );
+  assert.throws(() => quant.priceBatch(options, new Float64Array(1)), /prices must have one value per option/);
+  assert.throws(() => quant.impliedVolBatch(options, new Float64Array(2)), /targetPrices/);
+});
+
+test("monteCarlo runs on the addon pool and resolves a promise", async () => {
+  const option = { spot: 100, strike: 100, rate: 0.01, volatility: 0.2, timeToMaturity: 1, isCall: true };
+  const [plain, repeat, greeks] = await Promise.all([
+    quant.monteCarlo(option, { paths: 200_000, seed: 7 }),
+    quant.monteCarlo(option, { paths: 200_000, seed: 7 }),
+    quant.monteCarlo(option, { paths: 50_000, seed: 7, greeks: true }),
+  ]);
+  near(plain.price, 8.4333186, 4 * plain.standardError, "monte carlo price");
+  assert.equal(plain.paths, 200_000);
+  assert.equal(repeat.price, plain.price);
+  assert.ok(greeks.delta > 0.5 && greeks.delta < 0.7, "call delta");
+
+  assert.throws(() => quant.monteCarlo(option, { paths: -1 }), /paths/);
+  assert.equal(quant.configureThreads(2), false, "the shared pool has already started");
+});
@@ -0,0 +1,85 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "quant/option_book.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+void assert_near(const char* label, double actual, double expected, double tolerance) {
+  if (std::abs(actual - expected) > tolerance) {
+    std::cerr << label << " expected " << expected << " but got " << actual << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+}  // namespace
+
+int main() {
+  // Two options on underlying 0, one on underlying 3.
+  const std::vector<double> spots{100.0, 100.0, 50.0};
+  const std::vector<double> strikes{95.0, 105.0, 50.0};
+  const std::vector<double> rates{0.01, 0.01, 0.02};
+  const std::vector<double> vols{0.2, 0.22, 0.3};
+  const std::vector<double> maturities{0.5, 0.5, 1.0};
+  const bool is_call[] = {true, false, true};
+  const quant::OptionColumns columns{
+    .spot = spots.data(),
+    .strike = strikes.data(),
+    .rate = rates.data(),
+    .volatility = vols.data(),
+    .time_to_maturity = maturities.data(),
+    .dividend_yield = nullptr,
+    .is_call = is_call,
+    .size = spots.size(),
+  };
+  quant::OptionBook book(columns, {0U, 0U, 3U}, 1e-4);
+
+  const auto& initial = book.reprice();
+  assert_condition(initial.size() == 3U, "first reprice should report the whole book");
+  const auto expected = quant::black_scholes({100.0, 105.0, 0.01, 0.22, 0.5, 0.0, false});
+  assert_near("initial price", initial.price[1], expected.price, 1e-12);
+  assert_near("initial delta", initial.delta[1], expected.delta, 1e-12);
+
+  assert_condition(book.reprice().size() == 0U, "nothing changed, nothing reported");
+
+  // A spot tick reprices only the options on that underlying.
+  assert_condition(book.set_spot(3U, 51.0), "known underlying should update");
+  const auto& tick = book.reprice();
+  assert_condition(tick.size() == 1U && tick.options[0] == 2U, "only the ticked underlying should report");
+  const auto ticked = quant::black_scholes({51.0, 50.0, 0.02, 0.3, 1.0, 0.0, true});
+  assert_near("ticked price", tick.price[0], ticked.price, 1e-12);
+
+  // Moves inside the tolerance are held back until they add up.
+  assert_condition(book.set_spot(0U, 100.00001), "spot update should apply");
+  assert_condition(book.reprice().size() == 0U, "tiny moves should be suppressed");
+  assert_condition(book.set_spot(0U, 100.5), "spot update should apply");
+  const auto& moved = book.reprice();
+  assert_condition(moved.size() == 2U && moved.options[0] == 0U && moved.options[1] == 1U, "book order");
+
+  // Volatility updates target single options.
+  assert_condition(book.set_volatility(1U, 0.3), "known option should update");
+  const auto& vol = book.reprice();
+  assert_condition(vol.size() == 1U && vol.options[0] == 1U, "only the re-marked option should report");
+
+  assert_condition(!book.set_spot(1U, 10.0) && !book.set_spot(9U, 10.0), "unknown underlyings are rejected");
+  assert_condition(!book.set_volatility(3U, 0.1), "unknown options are rejected");
+
+  // Underlying ids are keys: the largest id costs no more than a small one.
+  quant::OptionBook sparse(columns, {7U, 4'000'000'000U, 0xffffffffU}, 0.0);
+  assert_condition(sparse.reprice().size() == 3U, "sparse ids should register every option");
+  assert_condition(sparse.set_spot(0xffffffffU, 60.0), "the largest id should be addressable");
+  const auto& top = sparse.reprice();
+  assert_condition(top.size() == 1U && top.options[0] == 2U, "only the option on the largest id should report");
+  assert_condition(!sparse.set_spot(0U, 60.0) && !sparse.set_spot(4'000'000'001U, 60.0), "absent ids are rejected");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "quant/black_scholes.hpp"
+#include "quant/path_engine.hpp"
+#include "quant/path_payoffs.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+double normal_cdf(double x) {
+  return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+void assert_within_se(const char* label, const quant::MonteCarloResult& mc, double expected) {
+  const double diff = std::abs(mc.price - expected);
+  if (diff > 4.0 * mc.standard_error) {
+    std::cerr << label << " expected " << expected << " but got " << mc.price
+              << " (se " << mc.standard_error << ")\n";
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+// Discretely monitored geometric-average call with n equally spaced fixings.
+double geometric_asian_call(const quant::OptionInput& o, std::size_t n) {
+  const double N = static_cast<double>(n);
+  const double T = o.time_to_maturity;
+  const double sigma = o.volatility;
+  const double mean_time = T * (N + 1.0) / (2.0 * N);
+  const double mu = std::log(o.spot) + (o.rate - o.dividend_yield - 0.5 * sigma * sigma) * mean_time;
+  const double v = sigma * sigma * T * (N + 1.0) * (2.0 * N + 1.0) / (6.0 * N * N);
+  const double d1 = (mu - std::log(o.strike) + v) / std::sqrt(v);
+  const double d2 = d1 - std::sqrt(v);
+  return std::exp(-o.rate * T) * (std::exp(mu + 0.5 * v) * normal_cdf(d1) - o.strike * normal_cdf(d2));
+}
+
+// Continuously monitored down-and-out call for barrier <= strike.
+double down_and_out_call(const quant::OptionInput& o, double barrier) {
+  const double T = o.time_to_maturity;
+  const double sigma = o.volatility;
+  const double sigma_sqrt_t = sigma * std::sqrt(T);
+  const double lambda = (o.rate - o.dividend_yield + 0.5 * sigma * sigma) / (sigma * sigma);
+  const double y = std::log(barrier * barrier / (o.spot * o.strike)) / sigma_sqrt_t + lambda * sigma_sqrt_t;
+  const double ratio = barrier / o.spot;
+  const double down_and_in = o.spot * std::exp(-o.dividend_yield * T) * std::pow(ratio, 2.0 * lambda) * normal_cdf(y)
+    - o.strike * std::exp(-o.rate * T) * std::pow(ratio, 2.0 * lambda - 2.0) * normal_cdf(y - sigma_sqrt_t);
+  return quant::black_scholes(o).price - down_and_in;
+}
+
+}  // namespace
+
+int main() {
+  const quant::OptionInput option{
+    .spot = 100.0,
+    .strike = 100.0,
+    .rate = 0.03,
+    .volatility = 0.25,
+    .time_to_maturity = 1.0,
+    .dividend_yield = 0.01,
+    .is_call = true,
+  };
+  const quant::GbmPathModel model(option);
+  const std::uint64_t paths = 200'000U;
+
+  const auto grid = quant::TimeGrid::uniform(option.time_to_maturity, 12);
+  const quant::EuropeanPathPayoff european(option.strike, option.is_call);
+  const auto vanilla = quant::path_monte_carlo_price(model, grid, european, paths, 7U);
+  assert_within_se("european", vanilla, quant::black_scholes(option).price);
+  assert_condition(vanilla.paths == paths, "path engine should report the simulated path count");
+
+  const auto repeat = quant::path_monte_carlo_price(model, grid, european, paths, 7U);
+  assert_condition(repeat.price == vanilla.price, "path engine must be deterministic for a seed");
+
+  const quant::AsianPayoff geometric(option.strike, true, quant::AverageType::geometric);
+  const auto geo = quant::path_monte_carlo_price(model, grid, geometric, paths, 11U);
+  assert_within_se("geometric asian", geo, geometric_asian_call(option, grid.steps()));
+
+  const quant::AsianPayoff arithmetic(option.strike, true, quant::AverageType::arithmetic);
+  const auto arith = quant::path_monte_carlo_price(model, grid, arithmetic, paths, 11U);
+  assert_condition(arith.price > geo.price, "arithmetic asian should exceed geometric asian");
+  assert_condition(arith.price < vanilla.price, "asian call should be cheaper than european");
+
+  // A coarse grid with the bridge correction should match continuous monitoring.
+  const double barrier = 85.0;
+  const quant::BarrierPayoff down_out(option.strike, true, barrier, quant::BarrierType::down_and_out);
+  const quant::BarrierPayoff down_in(option.strike, true, barrier, quant::BarrierType::down_and_in);
+  const auto out = quant::path_monte_carlo_price(model, grid, down_out, paths, 13U);
+  const auto in = quant::path_monte_carlo_price(model, grid, down_in, paths, 13U);
+  assert_within_se("down-and-out call", out, down_and_out_call(option, barrier));
+  const auto same_paths = quant::path_monte_carlo_price(model, grid, european, paths, 13U);
+  assert_condition(
+    std::abs(out.price + in.price - same_paths.price) < 1e-9,
+    "knock-in plus knock-out should equal the vanilla on the same paths");
+
+  const quant::LookbackPayoff floating(0.0, true, true);
+  const auto lookback = quant::path_monte_carlo_price(model, grid, floating, paths, 17U);
+  assert_condition(lookback.price > vanilla.price, "floating lookback call should exceed ATM call");
+
+  // Strike ladder plus a barrier on one shared path set.
+  const quant::EuropeanPathPayoff call_90(90.0, true);
+  const quant::EuropeanPathPayoff call_110(110.0, true);
+  const std::vector<const quant::PathPayoff*> ladder{&call_90, &european, &call_110, &down_out};
+  const auto many = quant::path_monte_carlo_price_many(model, grid, ladder, paths, 13U, true);
+  assert_condition(many.prices.size() == ladder.size() && many.paths == paths, "ladder should price every payoff");
+  for (std::size_t p = 0; p < ladder.size(); ++p) {
+    const auto single = quant::path_monte_carlo_price(model, grid, *ladder[p], paths, 13U);
+    assert_condition(
+      many.prices[p].price == single.price && many.prices[p].standard_error == single.standard_error,
+      "ladder prices should match single-payoff runs on the same seed");
+    const double variance = single.standard_error * single.standard_error;
+    assert_condition(
+      std::abs(many.covariance[p * ladder.size() + p] - variance) < 1e-9 * variance,
+      "ladder covariance diagonal should equal the squared standard error");
+  }
+  const std::size_t n = ladder.size();
+  assert_condition(many.covariance[1] == many.covariance[n], "ladder covariance should be symmetric");
+  // Adjacent strikes share paths, so the call-spread error is far below the
+  // independent-runs error.
+  const double spread_variance = many.covariance[0] + many.covariance[n + 1] - 2.0 * many.covariance[1];
+  assert_condition(
+    spread_variance < 0.25 * (many.covariance[0] + many.covariance[n + 1]),
+    "shared paths should shrink call-spread error");
+  const auto plain = quant::path_monte_carlo_price_many(model, grid, ladder, paths, 13U);
+  assert_condition(plain.covariance.empty(), "covariance should be empty unless requested");
+
+  // Small blocks spread the run over several chunks of blocks; merging in
+  // block order keeps the ladder equal to single-payoff runs.
+  const auto chunked = quant::path_monte_carlo_price_many(model, grid, ladder, paths, 13U, true, 32U);
+  assert_condition(chunked.paths == paths, "chunked ladder should run every path");
+  for (std::size_t p = 0; p < ladder.size(); ++p) {
+    const auto single = quant::path_monte_carlo_price(model, grid, *ladder[p], paths, 13U, 32U);
+    assert_condition(chunked.prices[p].price == single.price, "chunked ladder should match single-payoff runs");
+  }
+
+  return EXIT_SUCCESS;
+}
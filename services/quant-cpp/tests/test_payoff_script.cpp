@@ -0,0 +1,169 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "quant/black_scholes.hpp"
+#include "quant/path_engine.hpp"
+#include "quant/path_payoffs.hpp"
+#include "quant/payoff_script.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+void assert_near(const char* label, double actual, double expected, double tolerance) {
+  if (std::abs(actual - expected) > tolerance) {
+    std::cerr << label << " expected " << expected << " but got " << actual << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+quant::ScriptPayoff compile(const char* source, const quant::OptionInput& option) {
+  const auto compiled = quant::compile_payoff_script(source);
+  if (!compiled.program) {
+    std::cerr << "compile failed: " << compiled.error << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  return quant::ScriptPayoff(compiled.program, option.rate, option.time_to_maturity);
+}
+
+}  // namespace
+
+int main() {
+  const quant::OptionInput option{
+    .spot = 100.0,
+    .strike = 100.0,
+    .rate = 0.03,
+    .volatility = 0.25,
+    .time_to_maturity = 1.0,
+    .dividend_yield = 0.0,
+    .is_call = true,
+  };
+  const quant::GbmPathModel model(option);
+  const auto grid = quant::TimeGrid::uniform(option.time_to_maturity, 12);
+  const std::uint64_t paths = 50'000U;
+
+  // Scripted vanillas and Asians reproduce the built-in payoffs on the same paths.
+  const auto call = compile("if is_last { pay max(S - 100, 0); }", option);
+  const auto scripted = quant::path_monte_carlo_price(model, grid, call, paths, 3U);
+  const auto builtin =
+    quant::path_monte_carlo_price(model, grid, quant::EuropeanPathPayoff(100.0, true), paths, 3U);
+  assert_near("scripted call", scripted.price, builtin.price, 1e-9);
+
+  const auto asian = compile(
+    "var sum = 0;\n"
+    "sum = sum + S;\n"
+    "if is_last { pay max(sum / step - 100, 0); }\n",
+    option);
+  const auto scripted_asian = quant::path_monte_carlo_price(model, grid, asian, paths, 5U);
+  const auto builtin_asian = quant::path_monte_carlo_price(
+    model, grid, quant::AsianPayoff(100.0, true, quant::AverageType::arithmetic), paths, 5U);
+  assert_near("scripted asian", scripted_asian.price, builtin_asian.price, 1e-9);
+
+  // A mid-life cash flow is rolled to maturity: paying S at t = 1/2 is worth S0.
+  const auto early = compile("if step == 6 { pay S; }", option);
+  const auto early_price = quant::path_monte_carlo_price(model, grid, early, paths, 7U);
+  assert_near("intermediate cash flow", early_price.price, option.spot, 4.0 * early_price.standard_error);
+
+  // Autocallable: quarterly calls at par plus coupon, 70% capital barrier at maturity.
+  const char* autocall_source =
+    "var coupon = 0.02;\n"
+    "if step % 3 == 0 && S >= S0 {\n"
+    "  pay 100 * (1 + coupon * step / 3);\n"
+    "  stop;\n"
+    "}\n"
+    "if is_last {\n"
+    "  if S < 0.7 * S0 { pay 100 * S / S0; } else { pay 100; }\n"
+    "}\n";
+  const auto autocall = compile(autocall_source, option);
+  const auto autocall_price = quant::path_monte_carlo_price(model, grid, autocall, paths, 9U);
+  const double par = 100.0 * std::exp(-option.rate * option.time_to_maturity);
+  assert_condition(autocall_price.price > 0.8 * par, "autocallable should price near par");
+  assert_condition(autocall_price.price < 100.0 * 1.08, "autocallable is capped by the last coupon");
+  const auto repeat = quant::path_monte_carlo_price(model, grid, autocall, paths, 9U);
+  assert_condition(repeat.price == autocall_price.price, "script pricing should be deterministic");
+
+  // With loose local caps/floors the cliquet pays the sum of period returns,
+  // each worth e^{r dt} - 1 at maturity.
+  const auto cliquet = compile(
+    "var total = 0;\n"
+    "total = total + max(min(S / S_prev - 1, 10), -10);\n"
+    "if is_last { pay total; }\n",
+    option);
+  const auto cliquet_price = quant::path_monte_carlo_price(model, grid, cliquet, paths, 11U);
+  const double dt = option.time_to_maturity / 12.0;
+  const double expected =
+    std::exp(-option.rate * option.time_to_maturity) * 12.0 * (std::exp(option.rate * dt) - 1.0);
+  assert_near("cliquet", cliquet_price.price, expected, 4.0 * cliquet_price.standard_error);
+
+  // The else branch runs under the negated then-mask, not a re-read of the
+  // condition, so reassigning the condition variable cannot run both branches.
+  const auto reassigned = compile("var hit = 1;\nif is_last { if hit { hit = 0; pay 1; } else { pay 2; } }", option);
+  const auto reassigned_price = quant::path_monte_carlo_price(model, grid, reassigned, 1'000U, 13U);
+  assert_near("else after reassigned condition", reassigned_price.price, par / 100.0, 1e-12);
+
+  // Ternaries, else-if chains and builtin functions.
+  const auto digital = compile(
+    "if !is_last { } else if S > 110 { pay 1; } else { pay S > 90 ? 0.5 : abs(log(exp(0))); }", option);
+  const auto digital_price = quant::path_monte_carlo_price(model, grid, digital, paths, 13U);
+  assert_condition(
+    digital_price.price > 0.3 && digital_price.price < 1.0, "digital ladder should be a probability mix");
+
+  // Compile errors carry a line number and leave no program.
+  const auto unknown = quant::compile_payoff_script("pay 1;\npay missing;");
+  assert_condition(
+    !unknown.program && unknown.error.starts_with("line 2:"), "unknown variable should fail on line 2");
+  const auto builtin_write = quant::compile_payoff_script("S = 1;");
+  assert_condition(!builtin_write.program, "assigning a builtin should fail");
+  const auto nested_var = quant::compile_payoff_script("if 1 { var x = 1; }");
+  assert_condition(!nested_var.program, "var inside a block should fail");
+  const auto syntax = quant::compile_payoff_script("pay (1 + ;");
+  assert_condition(!syntax.program && !syntax.error.empty(), "syntax errors should be reported");
+
+  // Nesting is bounded instead of recursing without limit; long prefix
+  // chains are parsed iteratively and still compile.
+  const auto deep_parens = quant::compile_payoff_script("pay " + std::string(100'000, '(') + "1;");
+  assert_condition(
+    !deep_parens.program && deep_parens.error.find("nested") != std::string::npos, "deep nesting should fail");
+  std::string deep_ifs;
+  for (int i = 0; i < 10'000; ++i) {
+    deep_ifs += "if 1 { ";
+  }
+  assert_condition(!quant::compile_payoff_script(deep_ifs).program, "deeply nested ifs should fail");
+  std::string shallow_ifs;
+  for (int i = 0; i < 100; ++i) {
+    shallow_ifs += "if 1 { ";
+  }
+  shallow_ifs += "pay 1; " + std::string(100, '}');
+  assert_condition(quant::compile_payoff_script(shallow_ifs).program != nullptr, "100 nested ifs should compile");
+  const auto negations = quant::compile_payoff_script("pay " + std::string(1'000, '-') + "1;");
+  assert_condition(negations.program != nullptr, "long prefix chains should compile");
+
+  // Consumed temporaries are reused, so long expressions stay small; the
+  // register count is capped and overflow is reported on its line.
+  std::string long_sum = "pay 1";
+  for (int i = 0; i < 30'000; ++i) {
+    long_sum += "+1";
+  }
+  const auto summed = quant::compile_payoff_script(long_sum + ";");
+  assert_condition(summed.program != nullptr && summed.program->registers < 16U, "long sums should reuse temps");
+  const auto balanced = quant::compile_payoff_script("pay max((1 + 2) * (3 + 4), min(5 - 6, 7, 8 / 9), -(1));");
+  assert_condition(balanced.program != nullptr && balanced.program->registers < 24U, "nested calls should reuse temps");
+  std::string many_vars;
+  for (int i = 0; i < 2'000; ++i) {
+    many_vars += "var v" + std::to_string(i) + " = 0;\n";
+  }
+  const auto too_many = quant::compile_payoff_script(many_vars);
+  assert_condition(
+    !too_many.program && too_many.error.starts_with("line 1015:")
+      && too_many.error.find("registers") != std::string::npos,
+    "register overflow should fail on the first variable past the cap");
+
+  return EXIT_SUCCESS;
+}
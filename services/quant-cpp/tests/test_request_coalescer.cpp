@@ -0,0 +1,124 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "quant/request_coalescer.hpp"
+#include "quant/task_pool.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+using namespace std::chrono_literals;
+
+}  // namespace
+
+int main() {
+  // Two workers: one leads, one follows.
+  quant::TaskPool::configure_shared(2U);
+  quant::RequestCoalescer coalescer;
+  const quant::CacheKey key = quant::CacheKey("test.v1").add(std::uint64_t{42});
+
+  // Concurrent identical calls share one computation. The leader holds the
+  // flight open until every other caller has attached.
+  constexpr int callers = 8;
+  std::atomic<int> computations{0};
+  std::vector<std::string> results(callers);
+  {
+    std::vector<std::jthread> threads;
+    for (int i = 0; i < callers; ++i) {
+      threads.emplace_back([&, i] {
+        results[i] = coalescer.run(key, [&] {
+          computations.fetch_add(1);
+          const auto give_up = std::chrono::steady_clock::now() + 10s;
+          while (coalescer.stats().followers < callers - 1 && std::chrono::steady_clock::now() < give_up) {
+            std::this_thread::sleep_for(1ms);
+          }
+          return std::string("price");
+        });
+      });
+    }
+  }
+  assert_condition(computations.load() == 1, "identical concurrent requests should compute once");
+  for (const auto& result : results) {
+    assert_condition(result == "price", "every caller should receive the shared result");
+  }
+  auto stats = coalescer.stats();
+  assert_condition(stats.leaders == 1U && stats.followers == callers - 1U, "counters should track sharing");
+  assert_condition(stats.in_flight == 0U, "finished flights should be retired");
+
+  // Once finished, the same key computes again, and other keys never wait.
+  assert_condition(coalescer.run(key, [] { return std::string("again"); }) == "again", "flight should end");
+  const auto other = quant::CacheKey("test.v1").add(std::uint64_t{7});
+  assert_condition(coalescer.run(other, [] { return std::string("other"); }) == "other", "keys are independent");
+
+  // Failures propagate and do not wedge the key.
+  bool threw = false;
+  try {
+    coalescer.run(key, []() -> std::string { throw std::runtime_error("boom"); });
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  assert_condition(threw, "exceptions should propagate to the caller");
+  assert_condition(coalescer.run(key, [] { return std::string("ok"); }) == "ok", "key should recover");
+  stats = coalescer.stats();
+  assert_condition(stats.leaders == 5U && stats.in_flight == 0U, "each flight should count one leader");
+
+  // A follower on a pool worker keeps working while it waits: the leader's
+  // forked tasks also run on the follower's thread, which a blocked follower
+  // could never do with both workers taken.
+  {
+    auto& pool = quant::TaskPool::shared();
+    const auto shared_key = quant::CacheKey("test.v1").add(std::uint64_t{99});
+    const std::uint64_t followers_before = coalescer.stats().followers;
+    std::thread::id follower_thread;
+    std::atomic<int> forked_on_follower{0};
+    std::atomic<int> finished{0};
+    const auto call = [&](bool leader) {
+      return [&, leader] {
+        if (!leader) {
+          follower_thread = std::this_thread::get_id();
+        }
+        coalescer.run(shared_key, [&] {
+          const auto give_up = std::chrono::steady_clock::now() + 10s;
+          while (coalescer.stats().followers == followers_before && std::chrono::steady_clock::now() < give_up) {
+            std::this_thread::sleep_for(1ms);
+          }
+          quant::TaskGroup group(pool);
+          for (int i = 0; i < 16; ++i) {
+            group.run([&] {
+              std::this_thread::sleep_for(2ms);
+              if (std::this_thread::get_id() == follower_thread) {
+                forked_on_follower.fetch_add(1);
+              }
+            });
+          }
+          group.wait();
+          return std::string("shared");
+        });
+        finished.fetch_add(1);
+      };
+    };
+    pool.submit(call(true));
+    std::this_thread::sleep_for(5ms);
+    pool.submit(call(false));
+    const auto give_up = std::chrono::steady_clock::now() + 10s;
+    while (finished.load() < 2 && std::chrono::steady_clock::now() < give_up) {
+      std::this_thread::sleep_for(1ms);
+    }
+    assert_condition(finished.load() == 2, "leader and follower should both finish");
+    assert_condition(forked_on_follower.load() > 0, "a waiting follower should run forked work");
+  }
+
+  return EXIT_SUCCESS;
+}
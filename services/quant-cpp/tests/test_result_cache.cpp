@@ -0,0 +1,107 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <unistd.h>
+
+#include "quant/result_cache.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+quant::CacheKey key_for(std::uint64_t seed) {
+  quant::CacheKey key("test.v1");
+  key.add(100.0).add(0.2).add(seed).add(true);
+  return key;
+}
+
+}  // namespace
+
+int main() {
+  // Canonical encoding: signed zeros and NaN payloads collapse, field order
+  // and tags matter.
+  {
+    quant::CacheKey positive("k");
+    quant::CacheKey negative("k");
+    positive.add(0.0);
+    negative.add(-0.0);
+    assert_condition(positive.bytes() == negative.bytes(), "-0.0 and 0.0 should encode the same");
+    quant::CacheKey a("k");
+    quant::CacheKey b("k");
+    a.add(1.0).add(2.0);
+    b.add(2.0).add(1.0);
+    assert_condition(a.bytes() != b.bytes(), "field order should matter");
+    assert_condition(quant::CacheKey("a").bytes() != quant::CacheKey("b").bytes(), "tags should matter");
+  }
+
+  // Hits, misses and LRU eviction under a memory budget.
+  {
+    const std::string value(1000U, 'x');
+    quant::ResultCache cache({.memory_budget = 3U * 1200U});
+    assert_condition(!cache.find(key_for(1U)).has_value(), "empty cache should miss");
+    cache.insert(key_for(1U), value);
+    cache.insert(key_for(2U), value);
+    cache.insert(key_for(3U), value);
+    assert_condition(cache.find(key_for(1U)) == value, "cached value should be returned");
+    cache.insert(key_for(4U), value);  // evicts 2, the least recently used
+    assert_condition(!cache.find(key_for(2U)).has_value(), "least recently used entry should be evicted");
+    assert_condition(cache.find(key_for(1U)).has_value(), "recently used entry should survive");
+    cache.insert(key_for(5U), std::string(10000U, 'y'));
+    assert_condition(!cache.find(key_for(5U)).has_value(), "values over budget should not be cached");
+
+    const auto stats = cache.stats();
+    assert_condition(stats.hits == 2U && stats.misses == 3U, "hit/miss counters should track lookups");
+    assert_condition(stats.insertions == 4U && stats.evictions == 1U, "insert/evict counters should track");
+    assert_condition(stats.entries == 3U && stats.bytes <= 3U * 1200U, "cache should stay within budget");
+    assert_condition(!cache.persistent() && stats.persisted_bytes == 0U, "cache should be memory only");
+  }
+
+  // Persistence survives a restart, including after compaction.
+  {
+    char path[] = "/tmp/quant_result_cache_XXXXXX";
+    const int fd = mkstemp(path);
+    assert_condition(fd >= 0, "temporary file should be created");
+    close(fd);
+    const quant::ResultCacheConfig config{.memory_budget = 1U << 20U, .persist_path = path, .persist_bytes = 4096U};
+    {
+      quant::ResultCache cache(config);
+      assert_condition(cache.persistent(), "backing file should be mapped");
+      for (std::uint64_t seed = 0; seed < 40U; ++seed) {
+        cache.insert(key_for(seed), "price-" + std::to_string(seed));
+      }
+      assert_condition(cache.stats().persisted_bytes <= 4096U, "file should not grow past its size");
+    }
+    {
+      quant::ResultCache cache(config);
+      assert_condition(cache.find(key_for(39U)) == std::string("price-39"), "newest entry should be reloaded");
+      assert_condition(cache.stats().entries > 0U && cache.stats().insertions == 0U, "reload should not count");
+    }
+
+    // A torn tail is dropped; earlier records still load.
+    {
+      std::FILE* file = std::fopen(path, "r+b");
+      assert_condition(file != nullptr, "backing file should reopen");
+      std::fseek(file, 8, SEEK_SET);
+      std::uint64_t used = 0;
+      assert_condition(std::fread(&used, sizeof(used), 1, file) == 1U, "header should be readable");
+      std::fseek(file, static_cast<long>(used) - 1, SEEK_SET);
+      std::fputc('!', file);
+      std::fclose(file);
+    }
+    {
+      quant::ResultCache cache(config);
+      assert_condition(!cache.find(key_for(39U)).has_value(), "corrupt record should be dropped");
+      assert_condition(cache.find(key_for(38U)) == std::string("price-38"), "earlier records should load");
+    }
+    std::remove(path);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "quant/scheduler.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+using namespace std::chrono_literals;
+using quant::WorkloadClass;
+
+}  // namespace
+
+int main() {
+  // Heavy work cannot exceed its concurrency limit, and analytic work keeps
+  // flowing while heavy tasks hold their slots.
+  {
+    std::atomic<int> heavy_running{0};
+    std::atomic<int> heavy_peak{0};
+    std::atomic<bool> release{false};
+    std::atomic<int> analytic_done{0};
+    {
+      quant::TaskPool pool(4);
+      quant::WorkloadScheduler scheduler(
+        {
+          .analytic = {.concurrency = 2, .priority = 1, .latency_budget = 1000ms, .expected_service_time = 10us},
+          .heavy = {.concurrency = 2, .priority = 0, .latency_budget = 60'000ms, .expected_service_time = 1000us},
+          .max_running = 4,
+        },
+        pool);
+      for (int i = 0; i < 6; ++i) {
+        const auto admission = scheduler.submit(WorkloadClass::heavy, [&] {
+          const int now = heavy_running.fetch_add(1) + 1;
+          int seen = heavy_peak.load();
+          while (now > seen && !heavy_peak.compare_exchange_weak(seen, now)) {
+          }
+          while (!release.load()) {
+            std::this_thread::sleep_for(1ms);
+          }
+          heavy_running.fetch_sub(1);
+        });
+        assert_condition(admission.admitted, "heavy work within budget should be admitted");
+      }
+      for (int i = 0; i < 100; ++i) {
+        scheduler.submit(WorkloadClass::analytic, [&] { analytic_done.fetch_add(1); });
+      }
+      const auto give_up = std::chrono::steady_clock::now() + 10s;
+      while (analytic_done.load() < 100 && std::chrono::steady_clock::now() < give_up) {
+        std::this_thread::sleep_for(1ms);
+      }
+      assert_condition(analytic_done.load() == 100, "analytic work should not wait for heavy work");
+      const auto heavy = scheduler.stats(WorkloadClass::heavy);
+      assert_condition(heavy.running == 2U && heavy.queued == 4U, "heavy work should be held at its limit");
+      release = true;
+    }
+    assert_condition(heavy_peak.load() == 2, "heavy concurrency should reach but not exceed its limit");
+  }
+
+  // Admission control rejects work predicted to exceed the latency budget
+  // and hints when to retry.
+  {
+    std::atomic<bool> release{false};
+    quant::TaskPool pool(2);
+    quant::WorkloadScheduler scheduler(
+      {
+        .analytic = {.concurrency = 1, .priority = 1, .latency_budget = 50ms, .expected_service_time = 100us},
+        .heavy = {.concurrency = 1, .priority = 0, .latency_budget = 250ms, .expected_service_time = 100'000us},
+      },
+      pool);
+    const auto blocker = [&release] {
+      while (!release.load()) {
+        std::this_thread::sleep_for(1ms);
+      }
+    };
+    // With one slot and ~100 ms per task, a task queued behind k others
+    // waits about k * 100 ms: two may queue within the 250 ms budget.
+    assert_condition(scheduler.submit(WorkloadClass::heavy, blocker).admitted, "first task runs at once");
+    assert_condition(scheduler.submit(WorkloadClass::heavy, blocker).admitted, "100 ms wait is within budget");
+    assert_condition(scheduler.submit(WorkloadClass::heavy, blocker).admitted, "200 ms wait is within budget");
+    const auto rejected = scheduler.submit(WorkloadClass::heavy, blocker);
+    assert_condition(!rejected.admitted, "300 ms wait should exceed the budget");
+    assert_condition(rejected.retry_after >= 50ms && rejected.retry_after <= 60ms, "retry hint should cover excess");
+    assert_condition(scheduler.submit(WorkloadClass::analytic, [] {}).admitted, "classes are budgeted separately");
+    const auto stats = scheduler.stats(WorkloadClass::heavy);
+    assert_condition(stats.admitted == 3U && stats.rejected == 1U, "admission counters should track decisions");
+    release = true;
+  }
+
+  // Priority: with one running slot, queued analytic work runs before
+  // queued heavy work.
+  {
+    std::mutex order_mutex;
+    std::vector<char> order;
+    std::atomic<bool> release{false};
+    {
+      quant::TaskPool pool(2);
+      quant::WorkloadScheduler scheduler(
+        {
+          .analytic = {.concurrency = 1, .priority = 1, .latency_budget = 1000ms, .expected_service_time = 10us},
+          .heavy = {.concurrency = 1, .priority = 0, .latency_budget = 1000ms, .expected_service_time = 10us},
+          .max_running = 1,
+        },
+        pool);
+      scheduler.submit(WorkloadClass::heavy, [&release] {
+        while (!release.load()) {
+          std::this_thread::sleep_for(1ms);
+        }
+      });
+      while (scheduler.stats(WorkloadClass::heavy).running == 0U) {
+        std::this_thread::sleep_for(1ms);
+      }
+      const auto record = [&order, &order_mutex](char tag) {
+        return [&order, &order_mutex, tag] {
+          std::lock_guard<std::mutex> lock(order_mutex);
+          order.push_back(tag);
+        };
+      };
+      scheduler.submit(WorkloadClass::heavy, record('h'));
+      scheduler.submit(WorkloadClass::analytic, record('a'));
+      release = true;
+    }
+    assert_condition(order.size() == 2U && order[0] == 'a' && order[1] == 'h', "analytic work should go first");
+  }
+
+  return EXIT_SUCCESS;
+}
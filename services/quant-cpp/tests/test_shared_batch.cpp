@@ -0,0 +1,160 @@
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "quant/black_scholes.hpp"
+#include "quant/shared_batch.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+void assert_near(const char* label, double actual, double expected, double tolerance) {
+  if (std::abs(actual - expected) > tolerance) {
+    std::cerr << label << " expected " << expected << " but got " << actual << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+quant::OptionInput option_at(std::size_t i) {
+  return quant::OptionInput{
+    .spot = 90.0 + static_cast<double>(i % 21),
+    .strike = 100.0,
+    .rate = 0.02,
+    .volatility = 0.15 + 0.01 * static_cast<double>(i % 10),
+    .time_to_maturity = 0.5 + 0.1 * static_cast<double>(i % 5),
+    .dividend_yield = 0.01,
+    .is_call = i % 3 != 0,
+  };
+}
+
+std::uint64_t take(quant::SharedRing& ring, std::size_t bytes) {
+  const auto offset = ring.allocate(bytes);
+  assert_condition(offset.has_value(), "ring should have room");
+  return *offset;
+}
+
+}  // namespace
+
+int main() {
+  const std::string name = std::string(quant::kSharedRegionPrefix) + "test-" + std::to_string(getpid());
+  constexpr std::size_t kCapacity = 4U << 20U;
+  constexpr std::size_t kOptions = 10'000;
+
+  std::string error;
+  auto client = quant::SharedRegion::create(name, kCapacity, &error);
+  assert_condition(client != nullptr, "client should create the region");
+  assert_condition(
+    quant::SharedRegion::create(name, kCapacity, &error) == nullptr && !error.empty(), "names should be exclusive");
+  auto server = quant::SharedRegion::open(name, &error);
+  assert_condition(server != nullptr && server->capacity() == kCapacity, "server should map the whole region");
+
+  // The client lays out SoA inputs through the ring; the server prices them
+  // from its own mapping and the client reads the outputs in place.
+  quant::SharedRing ring(client->capacity());
+  const std::size_t doubles = kOptions * sizeof(double);
+  quant::SharedBatch batch{
+    .kind = quant::SharedBatchKind::greeks,
+    .count = kOptions,
+    .spot = take(ring, doubles),
+    .strike = take(ring, doubles),
+    .rate = take(ring, doubles),
+    .volatility = take(ring, doubles),
+    .time_to_maturity = take(ring, doubles),
+    .dividend_yield = take(ring, doubles),
+    .is_call = take(ring, kOptions),
+    .target_price = 0,
+    .price = take(ring, doubles),
+    .delta = take(ring, doubles),
+    .gamma = take(ring, doubles),
+    .vega = take(ring, doubles),
+    .theta = take(ring, doubles),
+    .rho = take(ring, doubles),
+    .implied_volatility = 0,
+    .converged = 0,
+    .iterations = 0,
+  };
+  for (std::size_t i = 0; i < kOptions; ++i) {
+    const quant::OptionInput option = option_at(i);
+    client->at<double>(batch.spot)[i] = option.spot;
+    client->at<double>(batch.strike)[i] = option.strike;
+    client->at<double>(batch.rate)[i] = option.rate;
+    client->at<double>(batch.volatility)[i] = option.volatility;
+    client->at<double>(batch.time_to_maturity)[i] = option.time_to_maturity;
+    client->at<double>(*batch.dividend_yield)[i] = option.dividend_yield;
+    // Any nonzero byte is a call.
+    client->at<unsigned char>(batch.is_call)[i] = option.is_call ? static_cast<unsigned char>(1 + i % 7) : 0U;
+  }
+  assert_condition(quant::run_shared_batch(*server, batch).empty(), "greeks batch should run");
+  for (const std::size_t i : {std::size_t{0}, std::size_t{1}, std::size_t{4321}, kOptions - 1}) {
+    const quant::OptionGreeks expected = quant::black_scholes(option_at(i));
+    assert_near("price", client->at<double>(batch.price)[i], expected.price, 1e-12);
+    assert_near("delta", client->at<double>(batch.delta)[i], expected.delta, 1e-12);
+    assert_near("gamma", client->at<double>(batch.gamma)[i], expected.gamma, 1e-12);
+    assert_near("vega", client->at<double>(batch.vega)[i], expected.vega, 1e-12);
+    assert_near("theta", client->at<double>(batch.theta)[i], expected.theta, 1e-12);
+    assert_near("rho", client->at<double>(batch.rho)[i], expected.rho, 1e-12);
+  }
+
+  // Implied vols recover the volatilities behind the prices just written.
+  {
+    quant::SharedBatch iv = batch;
+    iv.kind = quant::SharedBatchKind::implied_volatility;
+    iv.count = 500;
+    iv.target_price = batch.price;
+    iv.implied_volatility = take(ring, iv.count * sizeof(double));
+    iv.converged = take(ring, iv.count);
+    iv.iterations = take(ring, iv.count * sizeof(std::uint32_t));
+    assert_condition(quant::run_shared_batch(*server, iv).empty(), "implied-vol batch should run");
+    assert_near("implied vol", client->at<double>(iv.implied_volatility)[77], option_at(77).volatility, 1e-4);
+    assert_condition(client->at<unsigned char>(iv.converged)[77] == 1U, "implied vol should converge");
+  }
+
+  // Columns that leave the region or break alignment are refused.
+  {
+    quant::SharedBatch bad = batch;
+    bad.spot = kCapacity - 8U;
+    assert_condition(!quant::run_shared_batch(*server, bad).empty(), "out-of-bounds input should be refused");
+    bad = batch;
+    bad.delta = batch.delta + 4U;
+    assert_condition(!quant::run_shared_batch(*server, bad).empty(), "misaligned output should be refused");
+    bad = batch;
+    bad.count = UINT64_MAX / 4U;
+    assert_condition(!quant::run_shared_batch(*server, bad).empty(), "overflowing count should be refused");
+  }
+
+  // The ring hands out space first-in first-out and wraps once the oldest
+  // allocations are released.
+  {
+    quant::SharedRing small(1024);
+    const auto a = small.allocate(400);
+    const auto b = small.allocate(400);
+    assert_condition(a == 0U && b == 448U, "allocations should be 64-byte aligned and contiguous");
+    assert_condition(!small.allocate(400).has_value(), "a full ring should refuse");
+    small.release();
+    const auto c = small.allocate(300);
+    assert_condition(c == 0U, "the ring should wrap into released space");
+    assert_condition(!small.allocate(200).has_value(), "wrapped space ends at the oldest allocation");
+    small.release();
+    small.release();
+    assert_condition(small.in_use() == 0U && small.allocate(1024) == 0U, "an empty ring should start over");
+  }
+
+  // Only prefixed names are accepted, and the object goes away with its
+  // creator.
+  assert_condition(quant::SharedRegion::open("/etc-passwd", &error) == nullptr, "unprefixed names should be refused");
+  server.reset();
+  client.reset();
+  assert_condition(quant::SharedRegion::open(name, &error) == nullptr, "creator should unlink the region");
+
+  return EXIT_SUCCESS;
+}
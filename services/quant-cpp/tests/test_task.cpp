@@ -0,0 +1,101 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "quant/task.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+using namespace std::chrono_literals;
+using quant::Task;
+
+Task<int> square(int x) {
+  co_return x * x;
+}
+
+Task<int> sum_of_squares(int n) {
+  int total = 0;
+  for (int i = 1; i <= n; ++i) {
+    total += co_await square(i);
+  }
+  co_return total;
+}
+
+Task<int> fails() {
+  throw std::runtime_error("stage failed");
+  co_return 0;
+}
+
+Task<bool> catches() {
+  try {
+    co_await fails();
+  } catch (const std::runtime_error&) {
+    co_return true;
+  }
+  co_return false;
+}
+
+Task<void> wait_for_slot(quant::WorkloadScheduler& scheduler, std::atomic<bool>* release, quant::Admission* out) {
+  *out = co_await quant::scheduled(scheduler, quant::WorkloadClass::heavy);
+  if (out->admitted) {
+    while (!release->load()) {
+      std::this_thread::sleep_for(1ms);
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  // Awaiting nested tasks returns their values in order.
+  assert_condition(quant::sync_wait(sum_of_squares(10)) == 385, "nested tasks should compose");
+
+  // Exceptions reach the awaiting coroutine, and sync_wait rethrows them.
+  assert_condition(quant::sync_wait(catches()), "awaiter should catch a stage's exception");
+  {
+    bool caught = false;
+    try {
+      quant::sync_wait(fails());
+    } catch (const std::runtime_error&) {
+      caught = true;
+    }
+    assert_condition(caught, "sync_wait should rethrow");
+  }
+
+  // scheduled() resumes admitted coroutines in a slot and reports
+  // rejections without suspending.
+  {
+    quant::TaskPool pool(2);
+    std::atomic<bool> release{false};
+    quant::Admission first{};
+    quant::Admission second{};
+    {
+      quant::WorkloadScheduler scheduler(
+        {
+          .analytic = {.concurrency = 1, .priority = 1, .latency_budget = 50ms, .expected_service_time = 10us},
+          .heavy = {.concurrency = 1, .priority = 0, .latency_budget = 50ms, .expected_service_time = 100'000us},
+        },
+        pool);
+      quant::spawn(wait_for_slot(scheduler, &release, &first));
+      while (scheduler.stats(quant::WorkloadClass::heavy).running == 0U) {
+        std::this_thread::sleep_for(1ms);
+      }
+      quant::sync_wait(wait_for_slot(scheduler, &release, &second));
+      release = true;
+    }
+    assert_condition(first.admitted, "first coroutine should get the slot");
+    assert_condition(!second.admitted && second.retry_after.count() > 0, "second should be rejected with a hint");
+  }
+
+  return EXIT_SUCCESS;
+}
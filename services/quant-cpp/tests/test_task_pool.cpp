@@ -0,0 +1,140 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "quant/parallel.hpp"
+#include "quant/task_pool.hpp"
+
+namespace {
+
+void assert_condition(bool condition, const char* message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+using namespace std::chrono_literals;
+
+// Counts tasks running at once and remembers the highest count seen.
+struct Occupancy {
+  std::atomic<int> running{0};
+  std::atomic<int> peak{0};
+
+  void enter() {
+    const int now = running.fetch_add(1) + 1;
+    int seen = peak.load();
+    while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+    }
+  }
+  void leave() { running.fetch_sub(1); }
+};
+
+}  // namespace
+
+int main() {
+  // parallel_for runs every index exactly once.
+  {
+    std::vector<std::atomic<int>> hits(1000);
+    quant::parallel_for(hits.size(), [&hits](std::size_t i) { hits[i].fetch_add(1); });
+    bool once = true;
+    for (const auto& hit : hits) {
+      once = once && hit.load() == 1;
+    }
+    assert_condition(once, "every index should run exactly once");
+  }
+
+  // Nested fork-join completes on a pool smaller than the nesting depth and
+  // never runs more tasks at once than the pool has workers.
+  {
+    quant::TaskPool pool(2);
+    Occupancy occupancy;
+    std::atomic<int> leaves{0};
+    quant::TaskGroup outer(pool);
+    for (int i = 0; i < 8; ++i) {
+      outer.run([&] {
+        quant::TaskGroup inner(pool);
+        for (int j = 0; j < 8; ++j) {
+          inner.run([&] {
+            occupancy.enter();
+            std::this_thread::sleep_for(100us);
+            leaves.fetch_add(1);
+            occupancy.leave();
+          });
+        }
+        inner.wait();
+      });
+    }
+    outer.wait();
+    assert_condition(leaves.load() == 64, "nested groups should run every task");
+    assert_condition(occupancy.peak.load() <= 2, "tasks should never outnumber the workers");
+  }
+
+  // Many outside callers fanning out at once still compute on the pool's
+  // workers only.
+  {
+    quant::TaskPool pool(3);
+    Occupancy occupancy;
+    std::vector<std::thread> callers;
+    for (int c = 0; c < 6; ++c) {
+      callers.emplace_back([&] {
+        quant::TaskGroup group(pool);
+        for (int i = 0; i < 16; ++i) {
+          group.run([&occupancy] {
+            occupancy.enter();
+            std::this_thread::sleep_for(50us);
+            occupancy.leave();
+          });
+        }
+        group.wait();
+      });
+    }
+    for (auto& caller : callers) {
+      caller.join();
+    }
+    assert_condition(occupancy.peak.load() <= 3, "outside callers should not add compute threads");
+  }
+
+  // The first exception reaches the joining caller and later indices are
+  // skipped.
+  {
+    std::atomic<int> ran{0};
+    bool caught = false;
+    try {
+      quant::parallel_for(10'000, [&ran](std::size_t i) {
+        ran.fetch_add(1);
+        if (i == 0U) {
+          throw std::runtime_error("boom");
+        }
+      });
+    } catch (const std::runtime_error&) {
+      caught = true;
+    }
+    assert_condition(caught, "exception should propagate to the caller");
+    assert_condition(ran.load() > 0, "some indices should run before the failure");
+  }
+
+  // Submitted tasks run, and the destructor finishes them before joining.
+  {
+    std::atomic<int> done{0};
+    {
+      quant::TaskPool pool(2);
+      for (int i = 0; i < 100; ++i) {
+        pool.submit([&done] { done.fetch_add(1); });
+      }
+    }
+    assert_condition(done.load() == 100, "every submitted task should run");
+  }
+
+  // The shared pool's size can only be set before it starts.
+  {
+    assert_condition(quant::TaskPool::shared().size() >= 1U, "shared pool should have a worker");
+    assert_condition(!quant::TaskPool::configure_shared(4), "shared pool size is fixed once running");
+  }
+
+  return EXIT_SUCCESS;
+}